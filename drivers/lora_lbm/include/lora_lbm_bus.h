@@ -0,0 +1,121 @@
+/*
+ * Copyright (c) 2024 Semtech Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef LORA_LBM_BUS_H
+#define LORA_LBM_BUS_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <zephyr/device.h>
+#include <zephyr/drivers/spi.h>
+#include <zephyr/kernel.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Radio transactions on a shared SPI bus
+ *
+ * A radio transaction keeps the SPI bus locked to the transceiver across several commands, so
+ * the other devices of the bus cannot slip a transfer in the middle of a sequence such as
+ * SetPacketParams ... SetTx. The first transfer of the transaction takes the bus lock with
+ * SPI_LOCK_ON, and spi_release() gives it back at the end of the transaction.
+ *
+ * While waiting for the bus, the thread runs at least at
+ * CONFIG_LORA_BASICS_MODEM_DRIVERS_BUS_LOCK_PRIORITY, so the radio goes first among the
+ * waiting bus users. The time of the transfers that had to get the bus is counted in the
+ * bus_acquire statistics.
+ *
+ * Transactions are meant to be used from the thread driving the modem.
+ *
+ * A HAL sequence is also closed when one of its transfers fails, and after
+ * CONFIG_LORA_BASICS_MODEM_DRIVERS_BUS_LOCK_TIMEOUT_MS if its end command never comes.
+ */
+
+/**
+ * @brief Bus state, embedded in the transceiver driver data
+ *
+ */
+struct lora_lbm_bus {
+	const struct spi_dt_spec *spi; /* SPI bus and configuration of the transceiver */
+	struct spi_config locked_cfg;  /* Same configuration with SPI_LOCK_ON */
+	uint8_t depth;                 /* Nesting level of the ongoing transaction */
+	bool locked;                   /* The bus is held with locked_cfg */
+	bool hal_sequence;             /* Transaction opened by the HAL, see lora_lbm_bus_sequence */
+	struct k_mutex mutex;          /* Serializes the radio thread with the sequence timeout */
+	struct k_work_delayable sequence_timeout; /* Closes a HAL sequence left open */
+};
+
+/**
+ * @brief Initialize the bus state of a transceiver
+ *
+ * @param bus bus state
+ * @param spi SPI bus and configuration of the transceiver
+ */
+void lora_lbm_bus_init(struct lora_lbm_bus *bus, const struct spi_dt_spec *spi);
+
+/**
+ * @brief SPI transfer with the transceiver, holding the bus during a transaction
+ *
+ * @param bus bus state
+ * @param tx buffers to send, or NULL
+ * @param rx buffers to receive, or NULL
+ * @return spi_transceive() result
+ */
+int lora_lbm_bus_transceive(struct lora_lbm_bus *bus, const struct spi_buf_set *tx,
+			    const struct spi_buf_set *rx);
+
+/**
+ * @brief Start a transaction, or nest in the ongoing one
+ *
+ * @param bus bus state
+ */
+void lora_lbm_bus_begin(struct lora_lbm_bus *bus);
+
+/**
+ * @brief End a transaction, the bus is released when the outermost one ends
+ *
+ * @param bus bus state
+ * @retval -EALREADY if no transaction is ongoing
+ * @return spi_release() result otherwise
+ */
+int lora_lbm_bus_end(struct lora_lbm_bus *bus);
+
+/**
+ * @brief Commands sequences the HAL keeps in a transaction
+ *
+ * The HAL opens a transaction when the packet parameters are set, and closes it after the
+ * command starting the radio operation (TX, RX, CAD...) or a standby or sleep.
+ *
+ * @param bus bus state
+ * @param start true on the first command of the sequence, false on the last one
+ */
+void lora_lbm_bus_sequence(struct lora_lbm_bus *bus, bool start);
+
+/**
+ * @brief Keep the SPI bus locked to the transceiver until lora_transceiver_transaction_end().
+ * Implemented by each transceiver driver.
+ *
+ * @param dev context
+ */
+void lora_transceiver_transaction_begin(const struct device *dev);
+
+/**
+ * @brief End a transaction started with lora_transceiver_transaction_begin().
+ * Implemented by each transceiver driver.
+ *
+ * @param dev context
+ * @retval 0 on success
+ * @retval -EALREADY if no transaction is ongoing
+ */
+int lora_transceiver_transaction_end(const struct device *dev);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // LORA_LBM_BUS_H
@@ -0,0 +1,101 @@
+/*
+ * Copyright (c) 2024 Semtech Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef LORA_LBM_ENERGY_H
+#define LORA_LBM_ENERGY_H
+
+#include <stdint.h>
+#include <zephyr/device.h>
+#include <zephyr/spinlock.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Transceiver activities the charge is accounted to
+ *
+ */
+enum lora_lbm_energy_category {
+	LORA_LBM_ENERGY_SLEEP,
+	LORA_LBM_ENERGY_STANDBY,     /* Standby and frequency synthesis */
+	LORA_LBM_ENERGY_LORAWAN_TX,  /* Any transmission, including test modes */
+	LORA_LBM_ENERGY_RX_WINDOWS,  /* LoRa and GFSK receptions */
+	LORA_LBM_ENERGY_CAD_LBT,     /* Channel activity detection and LBT RSSI sensing */
+	LORA_LBM_ENERGY_WIFI,        /* Wi-Fi scans */
+	LORA_LBM_ENERGY_GNSS,        /* GNSS scans */
+	LORA_LBM_ENERGY_CATEGORY_COUNT,
+};
+
+/**
+ * @brief Energy totals of a transceiver since boot or last reset
+ *
+ */
+struct lora_lbm_energy_stats {
+	uint64_t charge_ua_ms[LORA_LBM_ENERGY_CATEGORY_COUNT]; /* Integrated charge in uA.ms */
+	uint64_t time_ms[LORA_LBM_ENERGY_CATEGORY_COUNT];      /* Time spent in ms */
+};
+
+/**
+ * @brief Energy accumulator, embedded in the transceiver driver data
+ *
+ */
+struct lora_lbm_energy {
+	struct k_spinlock lock;
+	int64_t state_start;    /* Uptime in ticks when the current state was entered */
+	uint32_t current_ua;    /* Estimated current of the current state */
+	uint8_t category;       /* enum lora_lbm_energy_category of the current state */
+	uint32_t tx_current_ua; /* Estimated current of the last TX configuration */
+	uint64_t charge_ua_ticks[LORA_LBM_ENERGY_CATEGORY_COUNT];
+	uint64_t time_ticks[LORA_LBM_ENERGY_CATEGORY_COUNT];
+};
+
+/**
+ * @brief Initialize an accumulator, in standby state
+ *
+ * @param energy accumulator
+ * @param standby_ua estimated standby current
+ */
+void lora_lbm_energy_init(struct lora_lbm_energy *energy, uint32_t standby_ua);
+
+/**
+ * @brief Account the elapsed time to the current state and enter a new one.
+ * Can be called from ISR.
+ *
+ * @param energy accumulator
+ * @param category activity of the new state
+ * @param current_ua estimated current of the new state
+ */
+void lora_lbm_energy_enter(struct lora_lbm_energy *energy, enum lora_lbm_energy_category category,
+			   uint32_t current_ua);
+
+/**
+ * @brief Get the accumulator of a transceiver. Implemented by each transceiver driver.
+ *
+ * @param dev context
+ */
+struct lora_lbm_energy *lora_transceiver_get_energy(const struct device *dev);
+
+/**
+ * @brief Get the energy totals of a transceiver, including the ongoing state
+ *
+ * @param dev context
+ * @param stats totals per category
+ */
+void lora_lbm_energy_get_stats(const struct device *dev, struct lora_lbm_energy_stats *stats);
+
+/**
+ * @brief Clear the energy totals of a transceiver
+ *
+ * @param dev context
+ */
+void lora_lbm_energy_reset(const struct device *dev);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // LORA_LBM_ENERGY_H
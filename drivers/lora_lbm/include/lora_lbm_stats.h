@@ -0,0 +1,155 @@
+/*
+ * Copyright (c) 2024 Semtech Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef LORA_LBM_STATS_H
+#define LORA_LBM_STATS_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <zephyr/sys/util_macro.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Radio statistics of the LoRa Basics Modem HAL and transceiver drivers
+ *
+ * The counters are kept in the "lora_lbm" Zephyr stats group, readable with stats_group_find()
+ * and stats_walk(), or through the mcumgr statistics group. All counters are 32 bits and wrap.
+ * With CONFIG_LORA_BASICS_MODEM_DRIVERS_STATS=n, the hooks compile to nothing.
+ */
+
+/* Name of the stats group */
+#define LORA_LBM_STATS_GROUP "lora_lbm"
+
+/* Transceiver IRQ flags, translated from the chip specific IRQ status by the drivers */
+#define LORA_LBM_STATS_IRQ_TX_DONE      BIT(0)
+#define LORA_LBM_STATS_IRQ_RX_DONE      BIT(1)
+#define LORA_LBM_STATS_IRQ_TIMEOUT      BIT(2)
+#define LORA_LBM_STATS_IRQ_CRC_ERROR    BIT(3)
+#define LORA_LBM_STATS_IRQ_HEADER_ERROR BIT(4)
+#define LORA_LBM_STATS_IRQ_CAD_DONE     BIT(5)
+#define LORA_LBM_STATS_IRQ_CAD_DETECTED BIT(6)
+#define LORA_LBM_STATS_IRQ_OTHER        BIT(7)
+
+#ifdef CONFIG_LORA_BASICS_MODEM_DRIVERS_STATS
+
+/**
+ * @brief Count an assertion of the transceiver event line. Can be called from ISR.
+ */
+void lora_lbm_stats_on_event(void);
+
+/**
+ * @brief Count a radio event recovered from the event line level, its edge was missed
+ */
+void lora_lbm_stats_on_irq_missed(void);
+
+/**
+ * @brief Count the IRQ flags read from the transceiver.
+ *
+ * Only the flags raised since the previous read are counted, so polling the
+ * status before clearing it does not count an IRQ twice.
+ *
+ * @param irqs LORA_LBM_STATS_IRQ_* flags currently set
+ */
+void lora_lbm_stats_on_irq_status(uint32_t irqs);
+
+/**
+ * @brief Forget IRQ flags cleared on the transceiver, the next read counts them again
+ *
+ * @param irqs LORA_LBM_STATS_IRQ_* flags cleared
+ */
+void lora_lbm_stats_on_irq_clear(uint32_t irqs);
+
+/**
+ * @brief Start timing a transmission, ended by the next TX done or timeout IRQ
+ */
+void lora_lbm_stats_on_tx_start(void);
+
+/**
+ * @brief Count a SPI transaction with the transceiver
+ *
+ * @param write true when only sending to the chip
+ * @param bytes number of command and data bytes
+ * @param ok false when the transaction failed
+ */
+void lora_lbm_stats_on_spi(bool write, uint32_t bytes, bool ok);
+
+/**
+ * @brief Account a wait on the transceiver BUSY line
+ *
+ * @param us time spent waiting
+ */
+void lora_lbm_stats_on_busy_wait(uint32_t us);
+
+/**
+ * @brief Account a transfer that had to get the SPI bus, see lora_lbm_bus.h
+ *
+ * @param us time spent waiting for the bus and transferring
+ */
+void lora_lbm_stats_on_bus_acquire(uint32_t us);
+
+/**
+ * @brief Count a context store of the modem
+ *
+ * @param bytes size of the context written
+ */
+void lora_lbm_stats_on_context_store(uint32_t bytes);
+
+#else /* CONFIG_LORA_BASICS_MODEM_DRIVERS_STATS */
+
+static inline void lora_lbm_stats_on_event(void)
+{
+}
+
+static inline void lora_lbm_stats_on_irq_missed(void)
+{
+}
+
+static inline void lora_lbm_stats_on_irq_status(uint32_t irqs)
+{
+	ARG_UNUSED(irqs);
+}
+
+static inline void lora_lbm_stats_on_irq_clear(uint32_t irqs)
+{
+	ARG_UNUSED(irqs);
+}
+
+static inline void lora_lbm_stats_on_tx_start(void)
+{
+}
+
+static inline void lora_lbm_stats_on_spi(bool write, uint32_t bytes, bool ok)
+{
+	ARG_UNUSED(write);
+	ARG_UNUSED(bytes);
+	ARG_UNUSED(ok);
+}
+
+static inline void lora_lbm_stats_on_busy_wait(uint32_t us)
+{
+	ARG_UNUSED(us);
+}
+
+static inline void lora_lbm_stats_on_bus_acquire(uint32_t us)
+{
+	ARG_UNUSED(us);
+}
+
+static inline void lora_lbm_stats_on_context_store(uint32_t bytes)
+{
+	ARG_UNUSED(bytes);
+}
+
+#endif /* CONFIG_LORA_BASICS_MODEM_DRIVERS_STATS */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // LORA_LBM_STATS_H
@@ -0,0 +1,57 @@
+/*
+ * Copyright (c) 2024 Semtech Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef LORA_LBM_TRACING_H
+#define LORA_LBM_TRACING_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Tracing hooks of the LoRa Basics Modem HAL and transceiver drivers
+ *
+ * Each hook emits a Zephyr named event, recorded by the CTF and SystemView backends.
+ * The name identifies the hook point, the first argument its phase and the second one a
+ * hook specific value (opcode, duration, context type...).
+ * With CONFIG_LORA_BASICS_MODEM_TRACING=n, the hooks compile to nothing.
+ */
+
+/* Phase of a hook point, first argument of the named event */
+#define LORA_LBM_TRACE_PHASE_BEGIN 0
+#define LORA_LBM_TRACE_PHASE_END   1
+#define LORA_LBM_TRACE_PHASE_EVENT 2
+
+#ifdef CONFIG_LORA_BASICS_MODEM_TRACING
+
+#include <zephyr/tracing/tracing.h>
+
+/* Names are kept to 19 characters, CTF truncates them with its 20 byte buffer */
+#define LORA_LBM_TRACE(name, phase, arg)                                                           \
+	sys_trace_named_event("lbm_" #name, (phase), (uint32_t)(arg))
+
+#else /* CONFIG_LORA_BASICS_MODEM_TRACING */
+
+#define LORA_LBM_TRACE(name, phase, arg) ((void)0)
+
+#endif /* CONFIG_LORA_BASICS_MODEM_TRACING */
+
+/* Start of a traced section */
+#define LORA_LBM_TRACE_BEGIN(name, arg) LORA_LBM_TRACE(name, LORA_LBM_TRACE_PHASE_BEGIN, arg)
+
+/* End of a traced section */
+#define LORA_LBM_TRACE_END(name, arg) LORA_LBM_TRACE(name, LORA_LBM_TRACE_PHASE_END, arg)
+
+/* Instant event */
+#define LORA_LBM_TRACE_EVENT(name, arg) LORA_LBM_TRACE(name, LORA_LBM_TRACE_PHASE_EVENT, arg)
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // LORA_LBM_TRACING_H
@@ -7,6 +7,7 @@
 #ifndef LORA_LBM_TRANSCEIVER_H
 #define LORA_LBM_TRANSCEIVER_H
 
+#include <stdbool.h>
 #include <zephyr/device.h>
 
 #ifdef __cplusplus
@@ -41,6 +42,35 @@ void lora_transceiver_board_enable_interrupt(const struct device *dev);
  */
 void lora_transceiver_board_disable_interrupt(const struct device *dev);
 
+/**
+ * @brief Check whether the event line is active with no event given to the callback yet
+ *
+ * Sampled by the modem HAL to catch a missed edge. The callback may still be processing
+ * an event delivered just before the call, which the caller has to tell apart.
+ *
+ * @param dev context
+ * @return true when the line is active and no event is queued or being dispatched
+ */
+bool lora_transceiver_board_is_event_pending(const struct device *dev);
+
+#ifdef CONFIG_SEMTECH_SX126X_IRQ_FETCH
+/**
+ * @brief Read and clear the IRQ status in one bus-locked sequence, into the driver cache
+ *
+ * The following GetIrqStatus and ClearIrqStatus commands of the RAL are then served from
+ * the cache, with no SPI transfer nor BUSY wait. IRQs raised after the fetch assert the
+ * event line again. Must be called from the thread driving the radio abstraction layer.
+ *
+ * @param dev context
+ */
+void lora_transceiver_fetch_irq_status(const struct device *dev);
+#else
+static inline void lora_transceiver_fetch_irq_status(const struct device *dev)
+{
+	ARG_UNUSED(dev);
+}
+#endif /* CONFIG_SEMTECH_SX126X_IRQ_FETCH */
+
 /**
  * @brief Helper to get the tcxo startup delay for any model of transceiver
  *
@@ -48,6 +78,80 @@ void lora_transceiver_board_disable_interrupt(const struct device *dev);
  */
 uint32_t lora_transceiver_get_tcxo_startup_delay_ms(const struct device *dev);
 
+/**
+ * @brief Path of the antenna switch driven by the board GPIOs
+ */
+enum lora_transceiver_rf_switch {
+	LORA_TRANSCEIVER_RF_SWITCH_OFF,
+	LORA_TRANSCEIVER_RF_SWITCH_RX,
+	LORA_TRANSCEIVER_RF_SWITCH_TX,
+};
+
+#ifdef CONFIG_SEMTECH_SX126X
+/**
+ * @brief Power the TCXO supplied by a board GPIO
+ *
+ * Returns right away: the TCXO starts while the radio is configured, the driver waits for the
+ * end of its startup delay before the first command running on it. Does nothing without
+ * tcxo-power-gpios.
+ *
+ * @param dev context
+ * @param on true to power the TCXO
+ */
+void lora_transceiver_board_set_tcxo(const struct device *dev, bool on);
+
+/**
+ * @brief Drive the antenna switch GPIOs of the board
+ *
+ * @param dev context
+ * @param path path to select, LORA_TRANSCEIVER_RF_SWITCH_OFF powers the switch down
+ */
+void lora_transceiver_board_set_rf_switch(const struct device *dev,
+					  enum lora_transceiver_rf_switch path);
+#else
+/* Only the SX126x devicetree binding describes TCXO and antenna switch GPIOs */
+static inline void lora_transceiver_board_set_tcxo(const struct device *dev, bool on)
+{
+	ARG_UNUSED(dev);
+	ARG_UNUSED(on);
+}
+
+static inline void lora_transceiver_board_set_rf_switch(const struct device *dev,
+							enum lora_transceiver_rf_switch path)
+{
+	ARG_UNUSED(dev);
+	ARG_UNUSED(path);
+}
+#endif /* CONFIG_SEMTECH_SX126X */
+
+/**
+ * @brief Wake the transceiver up ahead of a radio operation
+ *
+ * Leaves the sleep mode and starts the TCXO controlled by the transceiver, so the next
+ * configuration does not wait for them. Does nothing when the transceiver is awake.
+ * Must be called from the thread driving the radio abstraction layer.
+ *
+ * @param dev context
+ * @return 0 on success, negative error code otherwise
+ */
+int lora_transceiver_prewake(const struct device *dev);
+
+/**
+ * @brief Context to give to the LBM radio abstraction layer, see smtc_modem_set_radio_context
+ *
+ * This is the device itself, except for SX127x whose driver keeps its state in a sx127x_t.
+ *
+ * @param dev context
+ */
+#ifdef CONFIG_SEMTECH_SX127X
+const void *lora_transceiver_get_ral_context(const struct device *dev);
+#else
+static inline const void *lora_transceiver_get_ral_context(const struct device *dev)
+{
+	return dev;
+}
+#endif /* CONFIG_SEMTECH_SX127X */
+
 /**
  * @brief Returns lr11xx_system_version_type_t or -1
  *
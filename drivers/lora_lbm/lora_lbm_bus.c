@@ -0,0 +1,133 @@
+/*
+ * Copyright (c) 2024 Semtech Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr/kernel.h>
+
+#include "lora_lbm_bus.h"
+#include "lora_lbm_stats.h"
+
+/**
+ * @brief Close the HAL sequence, the bus is released unless a transaction is still ongoing
+ *
+ * @param bus bus state, with its mutex held
+ */
+static void lora_lbm_bus_sequence_close(struct lora_lbm_bus *bus)
+{
+	if (!bus->hal_sequence) {
+		return;
+	}
+	bus->hal_sequence = false;
+	(void)k_work_cancel_delayable(&bus->sequence_timeout);
+	lora_lbm_bus_end(bus);
+}
+
+/**
+ * @brief The HAL sequence did not reach its end command, e.g. the operation was aborted
+ *
+ * @param work
+ */
+static void lora_lbm_bus_sequence_timeout(struct k_work *work)
+{
+	struct k_work_delayable *dwork = k_work_delayable_from_work(work);
+	struct lora_lbm_bus *bus = CONTAINER_OF(dwork, struct lora_lbm_bus, sequence_timeout);
+
+	k_mutex_lock(&bus->mutex, K_FOREVER);
+	lora_lbm_bus_sequence_close(bus);
+	k_mutex_unlock(&bus->mutex);
+}
+
+void lora_lbm_bus_init(struct lora_lbm_bus *bus, const struct spi_dt_spec *spi)
+{
+	bus->spi = spi;
+	bus->locked_cfg = spi->config;
+	bus->locked_cfg.operation |= SPI_LOCK_ON;
+	bus->depth = 0;
+	bus->locked = false;
+	bus->hal_sequence = false;
+	k_mutex_init(&bus->mutex);
+	k_work_init_delayable(&bus->sequence_timeout, lora_lbm_bus_sequence_timeout);
+}
+
+int lora_lbm_bus_transceive(struct lora_lbm_bus *bus, const struct spi_buf_set *tx,
+			    const struct spi_buf_set *rx)
+{
+	k_tid_t self = k_current_get();
+	const struct spi_config *cfg;
+	int64_t start;
+	int prio;
+	int ret;
+
+	k_mutex_lock(&bus->mutex, K_FOREVER);
+	cfg = (bus->depth > 0) ? &bus->locked_cfg : &bus->spi->config;
+	if (bus->locked) {
+		ret = spi_transceive(bus->spi->bus, cfg, tx, rx);
+		// On error, the SPI driver already released the lock
+		if (ret < 0) {
+			bus->locked = false;
+			lora_lbm_bus_sequence_close(bus);
+		}
+		k_mutex_unlock(&bus->mutex);
+		return ret;
+	}
+
+	prio = k_thread_priority_get(self);
+	// Another device may hold the bus, wait for it at the radio priority
+	if (prio > CONFIG_LORA_BASICS_MODEM_DRIVERS_BUS_LOCK_PRIORITY) {
+		k_thread_priority_set(self, CONFIG_LORA_BASICS_MODEM_DRIVERS_BUS_LOCK_PRIORITY);
+	}
+	start = k_uptime_ticks();
+	ret = spi_transceive(bus->spi->bus, cfg, tx, rx);
+	lora_lbm_stats_on_bus_acquire(k_ticks_to_us_floor32(k_uptime_ticks() - start));
+	if (prio > CONFIG_LORA_BASICS_MODEM_DRIVERS_BUS_LOCK_PRIORITY) {
+		k_thread_priority_set(self, prio);
+	}
+
+	// On error, the SPI driver already released the lock
+	if (ret >= 0 && bus->depth > 0) {
+		bus->locked = true;
+	} else if (ret < 0) {
+		lora_lbm_bus_sequence_close(bus);
+	}
+	k_mutex_unlock(&bus->mutex);
+	return ret;
+}
+
+void lora_lbm_bus_begin(struct lora_lbm_bus *bus)
+{
+	k_mutex_lock(&bus->mutex, K_FOREVER);
+	__ASSERT(bus->depth < UINT8_MAX, "Too many nested radio transactions");
+	bus->depth++;
+	k_mutex_unlock(&bus->mutex);
+}
+
+int lora_lbm_bus_end(struct lora_lbm_bus *bus)
+{
+	int ret = 0;
+
+	k_mutex_lock(&bus->mutex, K_FOREVER);
+	if (bus->depth == 0) {
+		ret = -EALREADY;
+	} else if (--bus->depth == 0 && bus->locked) {
+		bus->locked = false;
+		ret = spi_release(bus->spi->bus, &bus->locked_cfg);
+	}
+	k_mutex_unlock(&bus->mutex);
+	return ret;
+}
+
+void lora_lbm_bus_sequence(struct lora_lbm_bus *bus, bool start)
+{
+	k_mutex_lock(&bus->mutex, K_FOREVER);
+	if (start && !bus->hal_sequence) {
+		bus->hal_sequence = true;
+		lora_lbm_bus_begin(bus);
+		k_work_schedule(&bus->sequence_timeout,
+				K_MSEC(CONFIG_LORA_BASICS_MODEM_DRIVERS_BUS_LOCK_TIMEOUT_MS));
+	} else if (!start) {
+		lora_lbm_bus_sequence_close(bus);
+	}
+	k_mutex_unlock(&bus->mutex);
+}
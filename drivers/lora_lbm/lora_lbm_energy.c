@@ -0,0 +1,81 @@
+/*
+ * Copyright (c) 2024 Semtech Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <string.h>
+#include <zephyr/kernel.h>
+
+#include "lora_lbm_energy.h"
+
+/* Close the current state up to now, lock must be held */
+static void lora_lbm_energy_accumulate(struct lora_lbm_energy *energy)
+{
+	int64_t now = k_uptime_ticks();
+	uint64_t elapsed = now - energy->state_start;
+
+	energy->time_ticks[energy->category] += elapsed;
+	energy->charge_ua_ticks[energy->category] += elapsed * energy->current_ua;
+	energy->state_start = now;
+}
+
+/* Convert without overflowing on large uA.ticks values */
+static uint64_t lora_lbm_energy_ticks_to_ms(uint64_t ticks)
+{
+	const uint64_t ticks_per_sec = CONFIG_SYS_CLOCK_TICKS_PER_SEC;
+
+	return (ticks / ticks_per_sec) * MSEC_PER_SEC +
+	       ((ticks % ticks_per_sec) * MSEC_PER_SEC) / ticks_per_sec;
+}
+
+void lora_lbm_energy_init(struct lora_lbm_energy *energy, uint32_t standby_ua)
+{
+	memset(energy, 0, sizeof(*energy));
+	energy->category = LORA_LBM_ENERGY_STANDBY;
+	energy->current_ua = standby_ua;
+	energy->state_start = k_uptime_ticks();
+}
+
+void lora_lbm_energy_enter(struct lora_lbm_energy *energy, enum lora_lbm_energy_category category,
+			   uint32_t current_ua)
+{
+	k_spinlock_key_t key = k_spin_lock(&energy->lock);
+
+	lora_lbm_energy_accumulate(energy);
+	energy->category = category;
+	energy->current_ua = current_ua;
+
+	k_spin_unlock(&energy->lock, key);
+}
+
+void lora_lbm_energy_get_stats(const struct device *dev, struct lora_lbm_energy_stats *stats)
+{
+	struct lora_lbm_energy *energy = lora_transceiver_get_energy(dev);
+	uint64_t charge_ua_ticks[LORA_LBM_ENERGY_CATEGORY_COUNT];
+	uint64_t time_ticks[LORA_LBM_ENERGY_CATEGORY_COUNT];
+	k_spinlock_key_t key = k_spin_lock(&energy->lock);
+
+	lora_lbm_energy_accumulate(energy);
+	memcpy(charge_ua_ticks, energy->charge_ua_ticks, sizeof(charge_ua_ticks));
+	memcpy(time_ticks, energy->time_ticks, sizeof(time_ticks));
+
+	k_spin_unlock(&energy->lock, key);
+
+	for (int i = 0; i < LORA_LBM_ENERGY_CATEGORY_COUNT; i++) {
+		stats->charge_ua_ms[i] = lora_lbm_energy_ticks_to_ms(charge_ua_ticks[i]);
+		stats->time_ms[i] = lora_lbm_energy_ticks_to_ms(time_ticks[i]);
+	}
+}
+
+void lora_lbm_energy_reset(const struct device *dev)
+{
+	struct lora_lbm_energy *energy = lora_transceiver_get_energy(dev);
+	k_spinlock_key_t key = k_spin_lock(&energy->lock);
+
+	memset(energy->charge_ua_ticks, 0, sizeof(energy->charge_ua_ticks));
+	memset(energy->time_ticks, 0, sizeof(energy->time_ticks));
+	energy->state_start = k_uptime_ticks();
+
+	k_spin_unlock(&energy->lock, key);
+}
@@ -0,0 +1,12 @@
+/*
+ * Copyright (c) 2024 Semtech Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr/shell/shell.h>
+
+/* Subcommands are added by each feature with SHELL_SUBCMD_ADD((lbm), ...) */
+SHELL_SUBCMD_SET_CREATE(sub_lbm, (lbm));
+
+SHELL_CMD_REGISTER(lbm, &sub_lbm, "LoRa Basics Modem commands", NULL);
@@ -0,0 +1,260 @@
+/*
+ * Copyright (c) 2024 Semtech Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <string.h>
+#include <zephyr/init.h>
+#include <zephyr/kernel.h>
+#include <zephyr/shell/shell.h>
+#include <zephyr/stats/stats.h>
+
+#include "lora_lbm_stats.h"
+
+STATS_SECT_START(lora_lbm_stats)
+STATS_SECT_ENTRY32(irq)              /* Event line assertions */
+STATS_SECT_ENTRY32(irq_missed)       /* Events recovered from the line level, edge missed */
+STATS_SECT_ENTRY32(irq_tx_done)
+STATS_SECT_ENTRY32(irq_tx_timeout)
+STATS_SECT_ENTRY32(irq_rx_done)
+STATS_SECT_ENTRY32(irq_rx_timeout)
+STATS_SECT_ENTRY32(irq_crc_error)
+STATS_SECT_ENTRY32(irq_header_error)
+STATS_SECT_ENTRY32(irq_cad_done)
+STATS_SECT_ENTRY32(irq_cad_detected)
+STATS_SECT_ENTRY32(irq_other)        /* Preamble, sync word, scans, errors... */
+STATS_SECT_ENTRY32(tx)               /* Transmissions started */
+STATS_SECT_ENTRY32(tx_time_ms)       /* Total from TX start to the TX done event */
+STATS_SECT_ENTRY32(tx_time_max_us)
+STATS_SECT_ENTRY32(spi_write)
+STATS_SECT_ENTRY32(spi_read)
+STATS_SECT_ENTRY32(spi_bytes)
+STATS_SECT_ENTRY32(spi_error)
+STATS_SECT_ENTRY32(busy_wait)
+STATS_SECT_ENTRY32(busy_wait_us)
+STATS_SECT_ENTRY32(busy_wait_max_us)
+STATS_SECT_ENTRY32(bus_acquire)      /* Transfers that had to get the shared SPI bus */
+STATS_SECT_ENTRY32(bus_acquire_us)   /* Wait for the bus and transfer */
+STATS_SECT_ENTRY32(bus_acquire_max_us)
+STATS_SECT_ENTRY32(ctx_store)
+STATS_SECT_ENTRY32(ctx_store_bytes)
+STATS_SECT_END;
+
+STATS_NAME_START(lora_lbm_stats)
+STATS_NAME(lora_lbm_stats, irq)
+STATS_NAME(lora_lbm_stats, irq_missed)
+STATS_NAME(lora_lbm_stats, irq_tx_done)
+STATS_NAME(lora_lbm_stats, irq_tx_timeout)
+STATS_NAME(lora_lbm_stats, irq_rx_done)
+STATS_NAME(lora_lbm_stats, irq_rx_timeout)
+STATS_NAME(lora_lbm_stats, irq_crc_error)
+STATS_NAME(lora_lbm_stats, irq_header_error)
+STATS_NAME(lora_lbm_stats, irq_cad_done)
+STATS_NAME(lora_lbm_stats, irq_cad_detected)
+STATS_NAME(lora_lbm_stats, irq_other)
+STATS_NAME(lora_lbm_stats, tx)
+STATS_NAME(lora_lbm_stats, tx_time_ms)
+STATS_NAME(lora_lbm_stats, tx_time_max_us)
+STATS_NAME(lora_lbm_stats, spi_write)
+STATS_NAME(lora_lbm_stats, spi_read)
+STATS_NAME(lora_lbm_stats, spi_bytes)
+STATS_NAME(lora_lbm_stats, spi_error)
+STATS_NAME(lora_lbm_stats, busy_wait)
+STATS_NAME(lora_lbm_stats, busy_wait_us)
+STATS_NAME(lora_lbm_stats, busy_wait_max_us)
+STATS_NAME(lora_lbm_stats, bus_acquire)
+STATS_NAME(lora_lbm_stats, bus_acquire_us)
+STATS_NAME(lora_lbm_stats, bus_acquire_max_us)
+STATS_NAME(lora_lbm_stats, ctx_store)
+STATS_NAME(lora_lbm_stats, ctx_store_bytes)
+STATS_NAME_END(lora_lbm_stats);
+
+static STATS_SECT_DECL(lora_lbm_stats) lora_lbm_stats;
+
+static struct k_spinlock lora_lbm_stats_lock;
+static uint32_t last_irqs;     /* IRQ flags read and not cleared since */
+static int64_t tx_start_ticks; /* 0 when no transmission is ongoing */
+static int64_t event_ticks;    /* Last event line assertion */
+
+void lora_lbm_stats_on_event(void)
+{
+	k_spinlock_key_t key = k_spin_lock(&lora_lbm_stats_lock);
+
+	event_ticks = k_uptime_ticks();
+	STATS_INC(lora_lbm_stats, irq);
+
+	k_spin_unlock(&lora_lbm_stats_lock, key);
+}
+
+void lora_lbm_stats_on_irq_missed(void)
+{
+	k_spinlock_key_t key = k_spin_lock(&lora_lbm_stats_lock);
+
+	STATS_INC(lora_lbm_stats, irq_missed);
+
+	k_spin_unlock(&lora_lbm_stats_lock, key);
+}
+
+void lora_lbm_stats_on_irq_status(uint32_t irqs)
+{
+	k_spinlock_key_t key = k_spin_lock(&lora_lbm_stats_lock);
+	uint32_t raised = irqs & ~last_irqs;
+
+	last_irqs = irqs;
+
+	if (raised & LORA_LBM_STATS_IRQ_TX_DONE) {
+		STATS_INC(lora_lbm_stats, irq_tx_done);
+		if (tx_start_ticks != 0) {
+			// The IRQ status is read after the event, time the TX up to the event
+			int64_t end = (event_ticks > tx_start_ticks) ? event_ticks : k_uptime_ticks();
+			uint32_t tx_us = k_ticks_to_us_floor32(end - tx_start_ticks);
+
+			STATS_INCN(lora_lbm_stats, tx_time_ms, tx_us / USEC_PER_MSEC);
+			if (tx_us > lora_lbm_stats.tx_time_max_us) {
+				lora_lbm_stats.tx_time_max_us = tx_us;
+			}
+		}
+	}
+	if (raised & LORA_LBM_STATS_IRQ_TIMEOUT) {
+		// Both TX and RX timeouts raise the same flag
+		if (tx_start_ticks != 0) {
+			STATS_INC(lora_lbm_stats, irq_tx_timeout);
+		} else {
+			STATS_INC(lora_lbm_stats, irq_rx_timeout);
+		}
+	}
+	if (raised & (LORA_LBM_STATS_IRQ_TX_DONE | LORA_LBM_STATS_IRQ_TIMEOUT)) {
+		tx_start_ticks = 0;
+	}
+	if (raised & LORA_LBM_STATS_IRQ_RX_DONE) {
+		STATS_INC(lora_lbm_stats, irq_rx_done);
+	}
+	if (raised & LORA_LBM_STATS_IRQ_CRC_ERROR) {
+		STATS_INC(lora_lbm_stats, irq_crc_error);
+	}
+	if (raised & LORA_LBM_STATS_IRQ_HEADER_ERROR) {
+		STATS_INC(lora_lbm_stats, irq_header_error);
+	}
+	if (raised & LORA_LBM_STATS_IRQ_CAD_DONE) {
+		STATS_INC(lora_lbm_stats, irq_cad_done);
+	}
+	if (raised & LORA_LBM_STATS_IRQ_CAD_DETECTED) {
+		STATS_INC(lora_lbm_stats, irq_cad_detected);
+	}
+	if (raised & LORA_LBM_STATS_IRQ_OTHER) {
+		STATS_INC(lora_lbm_stats, irq_other);
+	}
+
+	k_spin_unlock(&lora_lbm_stats_lock, key);
+}
+
+void lora_lbm_stats_on_irq_clear(uint32_t irqs)
+{
+	k_spinlock_key_t key = k_spin_lock(&lora_lbm_stats_lock);
+
+	last_irqs &= ~irqs;
+
+	k_spin_unlock(&lora_lbm_stats_lock, key);
+}
+
+void lora_lbm_stats_on_tx_start(void)
+{
+	k_spinlock_key_t key = k_spin_lock(&lora_lbm_stats_lock);
+
+	tx_start_ticks = k_uptime_ticks();
+	STATS_INC(lora_lbm_stats, tx);
+
+	k_spin_unlock(&lora_lbm_stats_lock, key);
+}
+
+void lora_lbm_stats_on_spi(bool write, uint32_t bytes, bool ok)
+{
+	k_spinlock_key_t key = k_spin_lock(&lora_lbm_stats_lock);
+
+	if (!ok) {
+		STATS_INC(lora_lbm_stats, spi_error);
+	} else if (write) {
+		STATS_INC(lora_lbm_stats, spi_write);
+	} else {
+		STATS_INC(lora_lbm_stats, spi_read);
+	}
+	if (ok) {
+		STATS_INCN(lora_lbm_stats, spi_bytes, bytes);
+	}
+
+	k_spin_unlock(&lora_lbm_stats_lock, key);
+}
+
+void lora_lbm_stats_on_busy_wait(uint32_t us)
+{
+	k_spinlock_key_t key = k_spin_lock(&lora_lbm_stats_lock);
+
+	STATS_INC(lora_lbm_stats, busy_wait);
+	STATS_INCN(lora_lbm_stats, busy_wait_us, us);
+	if (us > lora_lbm_stats.busy_wait_max_us) {
+		lora_lbm_stats.busy_wait_max_us = us;
+	}
+
+	k_spin_unlock(&lora_lbm_stats_lock, key);
+}
+
+void lora_lbm_stats_on_bus_acquire(uint32_t us)
+{
+	k_spinlock_key_t key = k_spin_lock(&lora_lbm_stats_lock);
+
+	STATS_INC(lora_lbm_stats, bus_acquire);
+	STATS_INCN(lora_lbm_stats, bus_acquire_us, us);
+	if (us > lora_lbm_stats.bus_acquire_max_us) {
+		lora_lbm_stats.bus_acquire_max_us = us;
+	}
+
+	k_spin_unlock(&lora_lbm_stats_lock, key);
+}
+
+void lora_lbm_stats_on_context_store(uint32_t bytes)
+{
+	k_spinlock_key_t key = k_spin_lock(&lora_lbm_stats_lock);
+
+	STATS_INC(lora_lbm_stats, ctx_store);
+	STATS_INCN(lora_lbm_stats, ctx_store_bytes, bytes);
+
+	k_spin_unlock(&lora_lbm_stats_lock, key);
+}
+
+#ifdef CONFIG_LORA_BASICS_MODEM_SHELL
+
+static int lora_lbm_stats_print(struct stats_hdr *hdr, void *arg, const char *name, uint16_t off)
+{
+	const struct shell *sh = arg;
+
+	shell_print(sh, "%-18s %u", name, *(uint32_t *)((uint8_t *)hdr + off));
+	return 0;
+}
+
+static int cmd_lbm_stats(const struct shell *sh, size_t argc, char **argv)
+{
+	if (argc > 1) {
+		if (strcmp(argv[1], "reset") != 0) {
+			shell_error(sh, "Unknown argument %s", argv[1]);
+			return -EINVAL;
+		}
+		stats_reset(&lora_lbm_stats.s_hdr);
+		return 0;
+	}
+
+	return stats_walk(&lora_lbm_stats.s_hdr, lora_lbm_stats_print, (void *)sh);
+}
+
+SHELL_SUBCMD_ADD((lbm), stats, NULL, "Radio statistics, \"lbm stats reset\" clears them",
+		 cmd_lbm_stats, 1, 1);
+
+#endif /* CONFIG_LORA_BASICS_MODEM_SHELL */
+
+static int lora_lbm_stats_init(void)
+{
+	return STATS_INIT_AND_REG(lora_lbm_stats, STATS_SIZE_32, LORA_LBM_STATS_GROUP);
+}
+
+/* Registered before the transceiver drivers initialization, which already talks to the chip */
+SYS_INIT(lora_lbm_stats_init, POST_KERNEL, 0);
@@ -19,9 +19,74 @@ LOG_MODULE_REGISTER(lr11xx_board, CONFIG_LORA_BASICS_MODEM_DRIVERS_LOG_LEVEL);
 #include "lr11xx_hal_context.h"
 #include "lr11xx_radio_types.h"
 #include "lr11xx_system_types.h"
+#include "lr11xx_tx_pwr_consumption.h"
 
 #define LR11XX_SPI_OPERATION (SPI_WORD_SET(8) | SPI_OP_MODE_MASTER | SPI_TRANSFER_MSB)
 
+#ifdef CONFIG_LORA_BASICS_MODEM_DRIVERS_EVENT_TRIGGER
+/**
+ * @brief Dispatch a radio event to the trigger mode
+ *
+ * @param data
+ */
+static void lr11xx_board_on_event(struct lr11xx_hal_context_data_t *data)
+{
+#ifdef CONFIG_LORA_BASICS_MODEM_DRIVERS_ENERGY
+	lr11xx_energy_on_event(data->lr11xx_dev);
+#endif /* CONFIG_LORA_BASICS_MODEM_DRIVERS_ENERGY */
+	/* Call provided callback */
+#ifdef CONFIG_LORA_BASICS_MODEM_DRIVERS_EVENT_TRIGGER_OWN_THREAD
+	k_sem_give(&data->trig_sem);
+#elif defined(CONFIG_LORA_BASICS_MODEM_DRIVERS_EVENT_TRIGGER_GLOBAL_THREAD)
+	k_work_submit(&data->work);
+#endif
+}
+
+#ifdef CONFIG_LR11XX_EVENT_LEVEL_TRIGGER
+/**
+ * @brief Event pin callback handler.
+ *
+ * The interrupt is level triggered: mask it until the HAL clears the IRQ status,
+ * see lr11xx_board_on_irq_clear.
+ *
+ * @param dev
+ * @param cb
+ * @param pins
+ */
+static void lr11xx_board_event_callback(const struct device *dev, struct gpio_callback *cb,
+					uint32_t pins)
+{
+	struct lr11xx_hal_context_data_t *data =
+		CONTAINER_OF(cb, struct lr11xx_hal_context_data_t, event_cb);
+	const struct lr11xx_hal_context_cfg_t *config = data->lr11xx_dev->config;
+	k_spinlock_key_t key;
+
+	if ((pins & BIT(config->event.pin)) == 0U) {
+		return;
+	}
+
+	key = k_spin_lock(&data->irq_lock);
+	gpio_pin_interrupt_configure_dt(&config->event, GPIO_INT_DISABLE);
+	data->irq_pending = true;
+	k_spin_unlock(&data->irq_lock, key);
+
+	lr11xx_board_on_event(data);
+}
+
+void lr11xx_board_on_irq_clear(const struct device *dev)
+{
+	const struct lr11xx_hal_context_cfg_t *config = dev->config;
+	struct lr11xx_hal_context_data_t *data = dev->data;
+	k_spinlock_key_t key = k_spin_lock(&data->irq_lock);
+
+	data->irq_pending = false;
+	if (data->irq_enabled) {
+		// Fires right away if an IRQ was raised since the status read, no edge can be lost
+		gpio_pin_interrupt_configure_dt(&config->event, GPIO_INT_LEVEL_ACTIVE);
+	}
+	k_spin_unlock(&data->irq_lock, key);
+}
+#else
 /**
  * @brief Event pin callback handler.
  *
@@ -43,22 +108,19 @@ static void lr11xx_board_event_callback(const struct device *dev, struct gpio_ca
 	if (gpio_pin_get_dt(&config->event)) {
 		/* Wait for value to drop */
 		gpio_pin_interrupt_configure_dt(&config->event, GPIO_INT_EDGE_TO_INACTIVE);
-		/* Call provided callback */
-#ifdef CONFIG_LORA_BASICS_MODEM_DRIVERS_EVENT_TRIGGER_OWN_THREAD
-		k_sem_give(&data->gpio_sem);
-#elif CONFIG_LORA_BASICS_MODEM_DRIVERS_EVENT_TRIGGER_GLOBAL_THREAD
-		k_work_submit(&data->work);
-#endif
+		lr11xx_board_on_event(data);
 	} else {
 		gpio_pin_interrupt_configure_dt(&config->event, GPIO_INT_EDGE_TO_ACTIVE);
 	}
 }
+#endif /* CONFIG_LR11XX_EVENT_LEVEL_TRIGGER */
+#endif /* CONFIG_LORA_BASICS_MODEM_DRIVERS_EVENT_TRIGGER */
 
 #ifdef CONFIG_LORA_BASICS_MODEM_DRIVERS_EVENT_TRIGGER_OWN_THREAD
 static void lr11xx_thread(struct lr11xx_hal_context_data_t *data)
 {
 	while (1) {
-		k_sem_take(&data->gpio_sem, K_FOREVER);
+		k_sem_take(&data->trig_sem, K_FOREVER);
 		if (data->event_interrupt_cb) {
 			data->event_interrupt_cb(data->lr11xx_dev);
 		}
@@ -89,7 +151,18 @@ void lora_transceiver_board_attach_interrupt(const struct device *dev, event_cb_
 
 void lora_transceiver_board_enable_interrupt(const struct device *dev)
 {
-#ifdef CONFIG_LORA_BASICS_MODEM_DRIVERS_EVENT_TRIGGER
+#ifdef CONFIG_LR11XX_EVENT_LEVEL_TRIGGER
+	const struct lr11xx_hal_context_cfg_t *config = dev->config;
+	struct lr11xx_hal_context_data_t *data = dev->data;
+	k_spinlock_key_t key = k_spin_lock(&data->irq_lock);
+
+	data->irq_enabled = true;
+	// Keep the line masked while its IRQ is being serviced, the level is checked once cleared
+	if (!data->irq_pending) {
+		gpio_pin_interrupt_configure_dt(&config->event, GPIO_INT_LEVEL_ACTIVE);
+	}
+	k_spin_unlock(&data->irq_lock, key);
+#elif defined(CONFIG_LORA_BASICS_MODEM_DRIVERS_EVENT_TRIGGER)
 	const struct lr11xx_hal_context_cfg_t *config = dev->config;
 	gpio_pin_interrupt_configure_dt(&config->event, GPIO_INT_EDGE_TO_ACTIVE);
 #else
@@ -99,7 +172,15 @@ void lora_transceiver_board_enable_interrupt(const struct device *dev)
 
 void lora_transceiver_board_disable_interrupt(const struct device *dev)
 {
-#ifdef CONFIG_LORA_BASICS_MODEM_DRIVERS_EVENT_TRIGGER
+#ifdef CONFIG_LR11XX_EVENT_LEVEL_TRIGGER
+	const struct lr11xx_hal_context_cfg_t *config = dev->config;
+	struct lr11xx_hal_context_data_t *data = dev->data;
+	k_spinlock_key_t key = k_spin_lock(&data->irq_lock);
+
+	data->irq_enabled = false;
+	gpio_pin_interrupt_configure_dt(&config->event, GPIO_INT_DISABLE);
+	k_spin_unlock(&data->irq_lock, key);
+#elif defined(CONFIG_LORA_BASICS_MODEM_DRIVERS_EVENT_TRIGGER)
 	const struct lr11xx_hal_context_cfg_t *config = dev->config;
 	gpio_pin_interrupt_configure_dt(&config->event, GPIO_INT_DISABLE);
 #else
@@ -107,6 +188,32 @@ void lora_transceiver_board_disable_interrupt(const struct device *dev)
 #endif // CONFIG_LORA_BASICS_MODEM_DRIVERS_EVENT_TRIGGER
 }
 
+bool lora_transceiver_board_is_event_pending(const struct device *dev)
+{
+#ifdef CONFIG_LR11XX_EVENT_LEVEL_TRIGGER
+	ARG_UNUSED(dev);
+	// A level interrupt is not lost, it fires as soon as it is unmasked
+	return false;
+#elif defined(CONFIG_LORA_BASICS_MODEM_DRIVERS_EVENT_TRIGGER)
+	const struct lr11xx_hal_context_cfg_t *config = dev->config;
+	struct lr11xx_hal_context_data_t *data = dev->data;
+
+#ifdef CONFIG_LORA_BASICS_MODEM_DRIVERS_EVENT_TRIGGER_OWN_THREAD
+	if (k_sem_count_get(&data->trig_sem) > 0) {
+		return false;
+	}
+#elif defined(CONFIG_LORA_BASICS_MODEM_DRIVERS_EVENT_TRIGGER_GLOBAL_THREAD)
+	if (k_work_busy_get(&data->work) & (K_WORK_QUEUED | K_WORK_RUNNING)) {
+		return false;
+	}
+#endif
+	return gpio_pin_get_dt(&config->event) == 1;
+#else
+	ARG_UNUSED(dev);
+	return false;
+#endif // CONFIG_LR11XX_EVENT_LEVEL_TRIGGER
+}
+
 uint32_t lora_transceiver_get_tcxo_startup_delay_ms(const struct device *dev)
 {
 	const struct lr11xx_hal_context_cfg_t *config = dev->config;
@@ -162,12 +269,18 @@ static int lr11xx_init(const struct device *dev)
 	data->lr11xx_dev = dev;
 	data->radio_status = RADIO_AWAKE;
 	data->tx_offset = config->tx_offset;
+#ifdef CONFIG_LORA_BASICS_MODEM_DRIVERS_ENERGY
+	lr11xx_energy_init(dev);
+#endif /* CONFIG_LORA_BASICS_MODEM_DRIVERS_ENERGY */
+#ifdef CONFIG_LORA_BASICS_MODEM_DRIVERS_BUS_LOCK
+	lora_lbm_bus_init(&data->bus, &config->spi);
+#endif /* CONFIG_LORA_BASICS_MODEM_DRIVERS_BUS_LOCK */
 
 	// Event pin trigger config
 #ifdef CONFIG_LORA_BASICS_MODEM_DRIVERS_EVENT_TRIGGER
 #ifdef CONFIG_LORA_BASICS_MODEM_DRIVERS_EVENT_TRIGGER_GLOBAL_THREAD
 	data->work.handler = lr11xx_work_cb;
-#elif CONFIG_LORA_BASICS_MODEM_DRIVERS_EVENT_TRIGGER_OWN_THREAD
+#elif defined(CONFIG_LORA_BASICS_MODEM_DRIVERS_EVENT_TRIGGER_OWN_THREAD)
 	k_sem_init(&data->trig_sem, 0, K_SEM_MAX_LIMIT);
 
 	k_thread_create(&data->thread, data->thread_stack, CONFIG_LORA_BASICS_MODEM_DRIVERS_EVENT_TRIGGER_THREAD_STACK_SIZE,
@@ -238,7 +351,7 @@ static int lr11xx_pm_action(const struct device *dev, enum pm_device_action acti
 // LR11xx does not support external TCXO control
 #define LR11XX_CFG_TCXO(node_id)                                              \
 	.tcxo_cfg = {                                                             \
-		.xosc_cfg = COND_CODE_1(DT_PROP(node_id, tcxo_wakeup_time) == 0,      \
+		.xosc_cfg = COND_CODE_0(DT_PROP(node_id, tcxo_wakeup_time),           \
 			(RAL_XOSC_CFG_XTAL), (RAL_XOSC_CFG_TCXO_RADIO_CTRL)),             \
 		.voltage = DT_PROP(node_id, tcxo_voltage),                            \
 		.wakeup_time_ms = DT_PROP(node_id, tcxo_wakeup_time),                 \
@@ -268,6 +381,76 @@ static int lr11xx_pm_action(const struct device *dev, enum pm_device_action acti
 		.gain_tune = DT_TABLE_U8(node_id, DT_CAT3(rssi_calibration_, range, _tune)), \
 	}
 
+/*
+ * TX power table generation: each <power pa_duty_cycle pa_hp_sel> devicetree cell
+ * lands in the entry of its dBm step, then the PA supply and the consumption
+ * estimate for the devicetree regulator mode are added to every step.
+ */
+#define LR11XX_TX_PWR_CELL(node_id, prop, idx) \
+	[(idx) / 3].dt_cell[(idx) % 3] = (int8_t) DT_PROP_BY_IDX(node_id, prop, idx)
+
+#define LR11XX_TX_PWR_CELLS(node_id, prop) \
+	DT_FOREACH_PROP_ELEM_SEP(node_id, prop, LR11XX_TX_PWR_CELL, (,))
+
+/* For powers below 8dBm use regulated supply for HP PA for a better efficiency */
+#define LR11XX_TX_PWR_LF_HP_SUPPLY(idx)                                        \
+	((((idx) + LR11XX_MIN_PWR_HP_LF) <= LR11XX_PWR_VREG_VBAT_SWITCH) ?         \
+		LR11XX_RADIO_PA_REG_SUPPLY_VREG : LR11XX_RADIO_PA_REG_SUPPLY_VBAT)
+
+#define LR11XX_TX_PWR_VREG(idx, _) \
+	[idx].pa_reg_supply = LR11XX_RADIO_PA_REG_SUPPLY_VREG
+
+#define LR11XX_TX_PWR_LF_HP(idx, _) \
+	[idx].pa_reg_supply = LR11XX_TX_PWR_LF_HP_SUPPLY(idx)
+
+#define LR11XX_TX_PWR_UA(idx, ua) \
+	[idx].consumption_ua = (ua)
+
+/* HP PA consumption is only characterized on VBAT */
+#define LR11XX_TX_PWR_LF_HP_UA(idx, ua)                                        \
+	[idx].consumption_ua =                                                    \
+		(LR11XX_TX_PWR_LF_HP_SUPPLY(idx) == LR11XX_RADIO_PA_REG_SUPPLY_VBAT) ? (ua) : 0
+
+#define LR11XX_TX_PWR_UA_LIST(node_id, pa)                                    \
+	COND_CODE_1(DT_PROP(node_id, reg_mode),                                   \
+		(LR11XX_TX_PWR_UA_DCDC_##pa), (LR11XX_TX_PWR_UA_LDO_##pa))
+
+#define LR11XX_TX_PWR_TABLE(node_id)                                          \
+	.tx_pwr_table = {                                                         \
+		.lf_lp = {                                                            \
+			LR11XX_TX_PWR_CELLS(node_id, tx_power_cfg_lf_lp),                 \
+			LISTIFY(LR11XX_LF_LP_TX_PWR_STEPS, LR11XX_TX_PWR_VREG, (,)),      \
+			FOR_EACH_IDX(LR11XX_TX_PWR_UA, (,),                               \
+				LR11XX_TX_PWR_UA_LIST(node_id, LF_LP)),                       \
+		},                                                                    \
+		.lf_hp = {                                                            \
+			LR11XX_TX_PWR_CELLS(node_id, tx_power_cfg_lf_hp),                 \
+			LISTIFY(LR11XX_LF_HP_TX_PWR_STEPS, LR11XX_TX_PWR_LF_HP, (,)),     \
+			FOR_EACH_IDX(LR11XX_TX_PWR_LF_HP_UA, (,),                         \
+				LR11XX_TX_PWR_UA_LIST(node_id, LF_HP)),                       \
+		},                                                                    \
+		.hf = {                                                               \
+			LR11XX_TX_PWR_CELLS(node_id, tx_power_cfg_hf),                    \
+			LISTIFY(LR11XX_HF_TX_PWR_STEPS, LR11XX_TX_PWR_VREG, (,)),         \
+			/* HF PA consumption is only characterized in DC-DC mode */       \
+			COND_CODE_1(DT_PROP(node_id, reg_mode),                           \
+				(FOR_EACH_IDX(LR11XX_TX_PWR_UA, (,),                          \
+					LR11XX_TX_PWR_UA_DCDC_HF)), ())                           \
+		},                                                                    \
+	}
+
+#define LR11XX_CHECK_TABLE_LEN(node_id, prop, len)                            \
+	BUILD_ASSERT(DT_PROP_LEN(node_id, prop) == (len),                         \
+		     DT_NODE_PATH(node_id) " has a wrong number of " #prop " values")
+
+#define LR11XX_CHECK_TABLES(node_id)                                          \
+	LR11XX_CHECK_TABLE_LEN(node_id, tx_power_cfg_lf_lp, 3 * LR11XX_LF_LP_TX_PWR_STEPS); \
+	LR11XX_CHECK_TABLE_LEN(node_id, tx_power_cfg_lf_hp, 3 * LR11XX_LF_HP_TX_PWR_STEPS); \
+	LR11XX_CHECK_TABLE_LEN(node_id, tx_power_cfg_hf, 3 * LR11XX_HF_TX_PWR_STEPS);       \
+	LR11XX_CHECK_TABLE_LEN(node_id, rssi_calibration_lf_tune, LR11XX_RSSI_CALIBRATION_TUNE_LENGTH); \
+	LR11XX_CHECK_TABLE_LEN(node_id, rssi_calibration_mf_tune, LR11XX_RSSI_CALIBRATION_TUNE_LENGTH); \
+	LR11XX_CHECK_TABLE_LEN(node_id, rssi_calibration_hf_tune, LR11XX_RSSI_CALIBRATION_TUNE_LENGTH)
+
 #define LR11XX_CONFIG(node_id)                                                \
 	{                                                                         \
 		.spi = SPI_DT_SPEC_GET(node_id, LR11XX_SPI_OPERATION, 0),             \
@@ -282,9 +465,7 @@ static int lr11xx_pm_action(const struct device *dev, enum pm_device_action acti
 		.reg_mode = DT_PROP(node_id, reg_mode),                               \
 		.rx_boosted = DT_PROP(node_id, rx_boosted),                           \
 		.tx_offset = DT_PROP_OR(node_id, tx_offset, 0),                       \
-		.pa_lf_lp_cfg_table = (lr11xx_pa_pwr_cfg_t*) DT_CAT(pa_lf_lp_cfg_table_, node_id), \
-		.pa_lf_hp_cfg_table = (lr11xx_pa_pwr_cfg_t*) DT_CAT(pa_lf_hp_cfg_table_, node_id), \
-		.pa_hf_cfg_table = (lr11xx_pa_pwr_cfg_t*) DT_CAT(pa_hf_cfg_table_, node_id),       \
+		LR11XX_TX_PWR_TABLE(node_id),                                         \
 		.rssi_calibration_table_below_600mhz = LR11XX_RSSI_CFG(node_id, lf),               \
 		.rssi_calibration_table_from_600mhz_to_2ghz = LR11XX_RSSI_CFG(node_id, mf),        \
 		.rssi_calibration_table_above_2ghz = LR11XX_RSSI_CFG(node_id, hf),                 \
@@ -297,9 +478,7 @@ static int lr11xx_pm_action(const struct device *dev, enum pm_device_action acti
 
 #define LR11XX_DEFINE(node_id)                                                                       \
 	static struct lr11xx_hal_context_data_t lr11xx_data_##node_id;                                   \
-	static uint8_t pa_lf_lp_cfg_table_##node_id[] = DT_TABLE_U8(node_id, tx_power_cfg_lf_lp);        \
-	static uint8_t pa_lf_hp_cfg_table_##node_id[] = DT_TABLE_U8(node_id, tx_power_cfg_lf_hp);        \
-	static uint8_t pa_hf_cfg_table_##node_id[] = DT_TABLE_U8(node_id, tx_power_cfg_hf);              \
+	LR11XX_CHECK_TABLES(node_id);                                                                    \
 	static const struct lr11xx_hal_context_cfg_t lr11xx_config_##node_id = LR11XX_CONFIG(node_id);   \
 	PM_DEVICE_DT_DEFINE(node_id, lr11xx_pm_action);                                                  \
 	LR11XX_DEVICE_INIT(node_id)
@@ -0,0 +1,193 @@
+/*
+ * Copyright (c) 2024 Semtech Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/sys/byteorder.h>
+
+#include "ral_lr11xx_bsp.h"
+#include "lora_lbm_energy.h"
+#include "lr11xx_hal_context.h"
+
+/* Opcodes of the commands changing the chip state */
+#define LR11XX_SYSTEM_SET_SLEEP_OC 0x011B
+#define LR11XX_SYSTEM_SET_STANDBY_OC 0x011C
+#define LR11XX_SYSTEM_SET_FS_OC 0x011D
+#define LR11XX_RADIO_SET_RX_OC 0x0209
+#define LR11XX_RADIO_SET_TX_OC 0x020A
+#define LR11XX_RADIO_SET_PKT_TYPE_OC 0x020E
+#define LR11XX_RADIO_SET_RX_DUTY_CYCLE_OC 0x0214
+#define LR11XX_RADIO_SET_CAD_OC 0x0218
+#define LR11XX_RADIO_SET_TX_CW_OC 0x0219
+#define LR11XX_RADIO_SET_TX_INFINITE_PREAMBLE_OC 0x021A
+#define LR11XX_WIFI_SCAN_OC 0x0300
+#define LR11XX_WIFI_SCAN_TIME_LIMIT_OC 0x0301
+#define LR11XX_WIFI_COUNTRY_CODE_OC 0x0302
+#define LR11XX_WIFI_COUNTRY_CODE_TIME_LIMIT_OC 0x0303
+#define LR11XX_GNSS_SCAN_AUTONOMOUS_OC 0x0409
+#define LR11XX_GNSS_SCAN_ASSISTED_OC 0x040A
+#define LR11XX_GNSS_SCAN_OC 0x040B
+
+#define LR11XX_RADIO_PKT_TYPE_GFSK 0x01
+#define LR11XX_RADIO_RX_CONTINUOUS 0xFFFFFF
+
+/*
+ * LR1110 datasheet typical figures, in uA: sleep with retention and the 32 kHz RC (rounded up)
+ * and standby on the RC oscillator. A CAD is accounted as a LoRa reception. Scan figures are
+ * from the LR1110 user manual, Wi-Fi passive scan and GNSS capture.
+ */
+#define LR11XX_SLEEP_CONSUMPTION 2
+#define LR11XX_STANDBY_CONSUMPTION 1100
+#define LR11XX_WIFI_SCAN_CONSUMPTION_DCDC 11000
+#define LR11XX_WIFI_SCAN_CONSUMPTION_LDO 17000
+/* GNSS capture phase, EVK board with a 32MHz TCXO */
+#define LR11XX_GNSS_SCAN_CONSUMPTION_DCDC 11900
+#define LR11XX_GNSS_SCAN_CONSUMPTION_LDO 11900
+
+static uint32_t lr11xx_energy_rx_current_ua(const struct device *dev, bool gfsk)
+{
+	const struct lr11xx_hal_context_cfg_t *config = dev->config;
+	uint32_t current_ua = 0;
+
+	if (gfsk) {
+		ral_lr11xx_bsp_get_instantaneous_gfsk_rx_power_consumption(
+			dev, config->reg_mode, config->rx_boosted, &current_ua);
+	} else {
+		ral_lr11xx_bsp_get_instantaneous_lora_rx_power_consumption(
+			dev, config->reg_mode, config->rx_boosted, &current_ua);
+	}
+	return current_ua;
+}
+
+static void lr11xx_energy_enter_rx(const struct device *dev, bool continuous)
+{
+	struct lr11xx_hal_context_data_t *data = dev->data;
+
+	data->energy_rx_continuous = continuous;
+	// LBT senses the channel RSSI in a continuous GFSK reception, stopped by the modem
+	lora_lbm_energy_enter(&data->energy,
+			      (data->energy_gfsk && continuous) ? LORA_LBM_ENERGY_CAD_LBT :
+								  LORA_LBM_ENERGY_RX_WINDOWS,
+			      lr11xx_energy_rx_current_ua(dev, data->energy_gfsk));
+}
+
+void lr11xx_energy_init(const struct device *dev)
+{
+	struct lr11xx_hal_context_data_t *data = dev->data;
+
+	lora_lbm_energy_init(&data->energy, LR11XX_STANDBY_CONSUMPTION);
+}
+
+void lr11xx_energy_set_tx_cfg(const void *context,
+	const ral_lr11xx_bsp_tx_cfg_output_params_t *tx_cfg)
+{
+	const struct device *dev = context;
+	const struct lr11xx_hal_context_cfg_t *config = dev->config;
+	struct lr11xx_hal_context_data_t *data = dev->data;
+	uint32_t current_ua = 0;
+
+	// Keep 0 when the consumption of this PA configuration is unknown
+	ral_lr11xx_bsp_get_instantaneous_tx_power_consumption(context, tx_cfg, config->reg_mode,
+							       &current_ua);
+	data->energy.tx_current_ua = current_ua;
+}
+
+void lr11xx_energy_on_command(const struct device *dev, const uint8_t *command,
+	uint16_t command_length)
+{
+	const struct lr11xx_hal_context_cfg_t *config = dev->config;
+	struct lr11xx_hal_context_data_t *data = dev->data;
+	bool dcdc = (config->reg_mode == LR11XX_SYSTEM_REG_MODE_DCDC);
+
+	if (command_length < 2) {
+		return;
+	}
+
+	switch (sys_get_be16(command)) {
+	case LR11XX_SYSTEM_SET_SLEEP_OC:
+		lora_lbm_energy_enter(&data->energy, LORA_LBM_ENERGY_SLEEP, LR11XX_SLEEP_CONSUMPTION);
+		break;
+	case LR11XX_SYSTEM_SET_STANDBY_OC:
+	case LR11XX_SYSTEM_SET_FS_OC:
+		lora_lbm_energy_enter(&data->energy, LORA_LBM_ENERGY_STANDBY,
+				      LR11XX_STANDBY_CONSUMPTION);
+		break;
+	case LR11XX_RADIO_SET_PKT_TYPE_OC:
+		if (command_length > 2) {
+			data->energy_gfsk = (command[2] == LR11XX_RADIO_PKT_TYPE_GFSK);
+		}
+		break;
+	case LR11XX_RADIO_SET_TX_OC:
+	case LR11XX_RADIO_SET_TX_CW_OC:
+	case LR11XX_RADIO_SET_TX_INFINITE_PREAMBLE_OC:
+		lora_lbm_energy_enter(&data->energy, LORA_LBM_ENERGY_LORAWAN_TX,
+				      data->energy.tx_current_ua);
+		break;
+	case LR11XX_RADIO_SET_RX_OC:
+		lr11xx_energy_enter_rx(dev, (command_length > 4) &&
+				       (sys_get_be24(&command[2]) == LR11XX_RADIO_RX_CONTINUOUS));
+		break;
+	case LR11XX_RADIO_SET_RX_DUTY_CYCLE_OC:
+		lr11xx_energy_enter_rx(dev, false);
+		break;
+	case LR11XX_RADIO_SET_CAD_OC:
+		data->energy_rx_continuous = false;
+		lora_lbm_energy_enter(&data->energy, LORA_LBM_ENERGY_CAD_LBT,
+				      lr11xx_energy_rx_current_ua(dev, false));
+		break;
+	case LR11XX_WIFI_SCAN_OC:
+	case LR11XX_WIFI_SCAN_TIME_LIMIT_OC:
+	case LR11XX_WIFI_COUNTRY_CODE_OC:
+	case LR11XX_WIFI_COUNTRY_CODE_TIME_LIMIT_OC:
+		lora_lbm_energy_enter(&data->energy, LORA_LBM_ENERGY_WIFI,
+				      dcdc ? LR11XX_WIFI_SCAN_CONSUMPTION_DCDC : LR11XX_WIFI_SCAN_CONSUMPTION_LDO);
+		break;
+	case LR11XX_GNSS_SCAN_AUTONOMOUS_OC:
+	case LR11XX_GNSS_SCAN_ASSISTED_OC:
+	case LR11XX_GNSS_SCAN_OC:
+		lora_lbm_energy_enter(&data->energy, LORA_LBM_ENERGY_GNSS,
+				      dcdc ? LR11XX_GNSS_SCAN_CONSUMPTION_DCDC : LR11XX_GNSS_SCAN_CONSUMPTION_LDO);
+		break;
+	default:
+		break;
+	}
+}
+
+void lr11xx_energy_on_wakeup(const struct device *dev)
+{
+	struct lr11xx_hal_context_data_t *data = dev->data;
+
+	lora_lbm_energy_enter(&data->energy, LORA_LBM_ENERGY_STANDBY, LR11XX_STANDBY_CONSUMPTION);
+}
+
+void lr11xx_energy_on_event(const struct device *dev)
+{
+	struct lr11xx_hal_context_data_t *data = dev->data;
+
+	// TX, RX, CAD and scans end with an event, the chip then falls back to standby
+	switch (data->energy.category) {
+	case LORA_LBM_ENERGY_RX_WINDOWS:
+	case LORA_LBM_ENERGY_CAD_LBT:
+		if (data->energy_rx_continuous) {
+			break;
+		}
+		__fallthrough;
+	case LORA_LBM_ENERGY_LORAWAN_TX:
+	case LORA_LBM_ENERGY_WIFI:
+	case LORA_LBM_ENERGY_GNSS:
+		lora_lbm_energy_enter(&data->energy, LORA_LBM_ENERGY_STANDBY,
+				      LR11XX_STANDBY_CONSUMPTION);
+		break;
+	default:
+		break;
+	}
+}
+
+struct lora_lbm_energy *lora_transceiver_get_energy(const struct device *dev)
+{
+	struct lr11xx_hal_context_data_t *data = dev->data;
+
+	return &data->energy;
+}
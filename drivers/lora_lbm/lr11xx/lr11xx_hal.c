@@ -8,6 +8,7 @@
 #include <zephyr/drivers/gpio.h>
 #include <zephyr/drivers/spi.h>
 #include <zephyr/kernel.h>
+#include <zephyr/sys/byteorder.h>
 #include <zephyr/types.h>
 
 #include <zephyr/logging/log.h>
@@ -15,9 +16,92 @@ LOG_MODULE_REGISTER(lr11xx_hal, CONFIG_LORA_BASICS_MODEM_DRIVERS_LOG_LEVEL);
 
 #include "lr11xx_hal.h"
 #include "lr11xx_hal_context.h"
+#include "lr11xx_system.h"
+#include "lora_lbm_stats.h"
+#include "lora_lbm_transceiver.h"
+#include "lora_lbm_tracing.h"
 
 #define LR11XX_HAL_WAIT_ON_BUSY_TIMEOUT_SEC CONFIG_LR11XX_HAL_WAIT_ON_BUSY_TIMEOUT_SEC
 
+/* LR11XX_RADIO_SET_TX_OC opcode */
+#define LR11XX_HAL_SET_TX_OC 0x020A
+/* LR11XX_SYSTEM_CLEAR_IRQ_OC opcode */
+#define LR11XX_HAL_CLEAR_IRQ_OC 0x0114
+/* Direct read length of lr11xx_system_get_status: Stat1, Stat2 and the IRQ status */
+#define LR11XX_HAL_GET_STATUS_LENGTH 6
+
+#ifdef CONFIG_LORA_BASICS_MODEM_DRIVERS_BUS_LOCK
+/* LR11XX_RADIO_SET_PKT_PARAM_OC opcode, opening the commands sequence of a radio operation */
+#define LR11XX_HAL_SET_PKT_PARAM_OC 0x0210
+
+/* Opcodes starting a radio operation or leaving it, closing the commands sequence */
+static bool lr11xx_hal_is_sequence_end(uint16_t opcode)
+{
+	switch (opcode) {
+	case 0x011B: // SetSleep
+	case 0x011C: // SetStandby
+	case 0x011D: // SetFs
+	case 0x0209: // SetRx
+	case 0x020A: // SetTx
+	case 0x0214: // SetRxDutyCycle
+	case 0x0218: // SetCad
+	case 0x0219: // SetTxCw
+	case 0x021A: // SetTxInfinitePreamble
+		return true;
+	default:
+		return false;
+	}
+}
+#endif /* CONFIG_LORA_BASICS_MODEM_DRIVERS_BUS_LOCK */
+
+#ifdef CONFIG_LR11XX_EVENT_LEVEL_TRIGGER
+/*
+ * Opcodes ending the service of a radio event, the level triggered interrupt is unmasked. The
+ * stack may drop the event with a standby or sleep instead of clearing its IRQ status.
+ */
+static bool lr11xx_hal_is_irq_serviced(uint16_t opcode)
+{
+	switch (opcode) {
+	case LR11XX_HAL_CLEAR_IRQ_OC:
+	case 0x011B: // SetSleep
+	case 0x011C: // SetStandby
+		return true;
+	default:
+		return false;
+	}
+}
+#endif /* CONFIG_LR11XX_EVENT_LEVEL_TRIGGER */
+
+#ifdef CONFIG_LORA_BASICS_MODEM_DRIVERS_STATS
+/* IRQ status flags, see lr11xx_system_irq_mask_e */
+static const uint32_t lr11xx_hal_stats_irqs[][2] = {
+	{ BIT(2), LORA_LBM_STATS_IRQ_TX_DONE },
+	{ BIT(3), LORA_LBM_STATS_IRQ_RX_DONE },
+	{ BIT(6), LORA_LBM_STATS_IRQ_HEADER_ERROR },
+	{ BIT(7), LORA_LBM_STATS_IRQ_CRC_ERROR },
+	{ BIT(8), LORA_LBM_STATS_IRQ_CAD_DONE },
+	{ BIT(9), LORA_LBM_STATS_IRQ_CAD_DETECTED },
+	{ BIT(10), LORA_LBM_STATS_IRQ_TIMEOUT },
+};
+
+/* LORA_LBM_STATS_IRQ_* flags of the chip IRQ flags */
+static uint32_t lr11xx_hal_stats_convert(uint32_t chip_irqs)
+{
+	uint32_t irqs = 0;
+
+	for (int i = 0; i < ARRAY_SIZE(lr11xx_hal_stats_irqs); i++) {
+		if (chip_irqs & lr11xx_hal_stats_irqs[i][0]) {
+			irqs |= lr11xx_hal_stats_irqs[i][1];
+			chip_irqs &= ~lr11xx_hal_stats_irqs[i][0];
+		}
+	}
+	if (chip_irqs) {
+		irqs |= LORA_LBM_STATS_IRQ_OTHER;
+	}
+	return irqs;
+}
+#endif /* CONFIG_LORA_BASICS_MODEM_DRIVERS_STATS */
+
 /**
  * @brief Wait until radio busy pin returns to inactive state or
  * until LR11XX_HAL_WAIT_ON_BUSY_TIMEOUT_SEC passes.
@@ -28,8 +112,10 @@ static lr11xx_hal_status_t lr11xx_hal_wait_on_busy(const void* context)
 {
 	const struct device *dev = (const struct device *)context;
 	const struct lr11xx_hal_context_cfg_t *config = dev->config;
+	int64_t start = k_uptime_ticks();
 	bool ret;
 
+	LORA_LBM_TRACE_BEGIN(busy_wait, 0);
 	ret = WAIT_FOR(
 		gpio_pin_get_dt(&config->busy) == 0,
 		(1000 * CONFIG_LORA_BASICS_MODEM_DRIVERS_HAL_WAIT_ON_BUSY_TIMEOUT_MSEC),
@@ -40,9 +126,59 @@ static lr11xx_hal_status_t lr11xx_hal_wait_on_busy(const void* context)
 			CONFIG_LORA_BASICS_MODEM_DRIVERS_HAL_WAIT_ON_BUSY_TIMEOUT_MSEC);
 		k_oops();
 	}
+	lora_lbm_stats_on_busy_wait(k_ticks_to_us_floor32(k_uptime_ticks() - start));
+	LORA_LBM_TRACE_END(busy_wait, 0);
 	return LR11XX_HAL_STATUS_OK;
 }
 
+/**
+ * @brief SPI transfer with the transceiver, in the ongoing radio transaction if any
+ *
+ */
+static int lr11xx_hal_spi_transceive(const struct device *dev,
+	const struct spi_buf_set *tx, const struct spi_buf_set *rx)
+{
+#ifdef CONFIG_LORA_BASICS_MODEM_DRIVERS_BUS_LOCK
+	struct lr11xx_hal_context_data_t *data = dev->data;
+
+	return lora_lbm_bus_transceive(&data->bus, tx, rx);
+#else
+	const struct lr11xx_hal_context_cfg_t *config = dev->config;
+
+	return spi_transceive_dt(&config->spi, tx, rx);
+#endif /* CONFIG_LORA_BASICS_MODEM_DRIVERS_BUS_LOCK */
+}
+
+/**
+ * @brief Keep the status bytes shifted out by the chip, see lr11xx_hal_context_get_stat
+ *
+ * @param dev
+ * @param stat Stat1, then Stat2 if length is 2
+ * @param length number of status bytes received
+ */
+static void lr11xx_hal_update_stat(const struct device *dev, const uint8_t *stat, size_t length)
+{
+	struct lr11xx_hal_context_data_t *data = dev->data;
+	atomic_val_t value = LR11XX_HAL_CONTEXT_STAT_VALID |
+			     (stat[0] << LR11XX_HAL_CONTEXT_STAT1_SHIFT);
+
+	if (length > 1) {
+		value |= stat[1];
+	} else {
+		// Stat2 is only sent with the command, keep the previous one
+		value |= atomic_get(&data->stat) & LR11XX_HAL_CONTEXT_STAT2_MASK;
+	}
+	atomic_set(&data->stat, value);
+
+#ifdef CONFIG_LR11XX_EVENT_LEVEL_TRIGGER
+	// The chip reports no IRQ anymore, the status was cleared another way than a ClearIrq.
+	// An IRQ raised during the transfer only fires the event once more when unmasked.
+	if (data->irq_pending && !lr11xx_hal_context_is_irq_pending(dev)) {
+		lr11xx_board_on_irq_clear(dev);
+	}
+#endif /* CONFIG_LR11XX_EVENT_LEVEL_TRIGGER */
+}
+
 /**
  * @brief Check if device is ready to receive spi transaction.
  *
@@ -65,6 +201,9 @@ static void lr11xx_hal_check_device_ready(const void* context)
 		gpio_pin_set_dt(cs, 0);
 		lr11xx_hal_wait_on_busy(context);
 		data->radio_status = RADIO_AWAKE;
+#ifdef CONFIG_LORA_BASICS_MODEM_DRIVERS_ENERGY
+		lr11xx_energy_on_wakeup(dev);
+#endif /* CONFIG_LORA_BASICS_MODEM_DRIVERS_ENERGY */
 	}
 }
 
@@ -78,10 +217,10 @@ lr11xx_hal_status_t lr11xx_hal_write(const void *context,
 	const uint8_t *data, const uint16_t data_length)
 {
 	const struct device *dev = (const struct device *)context;
-	const struct lr11xx_hal_context_cfg_t *config = dev->config;
 	struct lr11xx_hal_context_data_t *dev_data = dev->data;
 	int ret;
 
+	LORA_LBM_TRACE_BEGIN(lr11xx_write, sys_get_be16(command));
 #if defined(CONFIG_LR11XX_USE_CRC_OVER_SPI)
 	// Compute the CRC over command array first and over data array then
 	uint8_t cmd_crc = lr11xx_hal_compute_crc(0xFF, command, command_length);
@@ -106,10 +245,50 @@ lr11xx_hal_status_t lr11xx_hal_write(const void *context,
 
 	const struct spi_buf_set tx = {.buffers = tx_buf, .count = ARRAY_SIZE(tx_buf)};
 
-	ret = spi_write_dt(&config->spi, &tx);
+	// Stat1 and Stat2 are shifted out with the opcode
+	uint8_t stat[2];
+	const struct spi_buf rx_buf = {.buf = stat, .len = MIN(command_length, sizeof(stat))};
+	const struct spi_buf_set rx = {.buffers = &rx_buf, .count = 1};
+
+#ifdef CONFIG_LORA_BASICS_MODEM_DRIVERS_BUS_LOCK
+	if ((command_length > 1) && (sys_get_be16(command) == LR11XX_HAL_SET_PKT_PARAM_OC)) {
+		lora_lbm_bus_sequence(&dev_data->bus, true);
+	}
+#endif /* CONFIG_LORA_BASICS_MODEM_DRIVERS_BUS_LOCK */
+
+	ret = lr11xx_hal_spi_transceive(dev, &tx, &rx);
+	lora_lbm_stats_on_spi(true, command_length + data_length, ret == 0);
 	if (ret) {
+		LORA_LBM_TRACE_END(lr11xx_write, LR11XX_HAL_STATUS_ERROR);
 		return LR11XX_HAL_STATUS_ERROR;
 	}
+	lr11xx_hal_update_stat(dev, stat, rx_buf.len);
+
+#ifdef CONFIG_LORA_BASICS_MODEM_DRIVERS_BUS_LOCK
+	if ((command_length > 1) && lr11xx_hal_is_sequence_end(sys_get_be16(command))) {
+		lora_lbm_bus_sequence(&dev_data->bus, false);
+	}
+#endif /* CONFIG_LORA_BASICS_MODEM_DRIVERS_BUS_LOCK */
+
+	if ((command_length > 1) && (sys_get_be16(command) == LR11XX_HAL_SET_TX_OC)) {
+		lora_lbm_stats_on_tx_start();
+	}
+
+#ifdef CONFIG_LR11XX_EVENT_LEVEL_TRIGGER
+	if ((command_length > 1) && lr11xx_hal_is_irq_serviced(sys_get_be16(command))) {
+		lr11xx_board_on_irq_clear(dev);
+	}
+#endif /* CONFIG_LR11XX_EVENT_LEVEL_TRIGGER */
+
+#ifdef CONFIG_LORA_BASICS_MODEM_DRIVERS_STATS
+	if ((command_length == 6) && (sys_get_be16(command) == LR11XX_HAL_CLEAR_IRQ_OC)) {
+		lora_lbm_stats_on_irq_clear(lr11xx_hal_stats_convert(sys_get_be32(&command[2])));
+	}
+#endif /* CONFIG_LORA_BASICS_MODEM_DRIVERS_STATS */
+
+#ifdef CONFIG_LORA_BASICS_MODEM_DRIVERS_ENERGY
+	lr11xx_energy_on_command(dev, command, command_length);
+#endif /* CONFIG_LORA_BASICS_MODEM_DRIVERS_ENERGY */
 
 	// LR11XX_SYSTEM_SET_SLEEP_OC=0x011B opcode.
 	// In sleep mode the radio busy line is held at 1 => do not test it
@@ -121,6 +300,7 @@ lr11xx_hal_status_t lr11xx_hal_write(const void *context,
 		k_sleep(K_USEC(500));
 	}
 
+	LORA_LBM_TRACE_END(lr11xx_write, LR11XX_HAL_STATUS_OK);
 	return LR11XX_HAL_STATUS_OK;
 }
 
@@ -128,9 +308,9 @@ lr11xx_hal_status_t lr11xx_hal_direct_read(const void *context,
 	uint8_t *data, const uint16_t data_length)
 {
 	const struct device *dev = (const struct device *)context;
-	const struct lr11xx_hal_context_cfg_t *config = dev->config;
 	int ret;
 
+	LORA_LBM_TRACE_BEGIN(lr11xx_read, data_length);
 #if defined(CONFIG_LR11XX_USE_CRC_OVER_SPI)
 	uint8_t rx_crc;
 #endif // defined( CONFIG_LR11XX_USE_CRC_OVER_SPI )
@@ -152,8 +332,10 @@ lr11xx_hal_status_t lr11xx_hal_direct_read(const void *context,
 
 	const struct spi_buf_set rx = {.buffers = rx_buf, .count = ARRAY_SIZE(rx_buf)};
 
-	ret = spi_read_dt(&config->spi, &rx);
+	ret = lr11xx_hal_spi_transceive(dev, NULL, &rx);
+	lora_lbm_stats_on_spi(false, data_length, ret == 0);
 	if (ret) {
+		LORA_LBM_TRACE_END(lr11xx_read, LR11XX_HAL_STATUS_ERROR);
 		return LR11XX_HAL_STATUS_ERROR;
 	}
 
@@ -161,10 +343,24 @@ lr11xx_hal_status_t lr11xx_hal_direct_read(const void *context,
 	// check crc value
 	uint8_t computed_crc = lr11xx_hal_compute_crc(0xFF, data, data_length);
 	if (rx_crc != computed_crc) {
+		LORA_LBM_TRACE_END(lr11xx_read, LR11XX_HAL_STATUS_ERROR);
 		return LR11XX_HAL_STATUS_ERROR;
 	}
 #endif // defined( CONFIG_LR11XX_USE_CRC_OVER_SPI )
 
+	// A direct read clocks out NOP opcodes, the response starts with Stat1 and Stat2
+	if (data_length > 0) {
+		lr11xx_hal_update_stat(dev, data, MIN(data_length, 2));
+	}
+
+#ifdef CONFIG_LORA_BASICS_MODEM_DRIVERS_STATS
+	// No opcode goes with a direct read, GetStatus is the only one of this length
+	if (data_length == LR11XX_HAL_GET_STATUS_LENGTH) {
+		lora_lbm_stats_on_irq_status(lr11xx_hal_stats_convert(sys_get_be32(&data[2])));
+	}
+#endif /* CONFIG_LORA_BASICS_MODEM_DRIVERS_STATS */
+
+	LORA_LBM_TRACE_END(lr11xx_read, LR11XX_HAL_STATUS_OK);
 	return LR11XX_HAL_STATUS_OK;
 }
 
@@ -173,9 +369,9 @@ lr11xx_hal_status_t lr11xx_hal_read(const void *context,
 	uint8_t *data, const uint16_t data_length)
 {
 	const struct device *dev = (const struct device *)context;
-	const struct lr11xx_hal_context_cfg_t *config = dev->config;
 	int ret;
 
+	LORA_LBM_TRACE_BEGIN(lr11xx_read, sys_get_be16(command));
 #if defined(CONFIG_LR11XX_USE_CRC_OVER_SPI)
 	// Compute the CRC over command array first and over data array then
 	uint8_t cmd_crc = lr11xx_hal_compute_crc(0xFF, command, command_length);
@@ -202,10 +398,18 @@ lr11xx_hal_status_t lr11xx_hal_read(const void *context,
 
 	const struct spi_buf_set tx = {.buffers = tx_buf, .count = ARRAY_SIZE(tx_buf)};
 
-	ret = spi_write_dt(&config->spi, &tx);
+	// Stat1 and Stat2 are shifted out with the opcode
+	uint8_t stat[2];
+	const struct spi_buf stat_buf = {.buf = stat, .len = MIN(command_length, sizeof(stat))};
+	const struct spi_buf_set stat_rx = {.buffers = &stat_buf, .count = 1};
+
+	ret = lr11xx_hal_spi_transceive(dev, &tx, &stat_rx);
+	lora_lbm_stats_on_spi(true, command_length, ret == 0);
 	if (ret) {
+		LORA_LBM_TRACE_END(lr11xx_read, LR11XX_HAL_STATUS_ERROR);
 		return LR11XX_HAL_STATUS_ERROR;
 	}
+	lr11xx_hal_update_stat(dev, stat, stat_buf.len);
 
 	if (data_length > 0) {
 		lr11xx_hal_check_device_ready(context);
@@ -213,7 +417,7 @@ lr11xx_hal_status_t lr11xx_hal_read(const void *context,
 		uint8_t dummy_byte;
 
 		const struct spi_buf rx_buf[] = {
-			// save dummy for crc calculation
+			// save dummy for crc calculation, it is Stat1
 			{
 				.buf = &dummy_byte,
 				.len = 1,
@@ -231,8 +435,10 @@ lr11xx_hal_status_t lr11xx_hal_read(const void *context,
 
 		const struct spi_buf_set rx = {.buffers = rx_buf, .count = ARRAY_SIZE(rx_buf)};
 
-		ret = spi_read_dt(&config->spi, &rx);
+		ret = lr11xx_hal_spi_transceive(dev, NULL, &rx);
+		lora_lbm_stats_on_spi(false, data_length, ret == 0);
 		if (ret) {
+			LORA_LBM_TRACE_END(lr11xx_read, LR11XX_HAL_STATUS_ERROR);
 			return LR11XX_HAL_STATUS_ERROR;
 		}
 
@@ -241,11 +447,14 @@ lr11xx_hal_status_t lr11xx_hal_read(const void *context,
 		uint8_t computed_crc = lr11xx_hal_compute_crc(0xFF, &dummy_byte, 1);
 		computed_crc = lr11xx_hal_compute_crc(computed_crc, data, data_length);
 		if (cmd_crc != computed_crc) {
+			LORA_LBM_TRACE_END(lr11xx_read, LR11XX_HAL_STATUS_ERROR);
 			return LR11XX_HAL_STATUS_ERROR;
 		}
 #endif // defined( CONFIG_LR11XX_USE_CRC_OVER_SPI )
+		lr11xx_hal_update_stat(dev, &dummy_byte, 1);
 	}
 
+	LORA_LBM_TRACE_END(lr11xx_read, LR11XX_HAL_STATUS_OK);
 	return LR11XX_HAL_STATUS_OK;
 }
 
@@ -262,7 +471,19 @@ lr11xx_hal_status_t lr11xx_hal_reset(const void *context)
 
 	// Wait 200ms until internal lr11xx fw is ready
 	k_sleep(K_MSEC(200));
+#ifdef CONFIG_LORA_BASICS_MODEM_DRIVERS_BUS_LOCK
+	// A sequence cut by the reset never gets its end command
+	lora_lbm_bus_sequence(&data->bus, false);
+#endif /* CONFIG_LORA_BASICS_MODEM_DRIVERS_BUS_LOCK */
 	data->radio_status = RADIO_AWAKE;
+	atomic_clear(&data->stat);
+#ifdef CONFIG_LR11XX_EVENT_LEVEL_TRIGGER
+	// The reset drops the IRQ status, and the event line with it
+	lr11xx_board_on_irq_clear(dev);
+#endif /* CONFIG_LR11XX_EVENT_LEVEL_TRIGGER */
+#ifdef CONFIG_LORA_BASICS_MODEM_DRIVERS_ENERGY
+	lr11xx_energy_on_wakeup(dev);
+#endif /* CONFIG_LORA_BASICS_MODEM_DRIVERS_ENERGY */
 
 	return LR11XX_HAL_STATUS_OK;
 }
@@ -274,9 +495,48 @@ lr11xx_hal_status_t lr11xx_hal_wakeup(const void *context)
 	return LR11XX_HAL_STATUS_OK;
 }
 
+int lora_transceiver_prewake(const struct device *dev)
+{
+	const struct lr11xx_hal_context_cfg_t *config = dev->config;
+	struct lr11xx_hal_context_data_t *data = dev->data;
+	int ret = 0;
+
+	if (data->radio_status != RADIO_SLEEP) {
+		return 0;
+	}
+
+	LORA_LBM_TRACE_BEGIN(lr11xx_prewake, 0);
+	lr11xx_hal_check_device_ready(dev);
+	// The chip wakes up in STDBY_RC, the TCXO only starts in STDBY_XOSC
+	if (config->tcxo_cfg.xosc_cfg == RAL_XOSC_CFG_TCXO_RADIO_CTRL) {
+		if (lr11xx_system_set_standby(dev, LR11XX_SYSTEM_STANDBY_CFG_XOSC) !=
+		    LR11XX_STATUS_OK) {
+			ret = -EIO;
+		}
+	}
+	LORA_LBM_TRACE_END(lr11xx_prewake, ret);
+	return ret;
+}
+
 lr11xx_hal_status_t lr11xx_hal_abort_blocking_cmd(const void *context)
 {
 	/* Send a dummy command to abort the ongoing command */
 	uint8_t abort_cmd[1] = {0x00};
 	return lr11xx_hal_write(context, abort_cmd, sizeof(abort_cmd), NULL, 0);
 }
+
+#ifdef CONFIG_LORA_BASICS_MODEM_DRIVERS_BUS_LOCK
+void lora_transceiver_transaction_begin(const struct device *dev)
+{
+	struct lr11xx_hal_context_data_t *data = dev->data;
+
+	lora_lbm_bus_begin(&data->bus);
+}
+
+int lora_transceiver_transaction_end(const struct device *dev)
+{
+	struct lr11xx_hal_context_data_t *data = dev->data;
+
+	return lora_lbm_bus_end(&data->bus);
+}
+#endif /* CONFIG_LORA_BASICS_MODEM_DRIVERS_BUS_LOCK */
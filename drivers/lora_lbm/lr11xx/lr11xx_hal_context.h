@@ -7,6 +7,7 @@
 #ifndef LR11XX_HAL_CONTEXT_H
 #define LR11XX_HAL_CONTEXT_H
 
+#include <errno.h>
 #include <stdint.h>
 #include <sys/_stdint.h>
 #include <zephyr/drivers/gpio.h>
@@ -14,8 +15,16 @@
 #include <zephyr/kernel.h>
 #include <ral_lr11xx_bsp.h>
 
+#include <lr11xx_radio_types.h>
 #include <lr11xx_system_types.h>
 
+#ifdef CONFIG_LORA_BASICS_MODEM_DRIVERS_ENERGY
+#include "lora_lbm_energy.h"
+#endif /* CONFIG_LORA_BASICS_MODEM_DRIVERS_ENERGY */
+#ifdef CONFIG_LORA_BASICS_MODEM_DRIVERS_BUS_LOCK
+#include "lora_lbm_bus.h"
+#endif /* CONFIG_LORA_BASICS_MODEM_DRIVERS_BUS_LOCK */
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -37,12 +46,52 @@ struct lr11xx_hal_context_lf_clck_cfg_t {
 	bool wait_32k_ready;
 };
 
-typedef struct lr11xx_pa_pwr_cfg_s
-{
-	int8_t  power;
-	uint8_t pa_duty_cycle;
-	uint8_t pa_hp_sel;
-} lr11xx_pa_pwr_cfg_t;
+#define LR11XX_PWR_VREG_VBAT_SWITCH 8
+
+#define LR11XX_MIN_PWR_LP_LF -17
+#define LR11XX_MAX_PWR_LP_LF 15
+
+#define LR11XX_MIN_PWR_HP_LF -9
+#define LR11XX_MAX_PWR_HP_LF 22
+
+#define LR11XX_MIN_PWR_PA_HF -18
+#define LR11XX_MAX_PWR_PA_HF 13
+
+/* Number of 1dBm steps of each PA, kept as literals for LISTIFY/FOR_EACH */
+#define LR11XX_LF_LP_TX_PWR_STEPS 33
+#define LR11XX_LF_HP_TX_PWR_STEPS 32
+#define LR11XX_HF_TX_PWR_STEPS 32
+
+#define LR11XX_RSSI_CALIBRATION_TUNE_LENGTH 17
+
+/**
+ * @brief Precomputed TX configuration for one expected output power
+ *
+ * Built at compile time from the devicetree tx-power-cfg-* cells and the current
+ * consumption estimates matching the devicetree regulator mode.
+ */
+struct lr11xx_hal_context_tx_pwr_cfg_t {
+	union {
+		struct {
+			int8_t power; /* Chip output power to configure */
+			uint8_t pa_duty_cycle;
+			uint8_t pa_hp_sel;
+		};
+		int8_t dt_cell[3]; /* <power pa_duty_cycle pa_hp_sel> devicetree cell */
+	};
+	uint8_t pa_reg_supply; /* lr11xx_radio_pa_reg_supply_t */
+	uint32_t consumption_ua; /* Estimated TX current, 0 if unknown */
+};
+
+/**
+ * @brief TX power tables of all power amplifiers, indexed by dBm from the PA minimum
+ *
+ */
+struct lr11xx_hal_context_tx_pwr_table_t {
+	struct lr11xx_hal_context_tx_pwr_cfg_t lf_lp[LR11XX_LF_LP_TX_PWR_STEPS];
+	struct lr11xx_hal_context_tx_pwr_cfg_t lf_hp[LR11XX_LF_HP_TX_PWR_STEPS];
+	struct lr11xx_hal_context_tx_pwr_cfg_t hf[LR11XX_HF_TX_PWR_STEPS];
+};
 
 /**
  * @brief lr11xx context device config structure
@@ -67,10 +116,7 @@ struct lr11xx_hal_context_cfg_t {
 	bool rx_boosted; /* RXBoosted option */
 
 	uint8_t tx_offset; /* Board TX power offset */
-	/* Calibration tables are stored as uint8_t because device tree provides them as flat arrays */
-	lr11xx_pa_pwr_cfg_t *pa_lf_lp_cfg_table; /* Power amplifier configuration for Low frequency / Low power */
-	lr11xx_pa_pwr_cfg_t *pa_lf_hp_cfg_table; /* Power amplifier configuration for Low frequency / High power */
-	lr11xx_pa_pwr_cfg_t *pa_hf_cfg_table; /* Power amplifier configuration for High frequency */
+	struct lr11xx_hal_context_tx_pwr_table_t tx_pwr_table; /* PA configurations and consumptions */
 	lr11xx_radio_rssi_calibration_table_t rssi_calibration_table_below_600mhz;
 	lr11xx_radio_rssi_calibration_table_t rssi_calibration_table_from_600mhz_to_2ghz;
 	lr11xx_radio_rssi_calibration_table_t rssi_calibration_table_above_2ghz;
@@ -95,11 +141,135 @@ struct lr11xx_hal_context_data_t {
 	struct k_thread thread;
 	struct k_sem trig_sem;
 #endif /* CONFIG_LORA_BASICS_MODEM_DRIVERS_EVENT_TRIGGER_OWN_THREAD */
+#ifdef CONFIG_LR11XX_EVENT_LEVEL_TRIGGER
+	struct k_spinlock irq_lock;
+	bool irq_enabled; /* Interrupt enabled by lora_transceiver_board_enable_interrupt */
+	bool irq_pending; /* Interrupt masked until the HAL clears the IRQ status */
+#endif /* CONFIG_LR11XX_EVENT_LEVEL_TRIGGER */
 #endif /* CONFIG_LORA_BASICS_MODEM_DRIVERS_EVENT_TRIGGER */
 	radio_sleep_status_t radio_status;
+	atomic_t stat; /* Stat1 and Stat2 of the last transfer, see lr11xx_hal_context_get_stat */
 	uint8_t tx_offset; /* Board TX power offset */
+#ifdef CONFIG_LORA_BASICS_MODEM_DRIVERS_ENERGY
+	struct lora_lbm_energy energy;
+	bool energy_gfsk;          /* Last packet type set is GFSK */
+	bool energy_rx_continuous; /* Ongoing reception has no timeout */
+#endif /* CONFIG_LORA_BASICS_MODEM_DRIVERS_ENERGY */
+#ifdef CONFIG_LORA_BASICS_MODEM_DRIVERS_BUS_LOCK
+	struct lora_lbm_bus bus;
+#endif /* CONFIG_LORA_BASICS_MODEM_DRIVERS_BUS_LOCK */
 };
 
+/**
+ * @brief Get the precomputed TX configuration of a power amplifier
+ *
+ * @param config lr11xx device configuration
+ * @param pa_sel Power amplifier
+ * @param power Expected output power in dBm, clamped to the PA range
+ * @return Table entry, or NULL if the PA is unknown
+ */
+static inline const struct lr11xx_hal_context_tx_pwr_cfg_t *
+lr11xx_hal_context_get_tx_pwr_cfg(const struct lr11xx_hal_context_cfg_t *config,
+				  lr11xx_radio_pa_selection_t pa_sel, int16_t power)
+{
+	const struct lr11xx_hal_context_tx_pwr_table_t *table = &config->tx_pwr_table;
+
+	switch (pa_sel) {
+	case LR11XX_RADIO_PA_SEL_LP:
+		power = CLAMP(power, LR11XX_MIN_PWR_LP_LF, LR11XX_MAX_PWR_LP_LF);
+		return &table->lf_lp[power - LR11XX_MIN_PWR_LP_LF];
+	case LR11XX_RADIO_PA_SEL_HP:
+		power = CLAMP(power, LR11XX_MIN_PWR_HP_LF, LR11XX_MAX_PWR_HP_LF);
+		return &table->lf_hp[power - LR11XX_MIN_PWR_HP_LF];
+	case LR11XX_RADIO_PA_SEL_HF:
+		power = CLAMP(power, LR11XX_MIN_PWR_PA_HF, LR11XX_MAX_PWR_PA_HF);
+		return &table->hf[power - LR11XX_MIN_PWR_PA_HF];
+	default:
+		return NULL;
+	}
+}
+
+/* Layout of lr11xx_hal_context_data_t.stat */
+#define LR11XX_HAL_CONTEXT_STAT2_MASK  0x00FF
+#define LR11XX_HAL_CONTEXT_STAT1_SHIFT 8
+#define LR11XX_HAL_CONTEXT_STAT1_MASK  0xFF00
+#define LR11XX_HAL_CONTEXT_STAT_VALID  BIT(16)
+
+/**
+ * @brief Get the status bytes the chip returned on the last SPI transfer
+ *
+ * The LR11xx shifts out Stat1 and Stat2 while receiving every command, and Stat1 before every
+ * response. The HAL keeps them, so the command status, the IRQ pending flag and the chip mode
+ * are known without a GetStatus round trip. Stat1 reflects the command preceding the transfer.
+ *
+ * @param dev lr11xx device
+ * @param stat1 Decoded Stat1, can be NULL
+ * @param stat2 Decoded Stat2, can be NULL
+ * @retval 0 on success
+ * @retval -ENODATA if no transfer happened since the reset
+ */
+static inline int lr11xx_hal_context_get_stat(const struct device *dev,
+					      lr11xx_system_stat1_t *stat1,
+					      lr11xx_system_stat2_t *stat2)
+{
+	struct lr11xx_hal_context_data_t *data = dev->data;
+	atomic_val_t stat = atomic_get(&data->stat);
+	uint8_t raw;
+
+	if (!(stat & LR11XX_HAL_CONTEXT_STAT_VALID)) {
+		return -ENODATA;
+	}
+	if (stat1 != NULL) {
+		raw = (stat & LR11XX_HAL_CONTEXT_STAT1_MASK) >> LR11XX_HAL_CONTEXT_STAT1_SHIFT;
+		stat1->is_interrupt_active = (raw & 0x01) != 0;
+		stat1->command_status = (lr11xx_system_command_status_t)((raw >> 1) & 0x07);
+	}
+	if (stat2 != NULL) {
+		raw = stat & LR11XX_HAL_CONTEXT_STAT2_MASK;
+		stat2->is_running_from_flash = (raw & 0x01) != 0;
+		stat2->chip_mode = (lr11xx_system_chip_modes_t)((raw >> 1) & 0x07);
+		stat2->reset_status = (lr11xx_system_reset_status_t)((raw >> 4) & 0x0F);
+	}
+	return 0;
+}
+
+/**
+ * @brief Check the IRQ pending flag of the last Stat1, without SPI transfer
+ *
+ * @param dev lr11xx device
+ * @return true when the chip reported an active IRQ on the last transfer
+ */
+static inline bool lr11xx_hal_context_is_irq_pending(const struct device *dev)
+{
+	lr11xx_system_stat1_t stat1;
+
+	return (lr11xx_hal_context_get_stat(dev, &stat1, NULL) == 0) && stat1.is_interrupt_active;
+}
+
+#ifdef CONFIG_LR11XX_EVENT_LEVEL_TRIGGER
+/**
+ * @brief Unmask the level triggered event interrupt, called by the HAL when clearing the IRQ
+ * status, on a standby or sleep, on a reset and when Stat1 reports no IRQ anymore
+ *
+ * @param dev lr11xx device
+ */
+void lr11xx_board_on_irq_clear(const struct device *dev);
+#endif /* CONFIG_LR11XX_EVENT_LEVEL_TRIGGER */
+
+#ifdef CONFIG_LORA_BASICS_MODEM_DRIVERS_ENERGY
+/**
+ * @brief Energy accounting hooks, called by the HAL and the board
+ *
+ */
+void lr11xx_energy_init(const struct device *dev);
+void lr11xx_energy_set_tx_cfg(const void *context,
+	const ral_lr11xx_bsp_tx_cfg_output_params_t *tx_cfg);
+void lr11xx_energy_on_command(const struct device *dev, const uint8_t *command,
+	uint16_t command_length);
+void lr11xx_energy_on_wakeup(const struct device *dev);
+void lr11xx_energy_on_event(const struct device *dev);
+#endif /* CONFIG_LORA_BASICS_MODEM_DRIVERS_ENERGY */
+
 #ifdef __cplusplus
 }
 #endif
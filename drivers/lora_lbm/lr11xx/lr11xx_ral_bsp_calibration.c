@@ -9,103 +9,62 @@
 #include "radio_utilities.h"
 #include "lr11xx_hal_context.h"
 
+/* LF values match the LR11XX_TX_PATH_* constants used by the lf-tx-path property */
 typedef enum lr11xx_pa_type_s
 {
-	LR11XX_WITH_LF_LP_PA,
-	LR11XX_WITH_LF_HP_PA,
-	LR11XX_WITH_LF_LP_HP_PA,
+	LR11XX_WITH_LF_LP_PA = 0,
+	LR11XX_WITH_LF_HP_PA = 1,
+	LR11XX_WITH_LF_LP_HP_PA = 2,
 	LR11XX_WITH_HF_PA,
 } lr11xx_pa_type_t;
 
 
-#define LR11XX_PWR_VREG_VBAT_SWITCH 8
-
-#define LR11XX_MIN_PWR_LP_LF -17
-#define LR11XX_MAX_PWR_LP_LF 15
-
-#define LR11XX_MIN_PWR_HP_LF -9
-#define LR11XX_MAX_PWR_HP_LF 22
-
-#define LR11XX_MIN_PWR_PA_HF -18
-#define LR11XX_MAX_PWR_PA_HF 13
-
-#define LR11XX_RSSI_CALIBRATION_TUNE_LENGTH 17
-
-
 static void lr11xx_get_tx_cfg(const void *context,
-	lr11xx_pa_type_t pa_type, int8_t expected_output_pwr_in_dbm,
+	lr11xx_pa_type_t pa_type, int16_t expected_output_pwr_in_dbm,
 	ral_lr11xx_bsp_tx_cfg_output_params_t* output_params)
 {
 	const struct device *dev = (const struct device *)context;
 	const struct lr11xx_hal_context_cfg_t *config = dev->config;
+	const struct lr11xx_hal_context_tx_pwr_cfg_t *tx_pwr_cfg;
+	lr11xx_radio_pa_selection_t pa_sel;
 
-	int8_t power = expected_output_pwr_in_dbm;
-
-	// Ramp time is the same for any config
-	output_params->pa_ramp_time = LR11XX_RADIO_RAMP_48_US;
+	int16_t power = expected_output_pwr_in_dbm;
 
 	switch(pa_type) {
-	case LR11XX_WITH_LF_LP_PA: {
+	case LR11XX_WITH_LF_LP_PA:
 		// Check power boundaries for LP LF PA: The output power must be in range [ -17 , +15 ] dBm
 		power = CLAMP(power, LR11XX_MIN_PWR_LP_LF, LR11XX_MAX_PWR_LP_LF);
-		output_params->pa_cfg.pa_sel                     = LR11XX_RADIO_PA_SEL_LP;
-		output_params->pa_cfg.pa_reg_supply              = LR11XX_RADIO_PA_REG_SUPPLY_VREG;
-		output_params->pa_cfg.pa_duty_cycle              = config->pa_lf_lp_cfg_table[power - LR11XX_MIN_PWR_LP_LF].pa_duty_cycle;
-		output_params->pa_cfg.pa_hp_sel                  = config->pa_lf_lp_cfg_table[power - LR11XX_MIN_PWR_LP_LF].pa_hp_sel;
-		output_params->chip_output_pwr_in_dbm_configured = config->pa_lf_lp_cfg_table[power - LR11XX_MIN_PWR_LP_LF].power;
-		output_params->chip_output_pwr_in_dbm_expected   = power;
+		pa_sel = LR11XX_RADIO_PA_SEL_LP;
 		break;
-	}
-	case LR11XX_WITH_LF_HP_PA: {
+	case LR11XX_WITH_LF_HP_PA:
 		// Check power boundaries for HP LF PA: The output power must be in range [ -9 , +22 ] dBm
 		power = CLAMP(power, LR11XX_MIN_PWR_HP_LF, LR11XX_MAX_PWR_HP_LF);
-		output_params->pa_cfg.pa_sel                   = LR11XX_RADIO_PA_SEL_HP;
-		output_params->chip_output_pwr_in_dbm_expected = power;
-
-		if (power <= LR11XX_PWR_VREG_VBAT_SWITCH) {
-			// For powers below 8dBm use regulated supply for HP PA for a better efficiency.
-			output_params->pa_cfg.pa_reg_supply = LR11XX_RADIO_PA_REG_SUPPLY_VREG;
-		} else {
-			output_params->pa_cfg.pa_reg_supply = LR11XX_RADIO_PA_REG_SUPPLY_VBAT;
-		}
-
-		output_params->pa_cfg.pa_duty_cycle              = config->pa_lf_hp_cfg_table[power - LR11XX_MIN_PWR_HP_LF].pa_duty_cycle;
-		output_params->pa_cfg.pa_hp_sel                  = config->pa_lf_hp_cfg_table[power - LR11XX_MIN_PWR_HP_LF].pa_hp_sel;
-		output_params->chip_output_pwr_in_dbm_configured = config->pa_lf_hp_cfg_table[power - LR11XX_MIN_PWR_HP_LF].power;
+		pa_sel = LR11XX_RADIO_PA_SEL_HP;
 		break;
-	}
-	case LR11XX_WITH_LF_LP_HP_PA: {
+	case LR11XX_WITH_LF_LP_HP_PA:
 		// Check power boundaries for LP/HP LF PA: The output power must be in range [ -17 , +22 ] dBm
 		power = CLAMP(power, LR11XX_MIN_PWR_LP_LF, LR11XX_MAX_PWR_HP_LF);
-		output_params->chip_output_pwr_in_dbm_expected = power;
-
-		if (power <= LR11XX_MAX_PWR_LP_LF) {
-			output_params->pa_cfg.pa_sel        = LR11XX_RADIO_PA_SEL_LP;
-			output_params->pa_cfg.pa_reg_supply = LR11XX_RADIO_PA_REG_SUPPLY_VREG;
-			output_params->pa_cfg.pa_duty_cycle = config->pa_lf_lp_cfg_table[power - LR11XX_MIN_PWR_LP_LF].pa_duty_cycle;
-			output_params->pa_cfg.pa_hp_sel     = config->pa_lf_lp_cfg_table[power - LR11XX_MIN_PWR_LP_LF].pa_hp_sel;
-			output_params->chip_output_pwr_in_dbm_configured = config->pa_lf_lp_cfg_table[power - LR11XX_MIN_PWR_LP_LF].power;
-		} else {
-			output_params->pa_cfg.pa_sel        = LR11XX_RADIO_PA_SEL_HP;
-			output_params->pa_cfg.pa_reg_supply = LR11XX_RADIO_PA_REG_SUPPLY_VBAT;
-			output_params->pa_cfg.pa_duty_cycle = config->pa_lf_hp_cfg_table[power - LR11XX_MIN_PWR_HP_LF].pa_duty_cycle;
-			output_params->pa_cfg.pa_hp_sel     = config->pa_lf_hp_cfg_table[power - LR11XX_MIN_PWR_HP_LF].pa_hp_sel;
-			output_params->chip_output_pwr_in_dbm_configured = config->pa_lf_hp_cfg_table[power - LR11XX_MIN_PWR_HP_LF].power;
-		}
+		pa_sel = (power <= LR11XX_MAX_PWR_LP_LF) ? LR11XX_RADIO_PA_SEL_LP : LR11XX_RADIO_PA_SEL_HP;
 		break;
-	}
-	case LR11XX_WITH_HF_PA: {
+	case LR11XX_WITH_HF_PA:
+	default:
 		// Check power boundaries for HF PA: The output power must be in range [ -18 , +13 ] dBm
 		power = CLAMP(power, LR11XX_MIN_PWR_PA_HF, LR11XX_MAX_PWR_PA_HF);
-		output_params->pa_cfg.pa_sel                     = LR11XX_RADIO_PA_SEL_HF;
-		output_params->pa_cfg.pa_reg_supply              = LR11XX_RADIO_PA_REG_SUPPLY_VREG;
-		output_params->pa_cfg.pa_duty_cycle              = config->pa_hf_cfg_table[power - LR11XX_MIN_PWR_PA_HF].pa_duty_cycle;
-		output_params->pa_cfg.pa_hp_sel                  = config->pa_hf_cfg_table[power - LR11XX_MIN_PWR_PA_HF].pa_hp_sel;
-		output_params->chip_output_pwr_in_dbm_configured = config->pa_hf_cfg_table[power - LR11XX_MIN_PWR_PA_HF].power;
-		output_params->chip_output_pwr_in_dbm_expected   = power;
+		pa_sel = LR11XX_RADIO_PA_SEL_HF;
 		break;
 	}
-	}
+
+	// Supply, duty cycle and HP selection are all precomputed in the device TX power table
+	tx_pwr_cfg = lr11xx_hal_context_get_tx_pwr_cfg(config, pa_sel, power);
+
+	// Ramp time is the same for any config
+	output_params->pa_ramp_time                      = LR11XX_RADIO_RAMP_48_US;
+	output_params->pa_cfg.pa_sel                     = pa_sel;
+	output_params->pa_cfg.pa_reg_supply              = tx_pwr_cfg->pa_reg_supply;
+	output_params->pa_cfg.pa_duty_cycle              = tx_pwr_cfg->pa_duty_cycle;
+	output_params->pa_cfg.pa_hp_sel                  = tx_pwr_cfg->pa_hp_sel;
+	output_params->chip_output_pwr_in_dbm_configured = tx_pwr_cfg->power;
+	output_params->chip_output_pwr_in_dbm_expected   = power;
 }
 
 void ral_lr11xx_bsp_get_tx_cfg(const void* context,
@@ -117,6 +76,8 @@ void ral_lr11xx_bsp_get_tx_cfg(const void* context,
 
 	int16_t power = input_params->system_output_pwr_in_dbm + board_tx_pwr_offset_db;
 
+	const struct device *dev = (const struct device *)context;
+	const struct lr11xx_hal_context_cfg_t *config = dev->config;
 	lr11xx_pa_type_t pa_type;
 
 	// check frequency band first to choose LF of HF PA
@@ -126,12 +87,17 @@ void ral_lr11xx_bsp_get_tx_cfg(const void* context,
 	}
 	else
 	{
-		// Modem is acting in subgig band: use LP/HP PA (both LP and HP are connected on lr11xx evk board)
-		pa_type = LR11XX_WITH_LF_LP_HP_PA;
+		// Modem is acting in subgig band: use the LF PAs placed on the board (lf-tx-path)
+		pa_type = (lr11xx_pa_type_t)config->lf_tx_path_options;
 	}
 
 	// call the configuration function
 	lr11xx_get_tx_cfg(context, pa_type, power, output_params);
+
+#ifdef CONFIG_LORA_BASICS_MODEM_DRIVERS_ENERGY
+	// the radio planner computes the TX configuration right before each transmission
+	lr11xx_energy_set_tx_cfg(context, output_params);
+#endif // CONFIG_LORA_BASICS_MODEM_DRIVERS_ENERGY
 }
 
 
@@ -0,0 +1,193 @@
+/*
+ * Copyright (c) 2024 Semtech Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef LR11XX_TX_PWR_CONSUMPTION_H
+#define LR11XX_TX_PWR_CONSUMPTION_H
+
+/*
+ * Estimated radio current consumption in TX, in uA, one value per dBm of expected
+ * output power. These lists are expanded at build time into the per-device TX
+ * power table, see LR11XX_TX_PWR_TABLE in lr11xx_board.c.
+ */
+
+/* DC-DC regulator, low frequency low power PA on VREG, from -17dBm to +15dBm */
+#define LR11XX_TX_PWR_UA_DCDC_LF_LP \
+	10820,  /* -17 dBm */ \
+	10980,  /* -16 dBm */ \
+	11060,  /* -15 dBm */ \
+	11160,  /* -14 dBm */ \
+	11300,  /* -13 dBm */ \
+	11430,  /* -12 dBm */ \
+	11550,  /* -11 dBm */ \
+	11680,  /* -10 dBm */ \
+	11930,  /*  -9 dBm */ \
+	12170,  /*  -8 dBm */ \
+	12420,  /*  -7 dBm */ \
+	12650,  /*  -6 dBm */ \
+	12900,  /*  -5 dBm */ \
+	13280,  /*  -4 dBm */ \
+	13600,  /*  -3 dBm */ \
+	14120,  /*  -2 dBm */ \
+	14600,  /*  -1 dBm */ \
+	15090,  /*   0 dBm */ \
+	15780,  /*   1 dBm */ \
+	16490,  /*   2 dBm */ \
+	17250,  /*   3 dBm */ \
+	17850,  /*   4 dBm */ \
+	18720,  /*   5 dBm */ \
+	19640,  /*   6 dBm */ \
+	20560,  /*   7 dBm */ \
+	21400,  /*   8 dBm */ \
+	22620,  /*   9 dBm */ \
+	23720,  /*  10 dBm */ \
+	25050,  /*  11 dBm */ \
+	26350,  /*  12 dBm */ \
+	27870,  /*  13 dBm */ \
+	28590,  /*  14 dBm */ \
+	37820   /*  15 dBm */
+
+/* LDO regulator, low frequency low power PA on VREG, from -17dBm to +15dBm */
+#define LR11XX_TX_PWR_UA_LDO_LF_LP \
+	14950,  /* -17 dBm */ \
+	15280,  /* -16 dBm */ \
+	15530,  /* -15 dBm */ \
+	15770,  /* -14 dBm */ \
+	16020,  /* -13 dBm */ \
+	16290,  /* -12 dBm */ \
+	16550,  /* -11 dBm */ \
+	16760,  /* -10 dBm */ \
+	17280,  /*  -9 dBm */ \
+	17770,  /*  -8 dBm */ \
+	18250,  /*  -7 dBm */ \
+	18750,  /*  -6 dBm */ \
+	19250,  /*  -5 dBm */ \
+	19960,  /*  -4 dBm */ \
+	20710,  /*  -3 dBm */ \
+	21620,  /*  -2 dBm */ \
+	22570,  /*  -1 dBm */ \
+	23570,  /*   0 dBm */ \
+	24990,  /*   1 dBm */ \
+	26320,  /*   2 dBm */ \
+	27830,  /*   3 dBm */ \
+	29070,  /*   4 dBm */ \
+	30660,  /*   5 dBm */ \
+	32490,  /*   6 dBm */ \
+	34220,  /*   7 dBm */ \
+	35820,  /*   8 dBm */ \
+	38180,  /*   9 dBm */ \
+	40220,  /*  10 dBm */ \
+	42800,  /*  11 dBm */ \
+	45030,  /*  12 dBm */ \
+	47900,  /*  13 dBm */ \
+	51220,  /*  14 dBm */ \
+	66060   /*  15 dBm */
+
+/* DC-DC regulator, low frequency high power PA on VBAT, from -9dBm to +22dBm */
+#define LR11XX_TX_PWR_UA_DCDC_LF_HP \
+	27750,  /*  -9 dBm */ \
+	29100,  /*  -8 dBm */ \
+	30320,  /*  -7 dBm */ \
+	31650,  /*  -6 dBm */ \
+	34250,  /*  -5 dBm */ \
+	35550,  /*  -4 dBm */ \
+	36770,  /*  -3 dBm */ \
+	39250,  /*  -2 dBm */ \
+	41480,  /*  -1 dBm */ \
+	43820,  /*   0 dBm */ \
+	46000,  /*   1 dBm */ \
+	49020,  /*   2 dBm */ \
+	50900,  /*   3 dBm */ \
+	54200,  /*   4 dBm */ \
+	56330,  /*   5 dBm */ \
+	59050,  /*   6 dBm */ \
+	62210,  /*   7 dBm */ \
+	65270,  /*   8 dBm */ \
+	68600,  /*   9 dBm */ \
+	71920,  /*  10 dBm */ \
+	75500,  /*  11 dBm */ \
+	79500,  /*  12 dBm */ \
+	84130,  /*  13 dBm */ \
+	88470,  /*  14 dBm */ \
+	92200,  /*  15 dBm */ \
+	94340,  /*  16 dBm */ \
+	96360,  /*  17 dBm */ \
+	98970,  /*  18 dBm */ \
+	102220, /*  19 dBm */ \
+	106250, /*  20 dBm */ \
+	111300, /*  21 dBm */ \
+	113040  /*  22 dBm */
+
+/* LDO regulator, low frequency high power PA on VBAT, from -9dBm to +22dBm */
+#define LR11XX_TX_PWR_UA_LDO_LF_HP \
+	31310,  /*  -9 dBm */ \
+	32700,  /*  -8 dBm */ \
+	33970,  /*  -7 dBm */ \
+	35270,  /*  -6 dBm */ \
+	37900,  /*  -5 dBm */ \
+	39140,  /*  -4 dBm */ \
+	40380,  /*  -3 dBm */ \
+	42860,  /*  -2 dBm */ \
+	45150,  /*  -1 dBm */ \
+	47400,  /*   0 dBm */ \
+	49600,  /*   1 dBm */ \
+	52600,  /*   2 dBm */ \
+	54460,  /*   3 dBm */ \
+	57690,  /*   4 dBm */ \
+	59840,  /*   5 dBm */ \
+	62550,  /*   6 dBm */ \
+	65750,  /*   7 dBm */ \
+	68520,  /*   8 dBm */ \
+	72130,  /*   9 dBm */ \
+	75230,  /*  10 dBm */ \
+	78600,  /*  11 dBm */ \
+	82770,  /*  12 dBm */ \
+	87450,  /*  13 dBm */ \
+	91700,  /*  14 dBm */ \
+	95330,  /*  15 dBm */ \
+	97520,  /*  16 dBm */ \
+	99520,  /*  17 dBm */ \
+	102080, /*  18 dBm */ \
+	105140, /*  19 dBm */ \
+	109300, /*  20 dBm */ \
+	114460, /*  21 dBm */ \
+	116530  /*  22 dBm */
+
+/* DC-DC regulator, high frequency PA on VREG, from -18dBm to +13dBm */
+#define LR11XX_TX_PWR_UA_DCDC_HF \
+	11800,  /* -18 dBm */ \
+	11800,  /* -17 dBm */ \
+	11800,  /* -16 dBm */ \
+	11900,  /* -15 dBm */ \
+	12020,  /* -14 dBm */ \
+	12120,  /* -13 dBm */ \
+	12230,  /* -12 dBm */ \
+	12390,  /* -11 dBm */ \
+	12540,  /* -10 dBm */ \
+	12740,  /*  -9 dBm */ \
+	12960,  /*  -8 dBm */ \
+	13150,  /*  -7 dBm */ \
+	13460,  /*  -6 dBm */ \
+	13770,  /*  -5 dBm */ \
+	14070,  /*  -4 dBm */ \
+	14460,  /*  -3 dBm */ \
+	15030,  /*  -2 dBm */ \
+	15440,  /*  -1 dBm */ \
+	16030,  /*   0 dBm */ \
+	16980,  /*   1 dBm */ \
+	17590,  /*   2 dBm */ \
+	18270,  /*   3 dBm */ \
+	19060,  /*   4 dBm */ \
+	19900,  /*   5 dBm */ \
+	20740,  /*   6 dBm */ \
+	21610,  /*   7 dBm */ \
+	22400,  /*   8 dBm */ \
+	23370,  /*   9 dBm */ \
+	24860,  /*  10 dBm */ \
+	26410,  /*  11 dBm */ \
+	26430,  /*  12 dBm */ \
+	27890   /*  13 dBm */
+
+#endif /* LR11XX_TX_PWR_CONSUMPTION_H */
@@ -8,52 +8,120 @@
 #include <zephyr/devicetree.h>
 #include <zephyr/drivers/gpio.h>
 #include <zephyr/drivers/spi.h>
+#include <zephyr/irq.h>
 #include <zephyr/kernel.h>
 #include <zephyr/pm/device.h>
 
+#ifdef CONFIG_SEMTECH_SX126X_STM32WL
+#include <soc.h>
+#endif /* CONFIG_SEMTECH_SX126X_STM32WL */
+
 #include <zephyr/logging/log.h>
 LOG_MODULE_REGISTER(sx126x_board, CONFIG_LORA_BASICS_MODEM_DRIVERS_LOG_LEVEL);
 
 #include "lora_lbm_transceiver.h"
 #include "sx126x_hal_context.h"
+#include "sx126x_tx_pwr_consumption.h"
 
 #define SX126X_SPI_OPERATION (SPI_WORD_SET(8) | SPI_OP_MODE_MASTER | SPI_TRANSFER_MSB)
 
+#if defined(CONFIG_LORA_BASICS_MODEM_DRIVERS_EVENT_TRIGGER) ||                                  \
+	defined(CONFIG_SEMTECH_SX126X_STM32WL)
 /**
- * @brief Event pin callback handler.
+ * @brief Dispatch a radio event to the trigger mode
  *
- * @param dev
- * @param cb
- * @param pins
+ * @param data
  */
-static void sx126x_board_event_callback(
-	const struct device *dev, struct gpio_callback *cb, uint32_t pins, struct sx126x_hal_context_data_t *data)
+static void sx126x_board_on_event(struct sx126x_hal_context_data_t *data)
 {
-	// This code expects to always use EDGE interrupt triggers (so no possible duplicate triggers)
+#ifdef CONFIG_LORA_BASICS_MODEM_DRIVERS_ENERGY
+	sx126x_energy_on_event(data->sx126x_dev);
+#endif /* CONFIG_LORA_BASICS_MODEM_DRIVERS_ENERGY */
 
 	/* Call provided callback */
 #ifdef CONFIG_LORA_BASICS_MODEM_DRIVERS_EVENT_TRIGGER_OWN_THREAD
-	k_sem_give(&data->gpio_sem);
-#elif CONFIG_LORA_BASICS_MODEM_DRIVERS_EVENT_TRIGGER_GLOBAL_THREAD
+	k_sem_give(&data->trig_sem);
+#elif defined(CONFIG_LORA_BASICS_MODEM_DRIVERS_EVENT_TRIGGER_GLOBAL_THREAD)
 	k_work_submit(&data->work);
+#elif defined(CONFIG_LORA_BASICS_MODEM_DRIVERS_EVENT_TRIGGER_ISR)
+	if (data->event_interrupt_cb) {
+		data->event_interrupt_cb(data->sx126x_dev);
+	}
 #endif
 }
+#endif /* CONFIG_LORA_BASICS_MODEM_DRIVERS_EVENT_TRIGGER || CONFIG_SEMTECH_SX126X_STM32WL */
+
+#ifdef CONFIG_LORA_BASICS_MODEM_DRIVERS_EVENT_TRIGGER
+/**
+ * @brief Event pin callback handler.
+ *
+ * @param data
+ * @param dio DIO line that fired
+ */
+static void sx126x_board_event_callback(struct sx126x_hal_context_data_t *data, unsigned int dio)
+{
+	atomic_or(&data->dio_fired, BIT(dio));
+	// This code expects to always use EDGE interrupt triggers (so no possible duplicate triggers)
+	sx126x_board_on_event(data);
+}
+#endif /* CONFIG_LORA_BASICS_MODEM_DRIVERS_EVENT_TRIGGER */
+
+#if defined(CONFIG_LORA_BASICS_MODEM_DRIVERS_EVENT_TRIGGER_OWN_THREAD) ||                        \
+	defined(CONFIG_LORA_BASICS_MODEM_DRIVERS_EVENT_TRIGGER_GLOBAL_THREAD)
+/**
+ * @brief Service a radio event, in the trigger mode context
+ *
+ * @param data
+ */
+static void sx126x_board_process(struct sx126x_hal_context_data_t *data)
+{
+	if (data->event_interrupt_cb) {
+		data->event_interrupt_cb(data->sx126x_dev);
+	}
+}
+#endif /* CONFIG_LORA_BASICS_MODEM_DRIVERS_EVENT_TRIGGER_OWN_THREAD || _GLOBAL_THREAD */
+
+#ifdef CONFIG_SEMTECH_SX126X_STM32WL
+/**
+ * @brief STM32WL radio interrupt handler, straight from the NVIC
+ *
+ * @param arg device
+ */
+static void sx126x_stm32wl_board_isr(const void *arg)
+{
+	const struct device *dev = arg;
+
+	// The radio interrupt is level triggered: mask it until the HAL clears the IRQ status
+	irq_disable(DT_IRQN(SX126X_STM32WL_NODE));
+	sx126x_board_on_event(dev->data);
+}
+
+void sx126x_stm32wl_board_on_irq_clear(const struct device *dev)
+{
+	struct sx126x_hal_context_data_t *data = dev->data;
+
+	if (data->irq_enabled) {
+		NVIC_ClearPendingIRQ(DT_IRQN(SX126X_STM32WL_NODE));
+		irq_enable(DT_IRQN(SX126X_STM32WL_NODE));
+	}
+}
+#endif /* CONFIG_SEMTECH_SX126X_STM32WL */
 
 #ifdef CONFIG_LORA_BASICS_MODEM_DRIVERS_EVENT_TRIGGER
 static void sx126x_board_dio1_callback(const struct device *dev, struct gpio_callback *cb, uint32_t pins)
 {
 	struct sx126x_hal_context_data_t *data = CONTAINER_OF(cb, struct sx126x_hal_context_data_t, dio1_cb);
-	return sx126x_board_event_callback(dev, cb, pins, data);
+	sx126x_board_event_callback(data, 1);
 }
 static void sx126x_board_dio2_callback(const struct device *dev, struct gpio_callback *cb, uint32_t pins)
 {
 	struct sx126x_hal_context_data_t *data = CONTAINER_OF(cb, struct sx126x_hal_context_data_t, dio2_cb);
-	return sx126x_board_event_callback(dev, cb, pins, data);
+	sx126x_board_event_callback(data, 2);
 }
 static void sx126x_board_dio3_callback(const struct device *dev, struct gpio_callback *cb, uint32_t pins)
 {
 	struct sx126x_hal_context_data_t *data = CONTAINER_OF(cb, struct sx126x_hal_context_data_t, dio3_cb);
-	return sx126x_board_event_callback(dev, cb, pins, data);
+	sx126x_board_event_callback(data, 3);
 }
 #endif
 
@@ -61,10 +129,8 @@ static void sx126x_board_dio3_callback(const struct device *dev, struct gpio_cal
 static void sx126x_thread(struct sx126x_hal_context_data_t *data)
 {
 	while (1) {
-		k_sem_take(&data->gpio_sem, K_FOREVER);
-		if (data->event_interrupt_cb) {
-			data->event_interrupt_cb(data->sx126x_dev);
-		}
+		k_sem_take(&data->trig_sem, K_FOREVER);
+		sx126x_board_process(data);
 	}
 }
 #endif /* CONFIG_LORA_BASICS_MODEM_DRIVERS_EVENT_TRIGGER_OWN_THREAD */
@@ -74,9 +140,8 @@ static void sx126x_work_cb(struct k_work *work)
 {
 	struct sx126x_hal_context_data_t *data =
 		CONTAINER_OF(work, struct sx126x_hal_context_data_t, work);
-	if (data->event_interrupt_cb) {
-		data->event_interrupt_cb(data->sx126x_dev);
-	}
+
+	sx126x_board_process(data);
 }
 #endif /* CONFIG_LORA_BASICS_MODEM_DRIVERS_EVENT_TRIGGER_GLOBAL_THREAD */
 
@@ -92,7 +157,12 @@ void lora_transceiver_board_attach_interrupt(const struct device *dev, event_cb_
 
 void lora_transceiver_board_enable_interrupt(const struct device *dev)
 {
-#ifdef CONFIG_LORA_BASICS_MODEM_DRIVERS_EVENT_TRIGGER
+#ifdef CONFIG_SEMTECH_SX126X_STM32WL
+	struct sx126x_hal_context_data_t *data = dev->data;
+
+	data->irq_enabled = true;
+	sx126x_stm32wl_board_on_irq_clear(dev);
+#elif defined(CONFIG_LORA_BASICS_MODEM_DRIVERS_EVENT_TRIGGER)
 	const struct sx126x_hal_context_cfg_t *config = dev->config;
 	if (config->dio1.port) {
 		gpio_pin_interrupt_configure_dt(&config->dio1, GPIO_INT_EDGE_TO_ACTIVE);
@@ -110,7 +180,12 @@ void lora_transceiver_board_enable_interrupt(const struct device *dev)
 
 void lora_transceiver_board_disable_interrupt(const struct device *dev)
 {
-#ifdef CONFIG_LORA_BASICS_MODEM_DRIVERS_EVENT_TRIGGER
+#ifdef CONFIG_SEMTECH_SX126X_STM32WL
+	struct sx126x_hal_context_data_t *data = dev->data;
+
+	data->irq_enabled = false;
+	irq_disable(DT_IRQN(SX126X_STM32WL_NODE));
+#elif defined(CONFIG_LORA_BASICS_MODEM_DRIVERS_EVENT_TRIGGER)
 	const struct sx126x_hal_context_cfg_t *config = dev->config;
 	if (config->dio1.port) {
 		gpio_pin_interrupt_configure_dt(&config->dio1, GPIO_INT_DISABLE);
@@ -126,12 +201,78 @@ void lora_transceiver_board_disable_interrupt(const struct device *dev)
 #endif // CONFIG_LORA_BASICS_MODEM_DRIVERS_EVENT_TRIGGER
 }
 
+bool lora_transceiver_board_is_event_pending(const struct device *dev)
+{
+#ifdef CONFIG_SEMTECH_SX126X_STM32WL
+	ARG_UNUSED(dev);
+	// The radio interrupt is level triggered, it is not lost
+	return false;
+#elif defined(CONFIG_LORA_BASICS_MODEM_DRIVERS_EVENT_TRIGGER)
+	const struct sx126x_hal_context_cfg_t *config = dev->config;
+	struct sx126x_hal_context_data_t *data = dev->data;
+
+#ifdef CONFIG_LORA_BASICS_MODEM_DRIVERS_EVENT_TRIGGER_OWN_THREAD
+	if (k_sem_count_get(&data->trig_sem) > 0) {
+		return false;
+	}
+#elif defined(CONFIG_LORA_BASICS_MODEM_DRIVERS_EVENT_TRIGGER_GLOBAL_THREAD)
+	if (k_work_busy_get(&data->work) & (K_WORK_QUEUED | K_WORK_RUNNING)) {
+		return false;
+	}
+#endif
+	// The radio abstraction layer routes all the IRQs to DIO1
+	return config->dio1.port && (gpio_pin_get_dt(&config->dio1) == 1);
+#else
+	ARG_UNUSED(dev);
+	return false;
+#endif // CONFIG_SEMTECH_SX126X_STM32WL
+}
+
 uint32_t lora_transceiver_get_tcxo_startup_delay_ms(const struct device *dev)
 {
 	const struct sx126x_hal_context_cfg_t *config = dev->config;
 	return config->tcxo_cfg.wakeup_time_ms;
 }
 
+void lora_transceiver_board_set_tcxo(const struct device *dev, bool on)
+{
+	const struct sx126x_hal_context_cfg_t *config = dev->config;
+	struct sx126x_hal_context_data_t *data = dev->data;
+
+	if (!config->tcxo_power.port || (data->tcxo_on == on)) {
+		return;
+	}
+
+	gpio_pin_set_dt(&config->tcxo_power, on);
+	data->tcxo_on = on;
+	if (on) {
+		data->tcxo_ready = sys_timepoint_calc(K_MSEC(config->tcxo_cfg.wakeup_time_ms));
+	}
+}
+
+void lora_transceiver_board_set_rf_switch(const struct device *dev,
+					  enum lora_transceiver_rf_switch path)
+{
+	const struct sx126x_hal_context_cfg_t *config = dev->config;
+
+	// Leave the previous path before selecting the new one
+	if (config->tx_enable.port && (path != LORA_TRANSCEIVER_RF_SWITCH_TX)) {
+		gpio_pin_set_dt(&config->tx_enable, 0);
+	}
+	if (config->rx_enable.port && (path != LORA_TRANSCEIVER_RF_SWITCH_RX)) {
+		gpio_pin_set_dt(&config->rx_enable, 0);
+	}
+	if (config->antenna_enable.port) {
+		gpio_pin_set_dt(&config->antenna_enable, path != LORA_TRANSCEIVER_RF_SWITCH_OFF);
+	}
+	if (config->tx_enable.port && (path == LORA_TRANSCEIVER_RF_SWITCH_TX)) {
+		gpio_pin_set_dt(&config->tx_enable, 1);
+	}
+	if (config->rx_enable.port && (path == LORA_TRANSCEIVER_RF_SWITCH_RX)) {
+		gpio_pin_set_dt(&config->rx_enable, 1);
+	}
+}
+
 static int sx126x_init(const struct device *dev)
 {
 	const struct sx126x_hal_context_cfg_t *config = dev->config;
@@ -143,6 +284,11 @@ static int sx126x_init(const struct device *dev)
 		return -EINVAL;
 	}
 
+#ifdef CONFIG_SEMTECH_SX126X_STM32WL
+	// BUSY, NRESET and the radio IRQ are internal signals
+	IRQ_CONNECT(DT_IRQN(SX126X_STM32WL_NODE), DT_IRQ(SX126X_STM32WL_NODE, priority),
+		    sx126x_stm32wl_board_isr, DEVICE_DT_GET(SX126X_STM32WL_NODE), 0);
+#else
 	// Reset pin
 	ret = gpio_pin_configure_dt(&config->reset, GPIO_OUTPUT_INACTIVE);
 	if (ret < 0) {
@@ -156,6 +302,7 @@ static int sx126x_init(const struct device *dev)
 		LOG_ERR("Could not configure busy gpio");
 		return ret;
 	}
+#endif /* CONFIG_SEMTECH_SX126X_STM32WL */
 
 	// DIO1 event pin
 	if (config->dio1.port) {
@@ -182,9 +329,34 @@ static int sx126x_init(const struct device *dev)
 		}
 	}
 
+	// TCXO and antenna switch supplies, off until the first radio operation
+	const struct gpio_dt_spec *outputs[] = {
+		&config->tcxo_power,
+		&config->antenna_enable,
+		&config->tx_enable,
+		&config->rx_enable,
+	};
+
+	for (size_t i = 0; i < ARRAY_SIZE(outputs); i++) {
+		if (!outputs[i]->port) {
+			continue;
+		}
+		ret = gpio_pin_configure_dt(outputs[i], GPIO_OUTPUT_INACTIVE);
+		if (ret < 0) {
+			LOG_ERR("Could not configure TCXO or antenna switch gpio");
+			return ret;
+		}
+	}
+
 	data->sx126x_dev = dev;
 	data->radio_status = RADIO_AWAKE;
 	data->tx_offset = config->tx_offset;
+#ifdef CONFIG_LORA_BASICS_MODEM_DRIVERS_ENERGY
+	sx126x_energy_init(dev);
+#endif /* CONFIG_LORA_BASICS_MODEM_DRIVERS_ENERGY */
+#ifdef CONFIG_LORA_BASICS_MODEM_DRIVERS_BUS_LOCK
+	lora_lbm_bus_init(&data->bus, &config->spi);
+#endif /* CONFIG_LORA_BASICS_MODEM_DRIVERS_BUS_LOCK */
 
 	// Event pin trigger config
 #ifdef CONFIG_LORA_BASICS_MODEM_DRIVERS_EVENT_TRIGGER
@@ -277,6 +449,14 @@ static int sx126x_pm_action(const struct device *dev, enum pm_device_action acti
 #error Device tree properties dio3-gpios and dio3-as-tcxo-control are conflicting, please /delete/ one
 #endif
 
+#define TCXO_POWER_CONFLICT(node_id) (DT_NODE_HAS_PROP(node_id, tcxo_power_gpios) && DT_PROP(node_id, dio3_as_tcxo_control)) ||
+#if DT_FOREACH_STATUS_OKAY(semtech_sx1261_new, TCXO_POWER_CONFLICT) \
+    DT_FOREACH_STATUS_OKAY(semtech_sx1262_new, TCXO_POWER_CONFLICT) \
+    DT_FOREACH_STATUS_OKAY(semtech_sx1268_new, TCXO_POWER_CONFLICT) \
+    DT_FOREACH_STATUS_OKAY(st_stm32wl_subghz_radio_new, TCXO_POWER_CONFLICT) 0
+#error Device tree properties tcxo-power-gpios and dio3-as-tcxo-control are conflicting, please /delete/ one
+#endif
+
 #define CONFIGURE_GPIO_IF_IN_DT(node_id, name, dt_prop)                       \
 	COND_CODE_1(DT_NODE_HAS_PROP(node_id, dt_prop),                           \
 		(.name = GPIO_DT_SPEC_GET(node_id, dt_prop),),                        \
@@ -285,7 +465,7 @@ static int sx126x_pm_action(const struct device *dev, enum pm_device_action acti
 // Derive dio3-as-tcxo-control to know xosc_cfg
 #define SX126X_CFG_TCXO(node_id)                                              \
 	.tcxo_cfg = {                                                             \
-		.xosc_cfg = COND_CODE_1(DT_PROP(node_id, tcxo_wakeup_time) == 0,      \
+		.xosc_cfg = COND_CODE_0(DT_PROP(node_id, tcxo_wakeup_time),           \
 			(RAL_XOSC_CFG_XTAL),                                              \
 			(COND_CODE_1(DT_PROP(node_id, dio3_as_tcxo_control),              \
 				(RAL_XOSC_CFG_TCXO_RADIO_CTRL),                               \
@@ -295,21 +475,73 @@ static int sx126x_pm_action(const struct device *dev, enum pm_device_action acti
 		.wakeup_time_ms = DT_PROP(node_id, tcxo_wakeup_time),                 \
 	}
 
+/*
+ * TX power table generation: SX1261 uses its low power PA, SX1262 and SX1268 their
+ * high power PA. One entry is built per dBm with the consumption estimate of the
+ * devicetree regulator mode.
+ */
+#define SX126X_PA(node_id) \
+	COND_CODE_1(DT_NODE_HAS_COMPAT(node_id, semtech_sx1261_new), (LP), \
+		(COND_CODE_1(DT_ENUM_HAS_VALUE(node_id, power_amplifier_output, rfo_lp), (LP), (HP))))
+
+/* SX1261 reaches +15dBm with a +14dBm configuration and a higher duty cycle */
+#define SX126X_TX_PWR_LP(idx, ua)                                             \
+	{                                                                         \
+		.power = MIN((idx) + SX126X_MIN_PWR_LP, 14),                          \
+		.device_sel = 0x01,                                                   \
+		.hp_max = 0x00,                                                       \
+		.pa_duty_cycle = (((idx) + SX126X_MIN_PWR_LP) == 15) ? 0x06 : 0x04,   \
+		.consumption_ua = (ua),                                               \
+	}
+
+/* SX1262/SX1268 use the maximum HP PA size to achieve 22dBm */
+#define SX126X_TX_PWR_HP(idx, ua)                                             \
+	{                                                                         \
+		.power = (idx) + SX126X_MIN_PWR_HP,                                   \
+		.device_sel = 0x00,                                                   \
+		.hp_max = 0x07,                                                       \
+		.pa_duty_cycle = 0x04,                                                \
+		.consumption_ua = (ua),                                               \
+	}
+
+#define SX126X_TX_PWR_UA_LIST(node_id)                                        \
+	COND_CODE_1(DT_PROP(node_id, reg_mode),                                   \
+		(UTIL_CAT(SX126X_TX_PWR_UA_DCDC_, SX126X_PA(node_id))),               \
+		(UTIL_CAT(SX126X_TX_PWR_UA_LDO_, SX126X_PA(node_id))))
+
+#define SX126X_TX_PWR_TABLE(node_id)                                          \
+	static const struct sx126x_hal_context_tx_pwr_cfg_t                       \
+		sx126x_tx_pwr_table_##node_id[] = {                                   \
+		FOR_EACH_IDX(UTIL_CAT(SX126X_TX_PWR_, SX126X_PA(node_id)), (,),       \
+			SX126X_TX_PWR_UA_LIST(node_id))                                   \
+	};                                                                        \
+	BUILD_ASSERT(ARRAY_SIZE(sx126x_tx_pwr_table_##node_id) ==                 \
+		     UTIL_CAT(SX126X_MAX_PWR_, SX126X_PA(node_id)) -                  \
+		     UTIL_CAT(SX126X_MIN_PWR_, SX126X_PA(node_id)) + 1,               \
+		     "TX power table must hold one entry per dBm")
+
 #define SX126X_CONFIG(node_id)                                                \
 	{                                                                         \
 		.spi = SPI_DT_SPEC_GET(node_id, SX126X_SPI_OPERATION, 0),             \
-		.reset = GPIO_DT_SPEC_GET(node_id, reset_gpios),                      \
-		.busy = GPIO_DT_SPEC_GET(node_id, busy_gpios),                        \
+		CONFIGURE_GPIO_IF_IN_DT(node_id, reset, reset_gpios)                  \
+		CONFIGURE_GPIO_IF_IN_DT(node_id, busy, busy_gpios)                    \
 		CONFIGURE_GPIO_IF_IN_DT(node_id, dio1, dio1_gpios)                    \
 		CONFIGURE_GPIO_IF_IN_DT(node_id, dio2, dio2_gpios)                    \
 		CONFIGURE_GPIO_IF_IN_DT(node_id, dio3, dio3_gpios)                    \
 		.dio2_as_rf_switch = DT_PROP(node_id, dio2_as_rf_switch),             \
 		SX126X_CFG_TCXO(node_id),                                             \
+		CONFIGURE_GPIO_IF_IN_DT(node_id, tcxo_power, tcxo_power_gpios)        \
+		CONFIGURE_GPIO_IF_IN_DT(node_id, antenna_enable, antenna_enable_gpios) \
+		CONFIGURE_GPIO_IF_IN_DT(node_id, tx_enable, tx_enable_gpios)          \
+		CONFIGURE_GPIO_IF_IN_DT(node_id, rx_enable, rx_enable_gpios)          \
 		.capa_xta = DT_PROP_OR(node_id, xtal_capacitor_value_xta, 0xFF),      \
 		.capa_xtb = DT_PROP_OR(node_id, xtal_capacitor_value_xtb, 0xFF),      \
 		.reg_mode = DT_PROP(node_id, reg_mode),                               \
 		.rx_boosted = DT_PROP(node_id, rx_boosted),                           \
 		.tx_offset = DT_PROP_OR(node_id, tx_offset, 0),                       \
+		.tx_pwr_table = DT_CAT(sx126x_tx_pwr_table_, node_id),                \
+		.tx_pwr_min = UTIL_CAT(SX126X_MIN_PWR_, SX126X_PA(node_id)),          \
+		.tx_pwr_max = UTIL_CAT(SX126X_MAX_PWR_, SX126X_PA(node_id)),          \
 	}
 
 #define SX126X_DEVICE_INIT(node_id)                                           \
@@ -319,6 +551,7 @@ static int sx126x_pm_action(const struct device *dev, enum pm_device_action acti
 
 #define SX126X_DEFINE(node_id)                                                                    \
 	static struct sx126x_hal_context_data_t sx126x_data_##node_id;                                \
+	SX126X_TX_PWR_TABLE(node_id);                                                                 \
 	static const struct sx126x_hal_context_cfg_t sx126x_config_##node_id = SX126X_CONFIG(node_id);   \
 	PM_DEVICE_DT_DEFINE(node_id, sx126x_pm_action);                                          \
 	SX126X_DEVICE_INIT(node_id)
@@ -326,3 +559,11 @@ static int sx126x_pm_action(const struct device *dev, enum pm_device_action acti
 DT_FOREACH_STATUS_OKAY(semtech_sx1261_new, SX126X_DEFINE)
 DT_FOREACH_STATUS_OKAY(semtech_sx1262_new, SX126X_DEFINE)
 DT_FOREACH_STATUS_OKAY(semtech_sx1268_new, SX126X_DEFINE)
+
+#if DT_HAS_COMPAT_STATUS_OKAY(st_stm32wl_subghz_radio_new)
+#if DT_HAS_COMPAT_STATUS_OKAY(semtech_sx1261_new) || DT_HAS_COMPAT_STATUS_OKAY(semtech_sx1262_new) || \
+	DT_HAS_COMPAT_STATUS_OKAY(semtech_sx1268_new)
+#error The STM32WL integrated radio cannot be used along an external SX126x
+#endif
+DT_FOREACH_STATUS_OKAY(st_stm32wl_subghz_radio_new, SX126X_DEFINE)
+#endif
@@ -0,0 +1,163 @@
+/*
+ * Copyright (c) 2024 Semtech Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/sys/byteorder.h>
+
+#include "ral_sx126x_bsp.h"
+#include "lora_lbm_energy.h"
+#include "sx126x_hal_context.h"
+
+/* Opcodes of the commands changing the chip state */
+#define SX126X_SET_STANDBY_OC 0x80
+#define SX126X_SET_RX_OC 0x82
+#define SX126X_SET_TX_OC 0x83
+#define SX126X_SET_SLEEP_OC 0x84
+#define SX126X_SET_PKT_TYPE_OC 0x8A
+#define SX126X_SET_RX_DUTY_CYCLE_OC 0x94
+#define SX126X_SET_FS_OC 0xC1
+#define SX126X_SET_CAD_OC 0xC5
+#define SX126X_SET_TX_CW_OC 0xD1
+#define SX126X_SET_TX_INFINITE_PREAMBLE_OC 0xD2
+
+#define SX126X_PKT_TYPE_GFSK 0x00
+#define SX126X_RX_CONTINUOUS 0xFFFFFF
+
+/*
+ * SX1261/2 datasheet typical figures, in uA: sleep with warm start (600 nA, rounded up) and
+ * standby on the RC oscillator. A CAD is accounted as a LoRa reception.
+ */
+#define SX126X_SLEEP_CONSUMPTION 1
+#define SX126X_STANDBY_CONSUMPTION 600
+
+static uint32_t sx126x_energy_rx_current_ua(const struct device *dev, bool gfsk)
+{
+	const struct sx126x_hal_context_cfg_t *config = dev->config;
+	uint32_t current_ua = 0;
+
+	if (gfsk) {
+		ral_sx126x_bsp_get_instantaneous_gfsk_rx_power_consumption(
+			dev, config->reg_mode, config->rx_boosted, &current_ua);
+	} else {
+		ral_sx126x_bsp_get_instantaneous_lora_rx_power_consumption(
+			dev, config->reg_mode, config->rx_boosted, &current_ua);
+	}
+	return current_ua;
+}
+
+static void sx126x_energy_enter_rx(const struct device *dev, bool continuous)
+{
+	struct sx126x_hal_context_data_t *data = dev->data;
+
+	data->energy_rx_continuous = continuous;
+	// LBT senses the channel RSSI in a continuous GFSK reception, stopped by the modem
+	lora_lbm_energy_enter(&data->energy,
+			      (data->energy_gfsk && continuous) ? LORA_LBM_ENERGY_CAD_LBT :
+								  LORA_LBM_ENERGY_RX_WINDOWS,
+			      sx126x_energy_rx_current_ua(dev, data->energy_gfsk));
+}
+
+void sx126x_energy_init(const struct device *dev)
+{
+	struct sx126x_hal_context_data_t *data = dev->data;
+
+	lora_lbm_energy_init(&data->energy, SX126X_STANDBY_CONSUMPTION);
+}
+
+void sx126x_energy_set_tx_cfg(const void *context,
+	const ral_sx126x_bsp_tx_cfg_output_params_t *tx_cfg)
+{
+	const struct device *dev = context;
+	const struct sx126x_hal_context_cfg_t *config = dev->config;
+	struct sx126x_hal_context_data_t *data = dev->data;
+	uint32_t current_ua = 0;
+
+	// Keep 0 when the consumption of this PA configuration is unknown
+	ral_sx126x_bsp_get_instantaneous_tx_power_consumption(context, tx_cfg, config->reg_mode,
+							       &current_ua);
+	data->energy.tx_current_ua = current_ua;
+}
+
+void sx126x_energy_on_command(const struct device *dev, const uint8_t *command,
+	uint16_t command_length)
+{
+	struct sx126x_hal_context_data_t *data = dev->data;
+
+	if (command_length < 1) {
+		return;
+	}
+
+	switch (command[0]) {
+	case SX126X_SET_SLEEP_OC:
+		lora_lbm_energy_enter(&data->energy, LORA_LBM_ENERGY_SLEEP, SX126X_SLEEP_CONSUMPTION);
+		break;
+	case SX126X_SET_STANDBY_OC:
+	case SX126X_SET_FS_OC:
+		lora_lbm_energy_enter(&data->energy, LORA_LBM_ENERGY_STANDBY,
+				      SX126X_STANDBY_CONSUMPTION);
+		break;
+	case SX126X_SET_PKT_TYPE_OC:
+		if (command_length > 1) {
+			data->energy_gfsk = (command[1] == SX126X_PKT_TYPE_GFSK);
+		}
+		break;
+	case SX126X_SET_TX_OC:
+	case SX126X_SET_TX_CW_OC:
+	case SX126X_SET_TX_INFINITE_PREAMBLE_OC:
+		lora_lbm_energy_enter(&data->energy, LORA_LBM_ENERGY_LORAWAN_TX,
+				      data->energy.tx_current_ua);
+		break;
+	case SX126X_SET_RX_OC:
+		sx126x_energy_enter_rx(dev, (command_length > 3) &&
+				       (sys_get_be24(&command[1]) == SX126X_RX_CONTINUOUS));
+		break;
+	case SX126X_SET_RX_DUTY_CYCLE_OC:
+		sx126x_energy_enter_rx(dev, false);
+		break;
+	case SX126X_SET_CAD_OC:
+		data->energy_rx_continuous = false;
+		lora_lbm_energy_enter(&data->energy, LORA_LBM_ENERGY_CAD_LBT,
+				      sx126x_energy_rx_current_ua(dev, false));
+		break;
+	default:
+		break;
+	}
+}
+
+void sx126x_energy_on_wakeup(const struct device *dev)
+{
+	struct sx126x_hal_context_data_t *data = dev->data;
+
+	lora_lbm_energy_enter(&data->energy, LORA_LBM_ENERGY_STANDBY, SX126X_STANDBY_CONSUMPTION);
+}
+
+void sx126x_energy_on_event(const struct device *dev)
+{
+	struct sx126x_hal_context_data_t *data = dev->data;
+
+	// TX, RX and CAD end with an event, the chip then falls back to standby
+	switch (data->energy.category) {
+	case LORA_LBM_ENERGY_RX_WINDOWS:
+	case LORA_LBM_ENERGY_CAD_LBT:
+		if (data->energy_rx_continuous) {
+			break;
+		}
+		__fallthrough;
+	case LORA_LBM_ENERGY_LORAWAN_TX:
+		lora_lbm_energy_enter(&data->energy, LORA_LBM_ENERGY_STANDBY,
+				      SX126X_STANDBY_CONSUMPTION);
+		break;
+	default:
+		break;
+	}
+}
+
+struct lora_lbm_energy *lora_transceiver_get_energy(const struct device *dev)
+{
+	struct sx126x_hal_context_data_t *data = dev->data;
+
+	return &data->energy;
+}
@@ -8,14 +8,99 @@
 #include <zephyr/drivers/gpio.h>
 #include <zephyr/drivers/spi.h>
 #include <zephyr/kernel.h>
+#include <zephyr/sys/byteorder.h>
 #include <zephyr/types.h>
 
 #include "sx126x_hal.h"
 #include "sx126x_hal_context.h"
+#include "lora_lbm_stats.h"
+#include "lora_lbm_transceiver.h"
+#include "lora_lbm_tracing.h"
+
+#ifdef CONFIG_SEMTECH_SX126X_STM32WL
+#include <stm32_ll_pwr.h>
+#include <stm32_ll_rcc.h>
+#endif /* CONFIG_SEMTECH_SX126X_STM32WL */
 
 #include <zephyr/logging/log.h>
 LOG_MODULE_REGISTER(sx126x_hal, CONFIG_LORA_BASICS_MODEM_DRIVERS_LOG_LEVEL);
 
+/* SX126X_SET_TX, SX126X_GET_IRQ_STATUS and SX126X_CLR_IRQ_STATUS opcodes */
+#define SX126X_HAL_SET_TX_OC 0x83
+#define SX126X_HAL_GET_IRQ_STATUS_OC 0x12
+#define SX126X_HAL_CLR_IRQ_STATUS_OC 0x02
+
+/* Opcodes of the commands starting or stopping the 32MHz oscillator */
+#define SX126X_HAL_SET_STANDBY_OC 0x80
+#define SX126X_HAL_SET_RX_OC 0x82
+#define SX126X_HAL_SET_SLEEP_OC 0x84
+#define SX126X_HAL_CALIBRATE_OC 0x89
+#define SX126X_HAL_SET_RX_DUTY_CYCLE_OC 0x94
+#define SX126X_HAL_CALIBRATE_IMAGE_OC 0x98
+#define SX126X_HAL_SET_FS_OC 0xC1
+#define SX126X_HAL_SET_CAD_OC 0xC5
+#define SX126X_HAL_SET_TX_CW_OC 0xD1
+#define SX126X_HAL_SET_TX_INFINITE_PREAMBLE_OC 0xD2
+
+#ifdef CONFIG_SEMTECH_SX126X_STM32WL
+/* Most commands release BUSY within a few us, spin that long before sleeping */
+#define SX126X_HAL_STM32WL_BUSY_SPIN_US 100
+#endif /* CONFIG_SEMTECH_SX126X_STM32WL */
+
+#ifdef CONFIG_LORA_BASICS_MODEM_DRIVERS_BUS_LOCK
+/* SX126X_SET_PKT_PARAMS opcode, opening the commands sequence of a radio operation */
+#define SX126X_HAL_SET_PKT_PARAMS_OC 0x8C
+
+/* Opcodes starting a radio operation or leaving it, closing the commands sequence */
+static bool sx126x_hal_is_sequence_end(uint8_t opcode)
+{
+	switch (opcode) {
+	case 0x80: // SetStandby
+	case 0x82: // SetRx
+	case 0x83: // SetTx
+	case 0x84: // SetSleep
+	case 0x94: // SetRxDutyCycle
+	case 0xC1: // SetFs
+	case 0xC5: // SetCad
+	case 0xD1: // SetTxContinuousWave
+	case 0xD2: // SetTxInfinitePreamble
+		return true;
+	default:
+		return false;
+	}
+}
+#endif /* CONFIG_LORA_BASICS_MODEM_DRIVERS_BUS_LOCK */
+
+#ifdef CONFIG_LORA_BASICS_MODEM_DRIVERS_STATS
+/* IRQ status flags, see sx126x_irq_masks_e */
+static const uint32_t sx126x_hal_stats_irqs[][2] = {
+	{ BIT(0), LORA_LBM_STATS_IRQ_TX_DONE },
+	{ BIT(1), LORA_LBM_STATS_IRQ_RX_DONE },
+	{ BIT(5), LORA_LBM_STATS_IRQ_HEADER_ERROR },
+	{ BIT(6), LORA_LBM_STATS_IRQ_CRC_ERROR },
+	{ BIT(7), LORA_LBM_STATS_IRQ_CAD_DONE },
+	{ BIT(8), LORA_LBM_STATS_IRQ_CAD_DETECTED },
+	{ BIT(9), LORA_LBM_STATS_IRQ_TIMEOUT },
+};
+
+/* LORA_LBM_STATS_IRQ_* flags of the chip IRQ flags */
+static uint32_t sx126x_hal_stats_convert(uint32_t chip_irqs)
+{
+	uint32_t irqs = 0;
+
+	for (int i = 0; i < ARRAY_SIZE(sx126x_hal_stats_irqs); i++) {
+		if (chip_irqs & sx126x_hal_stats_irqs[i][0]) {
+			irqs |= sx126x_hal_stats_irqs[i][1];
+			chip_irqs &= ~sx126x_hal_stats_irqs[i][0];
+		}
+	}
+	if (chip_irqs) {
+		irqs |= LORA_LBM_STATS_IRQ_OTHER;
+	}
+	return irqs;
+}
+#endif /* CONFIG_LORA_BASICS_MODEM_DRIVERS_STATS */
+
 /**
  * @brief Waits for the BUSY pin of the transceiver to go back up
  *
@@ -23,20 +108,56 @@ LOG_MODULE_REGISTER(sx126x_hal, CONFIG_LORA_BASICS_MODEM_DRIVERS_LOG_LEVEL);
  */
 static void sx126x_hal_wait_on_busy(const void* context)
 {
+	int64_t start = k_uptime_ticks();
+	bool ret;
+
+	LORA_LBM_TRACE_BEGIN(busy_wait, 0);
+#ifdef CONFIG_SEMTECH_SX126X_STM32WL
+	ARG_UNUSED(context);
+	// RFBUSYS reads the internal BUSY signal, no GPIO access needed
+	ret = WAIT_FOR(!LL_PWR_IsActiveFlag_RFBUSYS(), SX126X_HAL_STM32WL_BUSY_SPIN_US,
+		       k_busy_wait(1)) ||
+	      WAIT_FOR(!LL_PWR_IsActiveFlag_RFBUSYS(),
+		       (1000 * CONFIG_LORA_BASICS_MODEM_DRIVERS_HAL_WAIT_ON_BUSY_TIMEOUT_MSEC),
+		       k_usleep(100));
+#else
 	const struct device *dev = (const struct device *)context;
 	const struct sx126x_hal_context_cfg_t *config = dev->config;
-	bool ret;
 
 	ret = WAIT_FOR(
 		gpio_pin_get_dt(&config->busy) == 0,
 		(1000 * CONFIG_LORA_BASICS_MODEM_DRIVERS_HAL_WAIT_ON_BUSY_TIMEOUT_MSEC),
 		k_usleep(100)
 	);
+#endif /* CONFIG_SEMTECH_SX126X_STM32WL */
 	if (!ret) {
 		LOG_ERR("Timeout of %dms hit when waiting for sx126x busy!",
 			CONFIG_LORA_BASICS_MODEM_DRIVERS_HAL_WAIT_ON_BUSY_TIMEOUT_MSEC);
 		k_oops();
 	}
+	lora_lbm_stats_on_busy_wait(k_ticks_to_us_floor32(k_uptime_ticks() - start));
+	LORA_LBM_TRACE_END(busy_wait, 0);
+}
+
+/**
+ * @brief SPI transfer with the transceiver, in the ongoing radio transaction if any
+ *
+ * @param dev
+ * @param tx
+ * @param rx
+ */
+static int sx126x_hal_spi_transceive(const struct device *dev,
+	const struct spi_buf_set *tx, const struct spi_buf_set *rx)
+{
+#ifdef CONFIG_LORA_BASICS_MODEM_DRIVERS_BUS_LOCK
+	struct sx126x_hal_context_data_t *data = dev->data;
+
+	return lora_lbm_bus_transceive(&data->bus, tx, rx);
+#else
+	const struct sx126x_hal_context_cfg_t *config = dev->config;
+
+	return spi_transceive_dt(&config->spi, tx, rx);
+#endif /* CONFIG_LORA_BASICS_MODEM_DRIVERS_BUS_LOCK */
 }
 
 /**
@@ -47,23 +168,145 @@ static void sx126x_hal_wait_on_busy(const void* context)
 static void sx126x_hal_check_device_ready(const void* context)
 {
 	const struct device *dev = (const struct device *)context;
-	const struct sx126x_hal_context_cfg_t *config = dev->config;
 	struct sx126x_hal_context_data_t *data = dev->data;
 
 	if( data->radio_status != RADIO_SLEEP ) {
 		sx126x_hal_wait_on_busy(context);
 	} else {
 		// Busy is HIGH in sleep mode, wake-up the device with a small glitch on NSS
+#ifdef CONFIG_SEMTECH_SX126X_STM32WL
+		// The radio NSS is driven from the PWR SUBGHZSPI control register
+		LL_PWR_SelectSUBGHZSPI_NSS();
+		k_busy_wait(20);
+		LL_PWR_UnselectSUBGHZSPI_NSS();
+#else
+		const struct sx126x_hal_context_cfg_t *config = dev->config;
 		const struct gpio_dt_spec *cs = &(config->spi.config.cs.gpio);
 
 		gpio_pin_set_dt(cs, 1);
 		k_usleep(100);
 		gpio_pin_set_dt(cs, 0);
+#endif /* CONFIG_SEMTECH_SX126X_STM32WL */
 		sx126x_hal_wait_on_busy(context);
 		data->radio_status = RADIO_AWAKE;
+#ifdef CONFIG_LORA_BASICS_MODEM_DRIVERS_ENERGY
+		sx126x_energy_on_wakeup(dev);
+#endif /* CONFIG_LORA_BASICS_MODEM_DRIVERS_ENERGY */
 	}
 }
 
+#ifdef CONFIG_SEMTECH_SX126X_IRQ_FETCH
+/**
+ * @brief Serve a GetIrqStatus command from the IRQ status fetched by the driver
+ *
+ * @param dev
+ * @param data 2 bytes of IRQ status
+ * @return true when served from the cache
+ */
+static bool sx126x_hal_irq_cache_read(const struct device *dev, uint8_t *data)
+{
+	uint16_t irqs;
+	uint8_t dio;
+
+	if (!sx126x_hal_context_get_irq_cache(dev, &irqs, &dio)) {
+		return false;
+	}
+	sys_put_be16(irqs, data);
+	return true;
+}
+
+/**
+ * @brief Serve a ClearIrqStatus command from the IRQ status fetched by the driver
+ *
+ * The fetch already cleared the cached flags on the chip. Flags raised since the
+ * fetch are only set on the chip, the command still has to clear them there.
+ *
+ * @param dev
+ * @param mask IRQ flags to clear
+ * @return IRQ flags left to clear on the chip
+ */
+static uint16_t sx126x_hal_irq_cache_clear(const struct device *dev, uint16_t mask)
+{
+	struct sx126x_hal_context_data_t *dev_data = dev->data;
+	k_spinlock_key_t key = k_spin_lock(&dev_data->irq_lock);
+	uint16_t chip_mask = mask;
+
+	if (dev_data->irq_cache_valid) {
+		chip_mask = mask & ~dev_data->irq_cache;
+		dev_data->irq_cache &= ~mask;
+		dev_data->irq_cache_valid = (dev_data->irq_cache != 0);
+		if (!dev_data->irq_cache_valid) {
+			dev_data->irq_cache_dio = 0;
+		}
+	}
+	k_spin_unlock(&dev_data->irq_lock, key);
+	return chip_mask;
+}
+
+/**
+ * @brief Drop the fetched IRQ status, the chip is reset
+ *
+ * @param dev
+ */
+static void sx126x_hal_irq_cache_invalidate(const struct device *dev)
+{
+	struct sx126x_hal_context_data_t *dev_data = dev->data;
+	k_spinlock_key_t key = k_spin_lock(&dev_data->irq_lock);
+
+	dev_data->irq_cache = 0;
+	dev_data->irq_cache_valid = false;
+	dev_data->irq_cache_dio = 0;
+	k_spin_unlock(&dev_data->irq_lock, key);
+}
+#endif /* CONFIG_SEMTECH_SX126X_IRQ_FETCH */
+
+/**
+ * @brief Wait for the TCXO powered by the board before a command running on it
+ *
+ * The TCXO starts while the radio is configured, only the commands needing the 32MHz clock
+ * wait for the end of its startup delay. It is powered here if the modem HAL did not start it.
+ *
+ * @param dev
+ * @param command
+ * @param command_length
+ */
+static void sx126x_hal_wait_tcxo(const struct device *dev, const uint8_t *command,
+				 uint16_t command_length)
+{
+	const struct sx126x_hal_context_cfg_t *config = dev->config;
+	struct sx126x_hal_context_data_t *data = dev->data;
+
+	if (!config->tcxo_power.port) {
+		return;
+	}
+
+	switch (command[0]) {
+	case SX126X_HAL_SET_STANDBY_OC:
+		if ((command_length < 2) || (command[1] != SX126X_STANDBY_CFG_XOSC)) {
+			return;
+		}
+		break;
+	case SX126X_HAL_SET_TX_OC:
+	case SX126X_HAL_SET_RX_OC:
+	case SX126X_HAL_CALIBRATE_OC:
+	case SX126X_HAL_SET_RX_DUTY_CYCLE_OC:
+	case SX126X_HAL_CALIBRATE_IMAGE_OC:
+	case SX126X_HAL_SET_FS_OC:
+	case SX126X_HAL_SET_CAD_OC:
+	case SX126X_HAL_SET_TX_CW_OC:
+	case SX126X_HAL_SET_TX_INFINITE_PREAMBLE_OC:
+		break;
+	default:
+		return;
+	}
+
+	lora_transceiver_board_set_tcxo(dev, true);
+	if (!sys_timepoint_expired(data->tcxo_ready)) {
+		LORA_LBM_TRACE_BEGIN(sx126x_tcxo, command[0]);
+		k_sleep(sys_timepoint_timeout(data->tcxo_ready));
+		LORA_LBM_TRACE_END(sx126x_tcxo, command[0]);
+	}
+}
 
 /*
  * -----------------------------------------------------------------------------
@@ -75,11 +318,34 @@ sx126x_hal_status_t sx126x_hal_write(const void* context,
 	const uint8_t* data, const uint16_t data_length)
 {
 	const struct device *dev = (const struct device *)context;
-	const struct sx126x_hal_context_cfg_t *config = dev->config;
 	struct sx126x_hal_context_data_t *dev_data = dev->data;
 	int ret;
 
+	LORA_LBM_TRACE_BEGIN(sx126x_write, command[0]);
+#ifdef CONFIG_LORA_BASICS_MODEM_DRIVERS_STATS
+	// Before the fetch below rewrites the mask, the modem cleared all of these
+	if ((command[0] == SX126X_HAL_CLR_IRQ_STATUS_OC) && (command_length == 3)) {
+		lora_lbm_stats_on_irq_clear(sx126x_hal_stats_convert(sys_get_be16(&command[1])));
+	}
+#endif /* CONFIG_LORA_BASICS_MODEM_DRIVERS_STATS */
+#ifdef CONFIG_SEMTECH_SX126X_IRQ_FETCH
+	uint8_t clr_cmd[3];
+
+	if ((command[0] == SX126X_HAL_CLR_IRQ_STATUS_OC) && (command_length == sizeof(clr_cmd))) {
+		uint16_t chip_mask = sx126x_hal_irq_cache_clear(dev, sys_get_be16(&command[1]));
+
+		if (chip_mask == 0) {
+			LORA_LBM_TRACE_END(sx126x_write, SX126X_HAL_STATUS_OK);
+			return SX126X_HAL_STATUS_OK;
+		}
+		// Only send the flags the fetch did not clear already
+		clr_cmd[0] = SX126X_HAL_CLR_IRQ_STATUS_OC;
+		sys_put_be16(chip_mask, &clr_cmd[1]);
+		command = clr_cmd;
+	}
+#endif /* CONFIG_SEMTECH_SX126X_IRQ_FETCH */
 	sx126x_hal_check_device_ready(context);
+	sx126x_hal_wait_tcxo(dev, command, command_length);
 
 	const struct spi_buf tx_bufs[] = {
 		{
@@ -93,20 +359,52 @@ sx126x_hal_status_t sx126x_hal_write(const void* context,
 
 	const struct spi_buf_set tx_buf_set = {tx_bufs, .count = ARRAY_SIZE(tx_bufs)};
 
-	ret = spi_write_dt(&config->spi, &tx_buf_set);
+#ifdef CONFIG_LORA_BASICS_MODEM_DRIVERS_BUS_LOCK
+	if (command[0] == SX126X_HAL_SET_PKT_PARAMS_OC) {
+		lora_lbm_bus_sequence(&dev_data->bus, true);
+	}
+#endif /* CONFIG_LORA_BASICS_MODEM_DRIVERS_BUS_LOCK */
+
+	ret = sx126x_hal_spi_transceive(dev, &tx_buf_set, NULL);
+	lora_lbm_stats_on_spi(true, command_length + data_length, ret == 0);
 	if (ret) {
+		LORA_LBM_TRACE_END(sx126x_write, SX126X_HAL_STATUS_ERROR);
 		return SX126X_HAL_STATUS_ERROR;
 	}
 
+#ifdef CONFIG_LORA_BASICS_MODEM_DRIVERS_BUS_LOCK
+	if (sx126x_hal_is_sequence_end(command[0])) {
+		lora_lbm_bus_sequence(&dev_data->bus, false);
+	}
+#endif /* CONFIG_LORA_BASICS_MODEM_DRIVERS_BUS_LOCK */
+
+	if (command[0] == SX126X_HAL_SET_TX_OC) {
+		lora_lbm_stats_on_tx_start();
+	}
+
+#ifdef CONFIG_SEMTECH_SX126X_STM32WL
+	if (command[0] == SX126X_HAL_CLR_IRQ_STATUS_OC) {
+		sx126x_stm32wl_board_on_irq_clear(dev);
+	}
+#endif /* CONFIG_SEMTECH_SX126X_STM32WL */
+
+#ifdef CONFIG_LORA_BASICS_MODEM_DRIVERS_ENERGY
+	sx126x_energy_on_command(dev, command, command_length);
+#endif /* CONFIG_LORA_BASICS_MODEM_DRIVERS_ENERGY */
+
 	// 0x84 - SX126x_SET_SLEEP opcode. In sleep mode the radio dio is struck to 1
 	// => do not test it
-	if(command[0] == 0x84) {
+	if(command[0] == SX126X_HAL_SET_SLEEP_OC) {
 		dev_data->radio_status = RADIO_SLEEP;
+		// Nothing runs on the TCXO and the antenna switch until the next radio operation
+		lora_transceiver_board_set_rf_switch(dev, LORA_TRANSCEIVER_RF_SWITCH_OFF);
+		lora_transceiver_board_set_tcxo(dev, false);
 		k_usleep(500);
 	} else {
 		sx126x_hal_check_device_ready(context);
 	}
 
+	LORA_LBM_TRACE_END(sx126x_write, SX126X_HAL_STATUS_OK);
 	return SX126X_HAL_STATUS_OK;
 }
 
@@ -115,9 +413,16 @@ sx126x_hal_status_t sx126x_hal_read(const void* context,
 	uint8_t* data, const uint16_t data_length)
 {
 	const struct device *dev = (const struct device *)context;
-	const struct sx126x_hal_context_cfg_t *config = dev->config;
 	int ret;
 
+	LORA_LBM_TRACE_BEGIN(sx126x_read, command[0]);
+#ifdef CONFIG_SEMTECH_SX126X_IRQ_FETCH
+	if ((command[0] == SX126X_HAL_GET_IRQ_STATUS_OC) && (data_length == 2) &&
+	    sx126x_hal_irq_cache_read(dev, data)) {
+		LORA_LBM_TRACE_END(sx126x_read, SX126X_HAL_STATUS_OK);
+		return SX126X_HAL_STATUS_OK;
+	}
+#endif /* CONFIG_SEMTECH_SX126X_IRQ_FETCH */
 	sx126x_hal_check_device_ready(context);
 
 	const struct spi_buf tx_bufs[] = {
@@ -143,27 +448,53 @@ sx126x_hal_status_t sx126x_hal_read(const void* context,
 	const struct spi_buf_set tx_buf_set = {.buffers=tx_bufs, .count = ARRAY_SIZE(tx_bufs)};
 	const struct spi_buf_set rx_buf_set = {.buffers=rx_bufs, .count = ARRAY_SIZE(rx_bufs)};
 
-	ret = spi_transceive_dt(&config->spi, &tx_buf_set, &rx_buf_set);
+	ret = sx126x_hal_spi_transceive(dev, &tx_buf_set, &rx_buf_set);
+	lora_lbm_stats_on_spi(false, command_length + data_length, ret == 0);
 	if (ret) {
+		LORA_LBM_TRACE_END(sx126x_read, SX126X_HAL_STATUS_ERROR);
 		return SX126X_HAL_STATUS_ERROR;
 	}
+
+#ifdef CONFIG_LORA_BASICS_MODEM_DRIVERS_STATS
+	if ((command[0] == SX126X_HAL_GET_IRQ_STATUS_OC) && (data_length == 2)) {
+		lora_lbm_stats_on_irq_status(sx126x_hal_stats_convert(sys_get_be16(data)));
+	}
+#endif /* CONFIG_LORA_BASICS_MODEM_DRIVERS_STATS */
+	LORA_LBM_TRACE_END(sx126x_read, SX126X_HAL_STATUS_OK);
 	return SX126X_HAL_STATUS_OK;
 }
 
 sx126x_hal_status_t sx126x_hal_reset(const void* context)
 {
 	const struct device *dev = (const struct device *)context;
-	const struct sx126x_hal_context_cfg_t *config = dev->config;
 	struct sx126x_hal_context_data_t *data = dev->data;
 
+#ifdef CONFIG_SEMTECH_SX126X_STM32WL
+	LL_RCC_RF_EnableReset();
+	k_msleep(5);
+	LL_RCC_RF_DisableReset();
+	k_msleep(5);
+#else
+	const struct sx126x_hal_context_cfg_t *config = dev->config;
 	const struct gpio_dt_spec *nrst = &(config->reset);
 
 	gpio_pin_set_dt(nrst, 1);
 	k_msleep(5);
 	gpio_pin_set_dt(nrst, 0);
 	k_msleep(5);
+#endif /* CONFIG_SEMTECH_SX126X_STM32WL */
 
+#ifdef CONFIG_LORA_BASICS_MODEM_DRIVERS_BUS_LOCK
+	// A sequence cut by the reset never gets its end command
+	lora_lbm_bus_sequence(&data->bus, false);
+#endif /* CONFIG_LORA_BASICS_MODEM_DRIVERS_BUS_LOCK */
+#ifdef CONFIG_SEMTECH_SX126X_IRQ_FETCH
+	sx126x_hal_irq_cache_invalidate(dev);
+#endif /* CONFIG_SEMTECH_SX126X_IRQ_FETCH */
 	data->radio_status = RADIO_AWAKE;
+#ifdef CONFIG_LORA_BASICS_MODEM_DRIVERS_ENERGY
+	sx126x_energy_on_wakeup(dev);
+#endif /* CONFIG_LORA_BASICS_MODEM_DRIVERS_ENERGY */
 	return SX126X_HAL_STATUS_OK;
 }
 
@@ -172,3 +503,112 @@ sx126x_hal_status_t sx126x_hal_wakeup(const void* context)
 	sx126x_hal_check_device_ready(context);
 	return SX126X_HAL_STATUS_OK;
 }
+
+int lora_transceiver_prewake(const struct device *dev)
+{
+	const struct sx126x_hal_context_cfg_t *config = dev->config;
+	struct sx126x_hal_context_data_t *data = dev->data;
+	int ret = 0;
+
+	if (data->radio_status != RADIO_SLEEP) {
+		return 0;
+	}
+
+	LORA_LBM_TRACE_BEGIN(sx126x_prewake, 0);
+	lora_transceiver_board_set_tcxo(dev, true);
+	sx126x_hal_check_device_ready(dev);
+	// The chip wakes up in STDBY_RC, the TCXO driven by DIO3 only starts in STDBY_XOSC
+	if ((config->tcxo_cfg.xosc_cfg == RAL_XOSC_CFG_TCXO_RADIO_CTRL) &&
+	    (config->tcxo_cfg.wakeup_time_ms > 0)) {
+		if (sx126x_set_standby(dev, SX126X_STANDBY_CFG_XOSC) != SX126X_STATUS_OK) {
+			ret = -EIO;
+		}
+	}
+	LORA_LBM_TRACE_END(sx126x_prewake, ret);
+	return ret;
+}
+
+#ifdef CONFIG_SEMTECH_SX126X_IRQ_FETCH
+void lora_transceiver_fetch_irq_status(const struct device *dev)
+{
+	struct sx126x_hal_context_data_t *data = dev->data;
+	uint8_t get_cmd[2] = { SX126X_HAL_GET_IRQ_STATUS_OC, 0x00 };
+	uint8_t status[2];
+	k_spinlock_key_t key;
+	uint16_t irqs;
+	uint8_t dio;
+	int ret;
+
+	// DIO lines that fired since the last fetch, none on the STM32WL radio interrupt
+	dio = (uint8_t)atomic_clear(&data->dio_fired);
+	LORA_LBM_TRACE_BEGIN(sx126x_irq_get, dio);
+#ifdef CONFIG_LORA_BASICS_MODEM_DRIVERS_BUS_LOCK
+	// Keep the bus from the read to the clear, the chip must not raise IRQs in between unseen
+	lora_lbm_bus_begin(&data->bus);
+#endif /* CONFIG_LORA_BASICS_MODEM_DRIVERS_BUS_LOCK */
+	sx126x_hal_check_device_ready(dev);
+
+	const struct spi_buf tx_bufs[] = {
+		{ .buf = get_cmd, .len = sizeof(get_cmd) },
+		{ .buf = NULL, .len = sizeof(status) },
+	};
+	const struct spi_buf rx_bufs[] = {
+		{ .buf = NULL, .len = sizeof(get_cmd) },
+		{ .buf = status, .len = sizeof(status) },
+	};
+	const struct spi_buf_set tx_set = { .buffers = tx_bufs, .count = ARRAY_SIZE(tx_bufs) };
+	const struct spi_buf_set rx_set = { .buffers = rx_bufs, .count = ARRAY_SIZE(rx_bufs) };
+
+	ret = sx126x_hal_spi_transceive(dev, &tx_set, &rx_set);
+	lora_lbm_stats_on_spi(false, sizeof(get_cmd) + sizeof(status), ret == 0);
+	irqs = (ret == 0) ? sys_get_be16(status) : 0;
+
+	if (irqs != 0) {
+		uint8_t clr_cmd[3] = { SX126X_HAL_CLR_IRQ_STATUS_OC, status[0], status[1] };
+		const struct spi_buf clr_buf = { .buf = clr_cmd, .len = sizeof(clr_cmd) };
+		const struct spi_buf_set clr_set = { .buffers = &clr_buf, .count = 1 };
+
+		sx126x_hal_check_device_ready(dev);
+		ret = sx126x_hal_spi_transceive(dev, &clr_set, NULL);
+		lora_lbm_stats_on_spi(true, sizeof(clr_cmd), ret == 0);
+		if (ret) {
+			// Leave the flags on the chip, the RAL reads and clears them itself
+			irqs = 0;
+		}
+	}
+#ifdef CONFIG_LORA_BASICS_MODEM_DRIVERS_BUS_LOCK
+	lora_lbm_bus_end(&data->bus);
+#endif /* CONFIG_LORA_BASICS_MODEM_DRIVERS_BUS_LOCK */
+
+	if (irqs != 0) {
+		key = k_spin_lock(&data->irq_lock);
+		data->irq_cache |= irqs;
+		data->irq_cache_dio |= dio;
+		data->irq_cache_valid = true;
+		k_spin_unlock(&data->irq_lock, key);
+#ifdef CONFIG_LORA_BASICS_MODEM_DRIVERS_STATS
+		lora_lbm_stats_on_irq_status(sx126x_hal_stats_convert(irqs));
+#endif /* CONFIG_LORA_BASICS_MODEM_DRIVERS_STATS */
+#ifdef CONFIG_SEMTECH_SX126X_STM32WL
+		sx126x_stm32wl_board_on_irq_clear(dev);
+#endif /* CONFIG_SEMTECH_SX126X_STM32WL */
+	}
+	LORA_LBM_TRACE_END(sx126x_irq_get, irqs);
+}
+#endif /* CONFIG_SEMTECH_SX126X_IRQ_FETCH */
+
+#ifdef CONFIG_LORA_BASICS_MODEM_DRIVERS_BUS_LOCK
+void lora_transceiver_transaction_begin(const struct device *dev)
+{
+	struct sx126x_hal_context_data_t *data = dev->data;
+
+	lora_lbm_bus_begin(&data->bus);
+}
+
+int lora_transceiver_transaction_end(const struct device *dev)
+{
+	struct sx126x_hal_context_data_t *data = dev->data;
+
+	return lora_lbm_bus_end(&data->bus);
+}
+#endif /* CONFIG_LORA_BASICS_MODEM_DRIVERS_BUS_LOCK */
@@ -14,6 +14,13 @@
 
 #include <sx126x.h>
 
+#ifdef CONFIG_LORA_BASICS_MODEM_DRIVERS_ENERGY
+#include "lora_lbm_energy.h"
+#endif /* CONFIG_LORA_BASICS_MODEM_DRIVERS_ENERGY */
+#ifdef CONFIG_LORA_BASICS_MODEM_DRIVERS_BUS_LOCK
+#include "lora_lbm_bus.h"
+#endif /* CONFIG_LORA_BASICS_MODEM_DRIVERS_BUS_LOCK */
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -24,12 +31,25 @@ struct sx126x_hal_context_tcxo_cfg_t {
 	uint32_t wakeup_time_ms;
 };
 
-typedef struct sx126x_pa_pwr_cfg_s
-{
-	int8_t  power;
+#define SX126X_MIN_PWR_LP -17
+#define SX126X_MAX_PWR_LP 15
+
+#define SX126X_MIN_PWR_HP -9
+#define SX126X_MAX_PWR_HP 22
+
+/**
+ * @brief Precomputed TX configuration for one expected output power
+ *
+ * Built at compile time for the PA of the devicetree compatible and the current
+ * consumption estimates matching the devicetree regulator mode.
+ */
+struct sx126x_hal_context_tx_pwr_cfg_t {
+	int8_t power; /* Chip output power to configure */
+	uint8_t device_sel;
+	uint8_t hp_max;
 	uint8_t pa_duty_cycle;
-	uint8_t pa_hp_sel;
-} sx126x_pa_pwr_cfg_t;
+	uint32_t consumption_ua; /* Estimated TX current */
+};
 
 
 struct sx126x_hal_context_cfg_t {
@@ -44,6 +64,10 @@ struct sx126x_hal_context_cfg_t {
 
 	bool dio2_as_rf_switch;
 	struct sx126x_hal_context_tcxo_cfg_t tcxo_cfg; /* TCXO config, says if dio3-tcxo */
+	struct gpio_dt_spec tcxo_power;       /* TCXO supply pin, optional */
+	struct gpio_dt_spec antenna_enable;   /* Antenna switch supply pin, optional */
+	struct gpio_dt_spec tx_enable;        /* Antenna switch TX path pin, optional */
+	struct gpio_dt_spec rx_enable;        /* Antenna switch RX path pin, optional */
 	uint8_t capa_xta; /* set to 0xFF if not configured*/
 	uint8_t capa_xtb; /* set to 0xFF if not configured*/
 
@@ -51,6 +75,10 @@ struct sx126x_hal_context_cfg_t {
 	bool rx_boosted; /* RXBoosted option */
 
 	uint8_t tx_offset; /* Board TX power offset */
+
+	const struct sx126x_hal_context_tx_pwr_cfg_t *tx_pwr_table; /* One entry per dBm from tx_pwr_min */
+	int8_t tx_pwr_min;
+	int8_t tx_pwr_max;
 };
 
 
@@ -67,8 +95,9 @@ typedef enum {
 typedef void (*event_cb_t)(const struct device *dev);
 
 struct sx126x_hal_context_data_t {
-#ifdef CONFIG_LORA_BASICS_MODEM_DRIVERS_EVENT_TRIGGER
 	const struct device *sx126x_dev;
+#ifdef CONFIG_LORA_BASICS_MODEM_DRIVERS_EVENT_TRIGGER
+	atomic_t dio_fired; /* BIT(n) when DIOn fired since the last IRQ fetch */
 	struct gpio_callback dio1_cb; /* event callback structure */
 	struct gpio_callback dio2_cb; /* event callback structure */
 	struct gpio_callback dio3_cb; /* event callback structure */
@@ -85,11 +114,94 @@ struct sx126x_hal_context_data_t {
 #endif /* CONFIG_LORA_BASICS_MODEM_DRIVERS_EVENT_TRIGGER */
 	radio_sleep_status_t radio_status;
 	uint8_t tx_offset; /* Board TX power offset at reset */
+	bool tcxo_on;             /* tcxo_power is active */
+	k_timepoint_t tcxo_ready; /* End of the TCXO startup delay */
+#ifdef CONFIG_LORA_BASICS_MODEM_DRIVERS_ENERGY
+	struct lora_lbm_energy energy;
+	bool energy_gfsk;          /* Last packet type set is GFSK */
+	bool energy_rx_continuous; /* Ongoing reception has no timeout */
+#endif /* CONFIG_LORA_BASICS_MODEM_DRIVERS_ENERGY */
+#ifdef CONFIG_LORA_BASICS_MODEM_DRIVERS_BUS_LOCK
+	struct lora_lbm_bus bus;
+#endif /* CONFIG_LORA_BASICS_MODEM_DRIVERS_BUS_LOCK */
+#ifdef CONFIG_SEMTECH_SX126X_IRQ_FETCH
+	struct k_spinlock irq_lock;
+	uint16_t irq_cache;  /* IRQ flags fetched and cleared by the driver, not read by the RAL yet */
+	bool irq_cache_valid; /* The RAL reads and clears the cache instead of the chip */
+	uint8_t irq_cache_dio; /* BIT(n) when DIOn fired for the cached flags */
+#endif /* CONFIG_SEMTECH_SX126X_IRQ_FETCH */
+#ifdef CONFIG_SEMTECH_SX126X_STM32WL
+	bool irq_enabled; /* Radio interrupt enabled by the user, see lora_transceiver_board_enable_interrupt */
+#endif /* CONFIG_SEMTECH_SX126X_STM32WL */
 };
 
 
+#ifdef CONFIG_SEMTECH_SX126X_IRQ_FETCH
+/**
+ * @brief Get the IRQ status fetched by the driver, and the DIO lines that fired for it
+ *
+ * While valid, the RAL is served this status instead of reading it from the chip.
+ *
+ * @param dev sx126x device
+ * @param irqs IRQ flags fetched and not cleared by the RAL yet
+ * @param dio BIT(n) when DIOn fired for these flags, 0 when not known
+ * @return true when the cache is valid
+ */
+static inline bool sx126x_hal_context_get_irq_cache(const struct device *dev, uint16_t *irqs,
+						    uint8_t *dio)
+{
+	struct sx126x_hal_context_data_t *data = dev->data;
+	k_spinlock_key_t key = k_spin_lock(&data->irq_lock);
+	bool valid = data->irq_cache_valid;
+
+	*irqs = data->irq_cache;
+	*dio = data->irq_cache_dio;
+	k_spin_unlock(&data->irq_lock, key);
+	return valid;
+}
+#endif /* CONFIG_SEMTECH_SX126X_IRQ_FETCH */
+
 // FIXME: sx126x_standby_cfgs_e, sx126x_reg_mods_e, sx126x_tcxo_ctrl_voltages_e
 
+/**
+ * @brief Get the precomputed TX configuration of the device PA
+ *
+ * @param config sx126x device configuration
+ * @param power Expected output power in dBm, already clamped to the PA range
+ * @return Table entry
+ */
+static inline const struct sx126x_hal_context_tx_pwr_cfg_t *
+sx126x_hal_context_get_tx_pwr_cfg(const struct sx126x_hal_context_cfg_t *config, int16_t power)
+{
+	return &config->tx_pwr_table[power - config->tx_pwr_min];
+}
+
+#ifdef CONFIG_SEMTECH_SX126X_STM32WL
+/* The radio integrated in the STM32WL, there is only one */
+#define SX126X_STM32WL_NODE DT_COMPAT_GET_ANY_STATUS_OKAY(st_stm32wl_subghz_radio_new)
+
+/**
+ * @brief Unmask the radio interrupt once the HAL cleared the IRQ status
+ *
+ * The STM32WL radio interrupt is level triggered, it stays masked from its
+ * handler until the IRQ status is cleared.
+ */
+void sx126x_stm32wl_board_on_irq_clear(const struct device *dev);
+#endif /* CONFIG_SEMTECH_SX126X_STM32WL */
+
+#ifdef CONFIG_LORA_BASICS_MODEM_DRIVERS_ENERGY
+/**
+ * @brief Energy accounting hooks, called by the HAL and the board
+ *
+ */
+void sx126x_energy_init(const struct device *dev);
+void sx126x_energy_set_tx_cfg(const void *context,
+	const ral_sx126x_bsp_tx_cfg_output_params_t *tx_cfg);
+void sx126x_energy_on_command(const struct device *dev, const uint8_t *command,
+	uint16_t command_length);
+void sx126x_energy_on_wakeup(const struct device *dev);
+void sx126x_energy_on_event(const struct device *dev);
+#endif /* CONFIG_LORA_BASICS_MODEM_DRIVERS_ENERGY */
 
 #ifdef __cplusplus
 }
@@ -0,0 +1,158 @@
+/*
+ * Copyright (c) 2024 Semtech Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef SX126X_TX_PWR_CONSUMPTION_H
+#define SX126X_TX_PWR_CONSUMPTION_H
+
+/*
+ * Estimated radio current consumption in TX, in uA, one value per dBm of expected
+ * output power. These lists are expanded at build time into the per-device TX
+ * power table, see SX126X_TX_PWR_TABLE in sx126x_board.c.
+ */
+
+/* DC-DC regulator, SX1261 low power PA, from -17dBm to +15dBm */
+#define SX126X_TX_PWR_UA_DCDC_LP \
+	5200,   /* -17 dBm */ \
+	5400,   /* -16 dBm */ \
+	5600,   /* -15 dBm */ \
+	5700,   /* -14 dBm */ \
+	5800,   /* -13 dBm */ \
+	6000,   /* -12 dBm */ \
+	6100,   /* -11 dBm */ \
+	6200,   /* -10 dBm */ \
+	6500,   /*  -9 dBm */ \
+	6800,   /*  -8 dBm */ \
+	7000,   /*  -7 dBm */ \
+	7300,   /*  -6 dBm */ \
+	7500,   /*  -5 dBm */ \
+	7900,   /*  -4 dBm */ \
+	8300,   /*  -3 dBm */ \
+	8800,   /*  -2 dBm */ \
+	9300,   /*  -1 dBm */ \
+	9800,   /*   0 dBm */ \
+	10600,  /*   1 dBm */ \
+	11400,  /*   2 dBm */ \
+	12200,  /*   3 dBm */ \
+	12900,  /*   4 dBm */ \
+	13800,  /*   5 dBm */ \
+	14700,  /*   6 dBm */ \
+	15700,  /*   7 dBm */ \
+	16600,  /*   8 dBm */ \
+	17900,  /*   9 dBm */ \
+	18500,  /*  10 dBm */ \
+	20500,  /*  11 dBm */ \
+	21900,  /*  12 dBm */ \
+	23500,  /*  13 dBm */ \
+	25500,  /*  14 dBm */ \
+	32500   /*  15 dBm */
+
+/* LDO regulator, SX1261 low power PA, from -17dBm to +15dBm */
+#define SX126X_TX_PWR_UA_LDO_LP \
+	9800,   /* -17 dBm */ \
+	10300,  /* -16 dBm */ \
+	10500,  /* -15 dBm */ \
+	10800,  /* -14 dBm */ \
+	11100,  /* -13 dBm */ \
+	11300,  /* -12 dBm */ \
+	11600,  /* -11 dBm */ \
+	11900,  /* -10 dBm */ \
+	12400,  /*  -9 dBm */ \
+	12900,  /*  -8 dBm */ \
+	13400,  /*  -7 dBm */ \
+	13900,  /*  -6 dBm */ \
+	14500,  /*  -5 dBm */ \
+	15300,  /*  -4 dBm */ \
+	16000,  /*  -3 dBm */ \
+	17000,  /*  -2 dBm */ \
+	18000,  /*  -1 dBm */ \
+	19000,  /*   0 dBm */ \
+	20600,  /*   1 dBm */ \
+	22000,  /*   2 dBm */ \
+	23500,  /*   3 dBm */ \
+	24900,  /*   4 dBm */ \
+	26600,  /*   5 dBm */ \
+	28400,  /*   6 dBm */ \
+	30200,  /*   7 dBm */ \
+	32000,  /*   8 dBm */ \
+	34300,  /*   9 dBm */ \
+	36600,  /*  10 dBm */ \
+	39200,  /*  11 dBm */ \
+	41700,  /*  12 dBm */ \
+	44700,  /*  13 dBm */ \
+	48200,  /*  14 dBm */ \
+	52200   /*  15 dBm */
+
+/* DC-DC regulator, SX1262/SX1268 high power PA, from -9dBm to +22dBm */
+#define SX126X_TX_PWR_UA_DCDC_HP \
+	24000,  /*  -9 dBm */ \
+	25400,  /*  -8 dBm */ \
+	26700,  /*  -7 dBm */ \
+	28000,  /*  -6 dBm */ \
+	30600,  /*  -5 dBm */ \
+	31900,  /*  -4 dBm */ \
+	33200,  /*  -3 dBm */ \
+	35700,  /*  -2 dBm */ \
+	38200,  /*  -1 dBm */ \
+	40600,  /*   0 dBm */ \
+	42900,  /*   1 dBm */ \
+	46200,  /*   2 dBm */ \
+	48200,  /*   3 dBm */ \
+	51800,  /*   4 dBm */ \
+	54100,  /*   5 dBm */ \
+	57000,  /*   6 dBm */ \
+	60300,  /*   7 dBm */ \
+	63500,  /*   8 dBm */ \
+	67100,  /*   9 dBm */ \
+	70500,  /*  10 dBm */ \
+	74200,  /*  11 dBm */ \
+	78400,  /*  12 dBm */ \
+	83500,  /*  13 dBm */ \
+	89300,  /*  14 dBm */ \
+	92400,  /*  15 dBm */ \
+	94500,  /*  16 dBm */ \
+	95400,  /*  17 dBm */ \
+	97500,  /*  18 dBm */ \
+	100100, /*  19 dBm */ \
+	103800, /*  20 dBm */ \
+	109100, /*  21 dBm */ \
+	117900  /*  22 dBm */
+
+/* LDO regulator, SX1262/SX1268 high power PA, from -9dBm to +22dBm */
+#define SX126X_TX_PWR_UA_LDO_HP \
+	25900,  /*  -9 dBm */ \
+	27400,  /*  -8 dBm */ \
+	28700,  /*  -7 dBm */ \
+	30000,  /*  -6 dBm */ \
+	32600,  /*  -5 dBm */ \
+	33900,  /*  -4 dBm */ \
+	35200,  /*  -3 dBm */ \
+	37700,  /*  -2 dBm */ \
+	40100,  /*  -1 dBm */ \
+	42600,  /*   0 dBm */ \
+	44900,  /*   1 dBm */ \
+	48200,  /*   2 dBm */ \
+	50200,  /*   3 dBm */ \
+	53800,  /*   4 dBm */ \
+	56100,  /*   5 dBm */ \
+	59000,  /*   6 dBm */ \
+	62300,  /*   7 dBm */ \
+	65500,  /*   8 dBm */ \
+	69000,  /*   9 dBm */ \
+	72500,  /*  10 dBm */ \
+	76200,  /*  11 dBm */ \
+	80400,  /*  12 dBm */ \
+	85400,  /*  13 dBm */ \
+	90200,  /*  14 dBm */ \
+	94400,  /*  15 dBm */ \
+	96500,  /*  16 dBm */ \
+	97700,  /*  17 dBm */ \
+	99500,  /*  18 dBm */ \
+	102100, /*  19 dBm */ \
+	105800, /*  20 dBm */ \
+	111000, /*  21 dBm */ \
+	119800  /*  22 dBm */
+
+#endif /* SX126X_TX_PWR_CONSUMPTION_H */
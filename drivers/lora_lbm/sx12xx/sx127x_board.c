@@ -0,0 +1,335 @@
+/*
+ * Copyright (c) 2024 Semtech Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr/device.h>
+#include <zephyr/devicetree.h>
+#include <zephyr/drivers/gpio.h>
+#include <zephyr/drivers/spi.h>
+#include <zephyr/kernel.h>
+#include <zephyr/pm/device.h>
+
+#include <zephyr/logging/log.h>
+LOG_MODULE_REGISTER(sx127x_board, CONFIG_LORA_BASICS_MODEM_DRIVERS_LOG_LEVEL);
+
+#include "lora_lbm_transceiver.h"
+#include "sx127x_hal_context.h"
+
+#define SX127X_SPI_OPERATION (SPI_WORD_SET(8) | SPI_OP_MODE_MASTER | SPI_TRANSFER_MSB)
+
+/**
+ * @brief Deliver the pending radio events, in the trigger mode context
+ *
+ * A timeout emulated by the driver timer is delivered as a radio event, after the
+ * driver recorded it.
+ *
+ * @param data
+ */
+static void sx127x_board_process(struct sx127x_hal_context_data_t *data)
+{
+	if (atomic_test_and_clear_bit(&data->pending, SX127X_PENDING_TIMER) && data->timer_cb) {
+		data->timer_cb(&data->radio);
+	}
+#ifdef CONFIG_LORA_BASICS_MODEM_DRIVERS_EVENT_TRIGGER
+	if (data->event_interrupt_cb) {
+		data->event_interrupt_cb(data->sx127x_dev);
+	}
+#endif /* CONFIG_LORA_BASICS_MODEM_DRIVERS_EVENT_TRIGGER */
+}
+
+/**
+ * @brief Hand a radio event over to the trigger mode
+ *
+ * @param data
+ */
+static void sx127x_board_on_event(struct sx127x_hal_context_data_t *data)
+{
+#ifdef CONFIG_LORA_BASICS_MODEM_DRIVERS_EVENT_TRIGGER_OWN_THREAD
+	k_sem_give(&data->trig_sem);
+#elif defined(CONFIG_LORA_BASICS_MODEM_DRIVERS_EVENT_TRIGGER_GLOBAL_THREAD)
+	k_work_submit(&data->work);
+#else
+	// Without event trigger, only the driver timer is delivered, from its expiry
+	sx127x_board_process(data);
+#endif
+}
+
+/**
+ * @brief Expiry of the driver timer
+ *
+ * @param timer
+ */
+static void sx127x_board_timer_expired(struct k_timer *timer)
+{
+	struct sx127x_hal_context_data_t *data =
+		CONTAINER_OF(timer, struct sx127x_hal_context_data_t, timer);
+
+	atomic_set_bit(&data->pending, SX127X_PENDING_TIMER);
+	sx127x_board_on_event(data);
+}
+
+#ifdef CONFIG_LORA_BASICS_MODEM_DRIVERS_EVENT_TRIGGER
+/* The DIO lines are held until the IRQ flags are cleared, so an edge trigger never fires twice */
+static void sx127x_board_dio0_callback(const struct device *dev, struct gpio_callback *cb, uint32_t pins)
+{
+	sx127x_board_on_event(CONTAINER_OF(cb, struct sx127x_hal_context_data_t, dio0_cb));
+}
+static void sx127x_board_dio1_callback(const struct device *dev, struct gpio_callback *cb, uint32_t pins)
+{
+	sx127x_board_on_event(CONTAINER_OF(cb, struct sx127x_hal_context_data_t, dio1_cb));
+}
+static void sx127x_board_dio2_callback(const struct device *dev, struct gpio_callback *cb, uint32_t pins)
+{
+	sx127x_board_on_event(CONTAINER_OF(cb, struct sx127x_hal_context_data_t, dio2_cb));
+}
+#endif /* CONFIG_LORA_BASICS_MODEM_DRIVERS_EVENT_TRIGGER */
+
+#ifdef CONFIG_LORA_BASICS_MODEM_DRIVERS_EVENT_TRIGGER_OWN_THREAD
+static void sx127x_thread(struct sx127x_hal_context_data_t *data)
+{
+	while (1) {
+		k_sem_take(&data->trig_sem, K_FOREVER);
+		sx127x_board_process(data);
+	}
+}
+#endif /* CONFIG_LORA_BASICS_MODEM_DRIVERS_EVENT_TRIGGER_OWN_THREAD */
+
+#ifdef CONFIG_LORA_BASICS_MODEM_DRIVERS_EVENT_TRIGGER_GLOBAL_THREAD
+static void sx127x_work_cb(struct k_work *work)
+{
+	struct sx127x_hal_context_data_t *data =
+		CONTAINER_OF(work, struct sx127x_hal_context_data_t, work);
+
+	sx127x_board_process(data);
+}
+#endif /* CONFIG_LORA_BASICS_MODEM_DRIVERS_EVENT_TRIGGER_GLOBAL_THREAD */
+
+void lora_transceiver_board_attach_interrupt(const struct device *dev, event_cb_t cb)
+{
+#ifdef CONFIG_LORA_BASICS_MODEM_DRIVERS_EVENT_TRIGGER
+	struct sx127x_hal_context_data_t *data = dev->data;
+	data->event_interrupt_cb = cb;
+#else
+	LOG_ERR("Event trigger not supported!");
+#endif // CONFIG_LORA_BASICS_MODEM_DRIVERS_EVENT_TRIGGER
+}
+
+void lora_transceiver_board_enable_interrupt(const struct device *dev)
+{
+#ifdef CONFIG_LORA_BASICS_MODEM_DRIVERS_EVENT_TRIGGER
+	const struct sx127x_hal_context_cfg_t *config = dev->config;
+	gpio_pin_interrupt_configure_dt(&config->dio0, GPIO_INT_EDGE_TO_ACTIVE);
+	if (config->dio1.port) {
+		gpio_pin_interrupt_configure_dt(&config->dio1, GPIO_INT_EDGE_TO_ACTIVE);
+	}
+	if (config->dio2.port) {
+		gpio_pin_interrupt_configure_dt(&config->dio2, GPIO_INT_EDGE_TO_ACTIVE);
+	}
+#else
+	LOG_ERR("Event trigger not supported!");
+#endif // CONFIG_LORA_BASICS_MODEM_DRIVERS_EVENT_TRIGGER
+}
+
+void lora_transceiver_board_disable_interrupt(const struct device *dev)
+{
+#ifdef CONFIG_LORA_BASICS_MODEM_DRIVERS_EVENT_TRIGGER
+	const struct sx127x_hal_context_cfg_t *config = dev->config;
+	gpio_pin_interrupt_configure_dt(&config->dio0, GPIO_INT_DISABLE);
+	if (config->dio1.port) {
+		gpio_pin_interrupt_configure_dt(&config->dio1, GPIO_INT_DISABLE);
+	}
+	if (config->dio2.port) {
+		gpio_pin_interrupt_configure_dt(&config->dio2, GPIO_INT_DISABLE);
+	}
+#else
+	LOG_ERR("Event trigger not supported!");
+#endif // CONFIG_LORA_BASICS_MODEM_DRIVERS_EVENT_TRIGGER
+}
+
+bool lora_transceiver_board_is_event_pending(const struct device *dev)
+{
+#ifdef CONFIG_LORA_BASICS_MODEM_DRIVERS_EVENT_TRIGGER
+	const struct sx127x_hal_context_cfg_t *config = dev->config;
+	struct sx127x_hal_context_data_t *data = dev->data;
+
+#ifdef CONFIG_LORA_BASICS_MODEM_DRIVERS_EVENT_TRIGGER_OWN_THREAD
+	if (k_sem_count_get(&data->trig_sem) > 0) {
+		return false;
+	}
+#elif defined(CONFIG_LORA_BASICS_MODEM_DRIVERS_EVENT_TRIGGER_GLOBAL_THREAD)
+	if (k_work_busy_get(&data->work) & (K_WORK_QUEUED | K_WORK_RUNNING)) {
+		return false;
+	}
+#endif
+	if (gpio_pin_get_dt(&config->dio0) == 1) {
+		return true;
+	}
+	// DIO1 is the LoRa RX timeout, the FSK mappings of DIO1 toggle with the FIFO level
+	return data->lora_mode && config->dio1.port && (gpio_pin_get_dt(&config->dio1) == 1);
+#else
+	ARG_UNUSED(dev);
+	return false;
+#endif // CONFIG_LORA_BASICS_MODEM_DRIVERS_EVENT_TRIGGER
+}
+
+uint32_t lora_transceiver_get_tcxo_startup_delay_ms(const struct device *dev)
+{
+	const struct sx127x_hal_context_cfg_t *config = dev->config;
+	return config->tcxo_wakeup_time_ms;
+}
+
+const void *lora_transceiver_get_ral_context(const struct device *dev)
+{
+	struct sx127x_hal_context_data_t *data = dev->data;
+	return &data->radio;
+}
+
+static int sx127x_init(const struct device *dev)
+{
+	const struct sx127x_hal_context_cfg_t *config = dev->config;
+	struct sx127x_hal_context_data_t *data = dev->data;
+	int ret;
+
+	if (!device_is_ready(config->spi.bus)) {
+		LOG_ERR("Could not find SPI device");
+		return -EINVAL;
+	}
+
+	// Reset pin, floating out of the resets
+	ret = gpio_pin_configure_dt(&config->reset, GPIO_INPUT);
+	if (ret < 0) {
+		LOG_ERR("Could not configure reset gpio");
+		return ret;
+	}
+
+	// DIO0 event pin
+	ret = gpio_pin_configure_dt(&config->dio0, GPIO_INPUT);
+	if (ret < 0) {
+		LOG_ERR("Could not configure DIO0 event gpio");
+		return ret;
+	}
+	// DIO1 event pin
+	if (config->dio1.port) {
+		ret = gpio_pin_configure_dt(&config->dio1, GPIO_INPUT);
+		if (ret < 0) {
+			LOG_ERR("Could not configure DIO1 event gpio");
+			return ret;
+		}
+	}
+	// DIO2 event pin
+	if (config->dio2.port) {
+		ret = gpio_pin_configure_dt(&config->dio2, GPIO_INPUT);
+		if (ret < 0) {
+			LOG_ERR("Could not configure DIO2 event gpio");
+			return ret;
+		}
+	}
+
+	data->radio.hal_context = (void *)dev;
+	data->tx_offset = config->tx_offset;
+	k_timer_init(&data->timer, sx127x_board_timer_expired, NULL);
+#ifdef CONFIG_LORA_BASICS_MODEM_DRIVERS_BUS_LOCK
+	lora_lbm_bus_init(&data->bus, &config->spi);
+#endif /* CONFIG_LORA_BASICS_MODEM_DRIVERS_BUS_LOCK */
+
+	// Event pin trigger config
+#ifdef CONFIG_LORA_BASICS_MODEM_DRIVERS_EVENT_TRIGGER
+	data->sx127x_dev = dev;
+
+#ifdef CONFIG_LORA_BASICS_MODEM_DRIVERS_EVENT_TRIGGER_GLOBAL_THREAD
+	data->work.handler = sx127x_work_cb;
+#elif defined(CONFIG_LORA_BASICS_MODEM_DRIVERS_EVENT_TRIGGER_OWN_THREAD)
+	k_sem_init(&data->trig_sem, 0, K_SEM_MAX_LIMIT);
+	k_thread_create(&data->thread, data->thread_stack,
+		CONFIG_LORA_BASICS_MODEM_DRIVERS_EVENT_TRIGGER_THREAD_STACK_SIZE,
+		(k_thread_entry_t)sx127x_thread, data, NULL, NULL,
+		K_PRIO_COOP(CONFIG_LORA_BASICS_MODEM_DRIVERS_EVENT_TRIGGER_THREAD_PRIORITY), 0, K_NO_WAIT);
+#endif // CONFIG_LORA_BASICS_MODEM_DRIVERS_EVENT_TRIGGER_OWN_THREAD
+
+	gpio_init_callback(&data->dio0_cb, sx127x_board_dio0_callback, BIT(config->dio0.pin));
+	if (gpio_add_callback(config->dio0.port, &data->dio0_cb)) {
+		LOG_ERR("Could not set dio0 pin callback");
+		return -EIO;
+	}
+	if (config->dio1.port) {
+		gpio_init_callback(&data->dio1_cb, sx127x_board_dio1_callback, BIT(config->dio1.pin));
+		if (gpio_add_callback(config->dio1.port, &data->dio1_cb)) {
+			LOG_ERR("Could not set dio1 pin callback");
+			return -EIO;
+		}
+	}
+	if (config->dio2.port) {
+		gpio_init_callback(&data->dio2_cb, sx127x_board_dio2_callback, BIT(config->dio2.pin));
+		if (gpio_add_callback(config->dio2.port, &data->dio2_cb)) {
+			LOG_ERR("Could not set dio2 pin callback");
+			return -EIO;
+		}
+	}
+#endif // CONFIG_LORA_BASICS_MODEM_DRIVERS_EVENT_TRIGGER
+
+	return ret;
+}
+
+#if IS_ENABLED(CONFIG_PM_DEVICE)
+/**
+ * @brief Power management action define.
+ * Not implemented yet.
+ *
+ * @param dev
+ * @param action
+ * @return int
+ */
+static int sx127x_pm_action(const struct device *dev, enum pm_device_action action)
+{
+	return 0;
+}
+#endif // IS_ENABLED(CONFIG_PM_DEVICE)
+
+/*
+ * Device creation macro.
+ */
+
+#define CONFIGURE_GPIO_IF_IN_DT(node_id, name, dt_prop)                       \
+	COND_CODE_1(DT_NODE_HAS_PROP(node_id, dt_prop),                           \
+		(.name = GPIO_DT_SPEC_GET(node_id, dt_prop),),                        \
+		())
+
+/* RFO starts lower on SX1272 */
+#define SX127X_RFO_MIN_PWR(node_id) \
+	COND_CODE_1(DT_NODE_HAS_COMPAT(node_id, semtech_sx1272_new), \
+		(SX1272_MIN_PWR_RFO), (SX1276_MIN_PWR_RFO))
+
+#define SX127X_CONFIG(node_id)                                                \
+	{                                                                         \
+		.spi = SPI_DT_SPEC_GET(node_id, SX127X_SPI_OPERATION, 0),             \
+		.reset = GPIO_DT_SPEC_GET(node_id, reset_gpios),                      \
+		.dio0 = GPIO_DT_SPEC_GET(node_id, dio0_gpios),                        \
+		CONFIGURE_GPIO_IF_IN_DT(node_id, dio1, dio1_gpios)                    \
+		CONFIGURE_GPIO_IF_IN_DT(node_id, dio2, dio2_gpios)                    \
+		.pa_boost = DT_ENUM_HAS_VALUE(node_id, power_amplifier_output, pa_boost), \
+		.tx_pwr_min = COND_CODE_1(DT_ENUM_HAS_VALUE(node_id, power_amplifier_output, pa_boost), \
+			(SX127X_MIN_PWR_PA_BOOST), (SX127X_RFO_MIN_PWR(node_id))),        \
+		.tx_pwr_max = COND_CODE_1(DT_ENUM_HAS_VALUE(node_id, power_amplifier_output, pa_boost), \
+			(SX127X_MAX_PWR_PA_BOOST), (SX127X_MAX_PWR_RFO)),                 \
+		.tcxo_wakeup_time_ms = DT_PROP(node_id, tcxo_wakeup_time),            \
+		.tx_offset = DT_PROP_OR(node_id, tx_power_offset, 0),                 \
+	}
+
+#define SX127X_DEVICE_INIT(node_id)                                           \
+	DEVICE_DT_DEFINE(node_id, sx127x_init, PM_DEVICE_DT_GET(node_id),         \
+			&sx127x_data_##node_id, &sx127x_config_##node_id,                 \
+			POST_KERNEL, CONFIG_LORA_BASICS_MODEM_DRIVERS_INIT_PRIORITY, NULL);
+
+#define SX127X_DEFINE(node_id)                                                                    \
+	BUILD_ASSERT(DT_PROP(node_id, spi_max_frequency) <= SX127X_SPI_MAX_FREQUENCY,                 \
+		     "SX127x SPI clock is limited to 10MHz");                                         \
+	static struct sx127x_hal_context_data_t sx127x_data_##node_id;                                \
+	static const struct sx127x_hal_context_cfg_t sx127x_config_##node_id = SX127X_CONFIG(node_id);   \
+	PM_DEVICE_DT_DEFINE(node_id, sx127x_pm_action);                                          \
+	SX127X_DEVICE_INIT(node_id)
+
+DT_FOREACH_STATUS_OKAY(semtech_sx1272_new, SX127X_DEFINE)
+DT_FOREACH_STATUS_OKAY(semtech_sx1276_new, SX127X_DEFINE)
+DT_FOREACH_STATUS_OKAY(semtech_sx1278_new, SX127X_DEFINE)
@@ -0,0 +1,265 @@
+/*
+ * Copyright (c) 2024 Semtech Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr/device.h>
+#include <zephyr/drivers/gpio.h>
+#include <zephyr/drivers/spi.h>
+#include <zephyr/kernel.h>
+#include <zephyr/types.h>
+
+#include "sx127x_hal.h"
+#include "sx127x_hal_context.h"
+#include "lora_lbm_stats.h"
+#include "lora_lbm_transceiver.h"
+#include "lora_lbm_tracing.h"
+
+#include <zephyr/logging/log.h>
+LOG_MODULE_REGISTER(sx127x_hal, CONFIG_LORA_BASICS_MODEM_DRIVERS_LOG_LEVEL);
+
+/* Registers are written with the MSB of the address set */
+#define SX127X_HAL_WRITE_ACCESS 0x80
+
+/* RegOpMode, its LongRangeMode bit and the TX mode */
+#define SX127X_HAL_REG_OP_MODE 0x01
+#define SX127X_HAL_OP_MODE_LORA BIT(7)
+#define SX127X_HAL_OP_MODE_MASK 0x07
+#define SX127X_HAL_OP_MODE_TX 0x03
+
+#ifdef CONFIG_LORA_BASICS_MODEM_DRIVERS_STATS
+/* RegIrqFlags in LoRa mode */
+#define SX127X_HAL_REG_LORA_IRQ_FLAGS 0x12
+
+/* LoRa IRQ flags */
+static const uint32_t sx127x_hal_stats_irqs[][2] = {
+	{ BIT(0), LORA_LBM_STATS_IRQ_CAD_DETECTED },
+	{ BIT(2), LORA_LBM_STATS_IRQ_CAD_DONE },
+	{ BIT(3), LORA_LBM_STATS_IRQ_TX_DONE },
+	{ BIT(5), LORA_LBM_STATS_IRQ_CRC_ERROR },
+	{ BIT(6), LORA_LBM_STATS_IRQ_RX_DONE },
+	{ BIT(7), LORA_LBM_STATS_IRQ_TIMEOUT },
+};
+
+/* LORA_LBM_STATS_IRQ_* flags of the chip IRQ flags */
+static uint32_t sx127x_hal_stats_convert(uint32_t chip_irqs)
+{
+	uint32_t irqs = 0;
+
+	for (int i = 0; i < ARRAY_SIZE(sx127x_hal_stats_irqs); i++) {
+		if (chip_irqs & sx127x_hal_stats_irqs[i][0]) {
+			irqs |= sx127x_hal_stats_irqs[i][1];
+			chip_irqs &= ~sx127x_hal_stats_irqs[i][0];
+		}
+	}
+	if (chip_irqs) {
+		irqs |= LORA_LBM_STATS_IRQ_OTHER;
+	}
+	return irqs;
+}
+#endif /* CONFIG_LORA_BASICS_MODEM_DRIVERS_STATS */
+
+/**
+ * @brief SPI transfer with the transceiver, in the ongoing radio transaction if any
+ *
+ * @param dev
+ * @param tx
+ * @param rx
+ */
+static int sx127x_hal_spi_transceive(const struct device *dev,
+	const struct spi_buf_set *tx, const struct spi_buf_set *rx)
+{
+#ifdef CONFIG_LORA_BASICS_MODEM_DRIVERS_BUS_LOCK
+	struct sx127x_hal_context_data_t *data = dev->data;
+
+	return lora_lbm_bus_transceive(&data->bus, tx, rx);
+#else
+	const struct sx127x_hal_context_cfg_t *config = dev->config;
+
+	return spi_transceive_dt(&config->spi, tx, rx);
+#endif /* CONFIG_LORA_BASICS_MODEM_DRIVERS_BUS_LOCK */
+}
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PUBLIC FUNCTIONS DEFINITION ---------------------------------------------
+ */
+
+/* There is no BUSY line: the registers are accessible in every mode, sleep included */
+
+sx127x_hal_status_t sx127x_hal_write(const sx127x_t* radio, const uint16_t address,
+	const uint8_t* data, const uint16_t data_len)
+{
+	const struct device *dev = sx127x_hal_context_get_dev(radio);
+	struct sx127x_hal_context_data_t *dev_data = dev->data;
+	uint8_t addr = (uint8_t)address | SX127X_HAL_WRITE_ACCESS;
+	int ret;
+
+	LORA_LBM_TRACE_BEGIN(sx127x_write, address);
+
+	const struct spi_buf tx_bufs[] = {
+		{
+			.buf = &addr,
+			.len = sizeof(addr)
+		}, {
+			.buf = (void *)data,
+			.len = data_len
+		},
+	};
+
+	const struct spi_buf_set tx_buf_set = {tx_bufs, .count = ARRAY_SIZE(tx_bufs)};
+
+	ret = sx127x_hal_spi_transceive(dev, &tx_buf_set, NULL);
+	lora_lbm_stats_on_spi(true, sizeof(addr) + data_len, ret == 0);
+	if (ret) {
+		LORA_LBM_TRACE_END(sx127x_write, SX127X_HAL_STATUS_ERROR);
+		return SX127X_HAL_STATUS_ERROR;
+	}
+
+	if ((address == SX127X_HAL_REG_OP_MODE) && (data_len > 0)) {
+		dev_data->lora_mode = (data[0] & SX127X_HAL_OP_MODE_LORA) != 0;
+		if ((data[0] & SX127X_HAL_OP_MODE_MASK) == SX127X_HAL_OP_MODE_TX) {
+			lora_lbm_stats_on_tx_start();
+		}
+	}
+
+#ifdef CONFIG_LORA_BASICS_MODEM_DRIVERS_STATS
+	// Writing a one to a flag clears it
+	if (dev_data->lora_mode && (address == SX127X_HAL_REG_LORA_IRQ_FLAGS) && (data_len > 0)) {
+		lora_lbm_stats_on_irq_clear(sx127x_hal_stats_convert(data[0]));
+	}
+#endif /* CONFIG_LORA_BASICS_MODEM_DRIVERS_STATS */
+
+	LORA_LBM_TRACE_END(sx127x_write, SX127X_HAL_STATUS_OK);
+	return SX127X_HAL_STATUS_OK;
+}
+
+sx127x_hal_status_t sx127x_hal_read(const sx127x_t* radio, const uint16_t address,
+	uint8_t* data, const uint16_t data_len)
+{
+	const struct device *dev = sx127x_hal_context_get_dev(radio);
+	uint8_t addr = (uint8_t)address & ~SX127X_HAL_WRITE_ACCESS;
+	int ret;
+
+	LORA_LBM_TRACE_BEGIN(sx127x_read, address);
+
+	const struct spi_buf tx_bufs[] = {
+		{
+			.buf = &addr,
+			.len = sizeof(addr)
+		}, {
+			.buf = NULL,
+			.len = data_len
+		}
+	};
+
+	const struct spi_buf rx_bufs[] = {
+		{
+			.buf = NULL,
+			.len = sizeof(addr)
+		}, {
+			.buf = data,
+			.len = data_len
+		}
+	};
+
+	const struct spi_buf_set tx_buf_set = {.buffers=tx_bufs, .count = ARRAY_SIZE(tx_bufs)};
+	const struct spi_buf_set rx_buf_set = {.buffers=rx_bufs, .count = ARRAY_SIZE(rx_bufs)};
+
+	ret = sx127x_hal_spi_transceive(dev, &tx_buf_set, &rx_buf_set);
+	lora_lbm_stats_on_spi(false, sizeof(addr) + data_len, ret == 0);
+	if (ret) {
+		LORA_LBM_TRACE_END(sx127x_read, SX127X_HAL_STATUS_ERROR);
+		return SX127X_HAL_STATUS_ERROR;
+	}
+
+#ifdef CONFIG_LORA_BASICS_MODEM_DRIVERS_STATS
+	struct sx127x_hal_context_data_t *dev_data = dev->data;
+
+	// The register holds other settings in FSK mode
+	if (dev_data->lora_mode && (address == SX127X_HAL_REG_LORA_IRQ_FLAGS) && (data_len == 1)) {
+		lora_lbm_stats_on_irq_status(sx127x_hal_stats_convert(data[0]));
+	}
+#endif /* CONFIG_LORA_BASICS_MODEM_DRIVERS_STATS */
+	LORA_LBM_TRACE_END(sx127x_read, SX127X_HAL_STATUS_OK);
+	return SX127X_HAL_STATUS_OK;
+}
+
+void sx127x_hal_reset(const sx127x_t* radio)
+{
+	const struct device *dev = sx127x_hal_context_get_dev(radio);
+	const struct sx127x_hal_context_cfg_t *config = dev->config;
+	const struct gpio_dt_spec *nrst = &(config->reset);
+
+	// Drive the reset pin for 100us then leave it floating, the polarity comes from the devicetree
+	gpio_pin_configure_dt(nrst, GPIO_OUTPUT_ACTIVE);
+	k_usleep(100);
+	gpio_pin_configure_dt(nrst, GPIO_INPUT);
+
+	// Wait for the chip to be ready
+	k_msleep(6);
+}
+
+uint32_t sx127x_hal_get_dio_1_pin_state(const sx127x_t* radio)
+{
+	const struct device *dev = sx127x_hal_context_get_dev(radio);
+	const struct sx127x_hal_context_cfg_t *config = dev->config;
+
+	if (!config->dio1.port) {
+		return 0;
+	}
+	return (gpio_pin_get_dt(&config->dio1) > 0) ? 1 : 0;
+}
+
+void sx127x_hal_timer_start(const sx127x_t* radio, const uint32_t time_in_ms,
+	void (*callback)(void* context))
+{
+	const struct device *dev = sx127x_hal_context_get_dev(radio);
+	struct sx127x_hal_context_data_t *data = dev->data;
+
+	k_timer_stop(&data->timer);
+	atomic_clear_bit(&data->pending, SX127X_PENDING_TIMER);
+	data->timer_cb = callback;
+	k_timer_start(&data->timer, K_MSEC(time_in_ms), K_NO_WAIT);
+}
+
+void sx127x_hal_timer_stop(const sx127x_t* radio)
+{
+	const struct device *dev = sx127x_hal_context_get_dev(radio);
+	struct sx127x_hal_context_data_t *data = dev->data;
+
+	k_timer_stop(&data->timer);
+	atomic_clear_bit(&data->pending, SX127X_PENDING_TIMER);
+}
+
+bool sx127x_hal_timer_is_started(const sx127x_t* radio)
+{
+	const struct device *dev = sx127x_hal_context_get_dev(radio);
+	struct sx127x_hal_context_data_t *data = dev->data;
+
+	return k_timer_remaining_ticks(&data->timer) != 0;
+}
+
+int lora_transceiver_prewake(const struct device *dev)
+{
+	// The registers are accessible in sleep, and the oscillator starts with the next mode
+	ARG_UNUSED(dev);
+	return 0;
+}
+
+#ifdef CONFIG_LORA_BASICS_MODEM_DRIVERS_BUS_LOCK
+void lora_transceiver_transaction_begin(const struct device *dev)
+{
+	struct sx127x_hal_context_data_t *data = dev->data;
+
+	lora_lbm_bus_begin(&data->bus);
+}
+
+int lora_transceiver_transaction_end(const struct device *dev)
+{
+	struct sx127x_hal_context_data_t *data = dev->data;
+
+	return lora_lbm_bus_end(&data->bus);
+}
+#endif /* CONFIG_LORA_BASICS_MODEM_DRIVERS_BUS_LOCK */
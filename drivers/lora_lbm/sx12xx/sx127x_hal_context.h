@@ -0,0 +1,113 @@
+/*
+ * Copyright (c) 2024 Semtech Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef SX127X_HAL_CONTEXT_H
+#define SX127X_HAL_CONTEXT_H
+
+#include <zephyr/drivers/gpio.h>
+#include <zephyr/drivers/spi.h>
+#include <zephyr/kernel.h>
+#include <zephyr/sys/atomic.h>
+
+#include <sx127x.h>
+
+#ifdef CONFIG_LORA_BASICS_MODEM_DRIVERS_BUS_LOCK
+#include "lora_lbm_bus.h"
+#endif /* CONFIG_LORA_BASICS_MODEM_DRIVERS_BUS_LOCK */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Output power range of each PA pin, PA_BOOST reaches +20dBm with the high power settings */
+#define SX1272_MIN_PWR_RFO -1
+#define SX1276_MIN_PWR_RFO -4
+#define SX127X_MAX_PWR_RFO 14
+
+#define SX127X_MIN_PWR_PA_BOOST 2
+#define SX127X_MAX_PWR_PA_BOOST 20
+
+/* Highest SPI clock supported by the chip */
+#define SX127X_SPI_MAX_FREQUENCY 10000000
+
+struct sx127x_hal_context_cfg_t {
+	struct spi_dt_spec spi; /* spi peripheral */
+
+	struct gpio_dt_spec reset;  /* reset pin */
+
+	struct gpio_dt_spec dio0;   /* DIO0 pin */
+	struct gpio_dt_spec dio1;   /* DIO1 pin */
+	struct gpio_dt_spec dio2;   /* DIO2 pin */
+
+	bool pa_boost; /* Antenna on PA_BOOST, else on RFO */
+	int8_t tx_pwr_min;
+	int8_t tx_pwr_max;
+
+	uint32_t tcxo_wakeup_time_ms; /* 0 with a crystal */
+
+	uint8_t tx_offset; /* Board TX power offset */
+};
+
+/**
+ * @brief Callback upon firing event trigger
+ *
+ */
+typedef void (*event_cb_t)(const struct device *dev);
+
+/* Bits of sx127x_hal_context_data_t.pending */
+#define SX127X_PENDING_TIMER 0
+
+struct sx127x_hal_context_data_t {
+	/* Driver state, the context given to the radio abstraction layer. Its HAL context is the
+	 * device.
+	 */
+	sx127x_t radio;
+
+#ifdef CONFIG_LORA_BASICS_MODEM_DRIVERS_EVENT_TRIGGER
+	const struct device *sx127x_dev;
+	struct gpio_callback dio0_cb; /* event callback structure */
+	struct gpio_callback dio1_cb; /* event callback structure */
+	struct gpio_callback dio2_cb; /* event callback structure */
+	event_cb_t event_interrupt_cb; /* event interrupt user provided callback */
+
+#ifdef CONFIG_LORA_BASICS_MODEM_DRIVERS_EVENT_TRIGGER_GLOBAL_THREAD
+	struct k_work work;
+#endif /* CONFIG_LORA_BASICS_MODEM_DRIVERS_EVENT_TRIGGER_GLOBAL_THREAD */
+#ifdef CONFIG_LORA_BASICS_MODEM_DRIVERS_EVENT_TRIGGER_OWN_THREAD
+	K_THREAD_STACK_MEMBER(thread_stack, CONFIG_LORA_BASICS_MODEM_DRIVERS_EVENT_TRIGGER_THREAD_STACK_SIZE);
+	struct k_thread thread;
+	struct k_sem trig_sem;
+#endif /* CONFIG_LORA_BASICS_MODEM_DRIVERS_EVENT_TRIGGER_OWN_THREAD */
+#endif /* CONFIG_LORA_BASICS_MODEM_DRIVERS_EVENT_TRIGGER */
+
+	/* Timer of the timeouts the chip does not implement, delivered like the DIO events */
+	struct k_timer timer;
+	void (*timer_cb)(void *context);
+	atomic_t pending;
+
+	bool lora_mode; /* LongRangeMode bit of the last RegOpMode write */
+	uint8_t tx_offset; /* Board TX power offset at reset */
+#ifdef CONFIG_LORA_BASICS_MODEM_DRIVERS_BUS_LOCK
+	struct lora_lbm_bus bus;
+#endif /* CONFIG_LORA_BASICS_MODEM_DRIVERS_BUS_LOCK */
+};
+
+/**
+ * @brief Get the device from the context of the driver and the radio abstraction layer
+ *
+ * @param radio sx127x driver state
+ * @return The sx127x device
+ */
+static inline const struct device *sx127x_hal_context_get_dev(const sx127x_t *radio)
+{
+	return (const struct device *)radio->hal_context;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SX127X_HAL_CONTEXT_H */
@@ -0,0 +1,130 @@
+/*
+ * Copyright (c) 2024 Semtech Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr/kernel.h>
+
+#include "ral_sx127x_bsp.h"
+#include "radio_utilities.h"
+#include "sx127x.h"
+#include "sx127x_hal_context.h"
+
+/* PA_BOOST needs the high power settings above +17dBm */
+#define SX127X_MAX_PWR_PA_BOOST_NORMAL 17
+
+/* The radio abstraction layer context is the driver state, see lora_transceiver_get_ral_context */
+
+void ral_sx127x_bsp_get_tx_cfg(const void* context,
+	const ral_sx127x_bsp_tx_cfg_input_params_t* input_params,
+	ral_sx127x_bsp_tx_cfg_output_params_t* output_params)
+{
+	const struct device *dev = sx127x_hal_context_get_dev(context);
+	const struct sx127x_hal_context_cfg_t *config = dev->config;
+
+	// get board tx power offset
+	int8_t board_tx_pwr_offset_db = radio_utilities_get_tx_power_offset(dev);
+
+	int16_t power = input_params->system_output_pwr_in_dbm + board_tx_pwr_offset_db;
+
+	// Clamp power to the range of the PA pin wired to the antenna
+	power = CLAMP(power, config->tx_pwr_min, config->tx_pwr_max);
+
+	output_params->pa_ramp_time = SX127X_RAMP_40_US;
+	output_params->pa_cfg.pa_select = config->pa_boost ? SX127X_PA_SELECT_BOOST : SX127X_PA_SELECT_RFO;
+	output_params->pa_cfg.is_20_dbm_output_on =
+		config->pa_boost && (power > SX127X_MAX_PWR_PA_BOOST_NORMAL);
+	output_params->chip_output_pwr_in_dbm_configured = (int8_t) power;
+	output_params->chip_output_pwr_in_dbm_expected   = (int8_t) power;
+}
+
+void ral_sx127x_bsp_get_ocp_value(const void* context, uint8_t* ocp_trim_value)
+{
+	// Do nothing, let the driver choose the default values
+}
+
+void radio_utilities_set_tx_power_offset(const void *context, uint8_t tx_pwr_offset_db)
+{
+	const struct device *dev = (const struct device *)context;
+	struct sx127x_hal_context_data_t *data = dev->data;
+	data->tx_offset = tx_pwr_offset_db;
+}
+
+uint8_t radio_utilities_get_tx_power_offset(const void *context)
+{
+	const struct device *dev = (const struct device *)context;
+	struct sx127x_hal_context_data_t *data = dev->data;
+	return data->tx_offset;
+}
+
+/*
+ * Consumption figures from the SX1276/77/78/79 datasheet rev. 7, table 6 (band 1), used for the
+ * whole family. Each one bounds the current from above, up to the output power it is given for.
+ */
+#define SX127X_GFSK_RX_CONSUMPTION 10800
+#define SX127X_GFSK_RX_BOOSTED_CONSUMPTION 11500
+/* The datasheet gives LoRa RX only with LnaBoost off, the BW 500kHz figure is the highest */
+#define SX127X_LORA_RX_CONSUMPTION 12600
+
+static const struct {
+	int8_t power;
+	uint32_t consumption_ua;
+} sx127x_tx_consumption_pa_boost[] = {
+	{ 17, 87000 },
+	{ 20, 120000 },
+}, sx127x_tx_consumption_rfo[] = {
+	{ 7, 20000 },
+	{ 13, 29000 },
+};
+
+__weak ral_status_t ral_sx127x_bsp_get_instantaneous_tx_power_consumption(
+	const void *context,
+	const ral_sx127x_bsp_tx_cfg_output_params_t* tx_cfg_output_params,
+	uint32_t* pwr_consumption_in_ua )
+{
+    const bool pa_boost = tx_cfg_output_params->pa_cfg.pa_select == SX127X_PA_SELECT_BOOST;
+    const size_t count  = pa_boost ? ARRAY_SIZE( sx127x_tx_consumption_pa_boost )
+                                   : ARRAY_SIZE( sx127x_tx_consumption_rfo );
+
+    for( size_t i = 0; i < count; i++ )
+    {
+        int8_t   power = pa_boost ? sx127x_tx_consumption_pa_boost[i].power
+                                  : sx127x_tx_consumption_rfo[i].power;
+        uint32_t ua    = pa_boost ? sx127x_tx_consumption_pa_boost[i].consumption_ua
+                                  : sx127x_tx_consumption_rfo[i].consumption_ua;
+
+        if( tx_cfg_output_params->chip_output_pwr_in_dbm_configured <= power )
+        {
+            *pwr_consumption_in_ua = ua;
+            return RAL_STATUS_OK;
+        }
+    }
+
+    return RAL_STATUS_UNKNOWN_VALUE;
+}
+
+__weak ral_status_t ral_sx127x_bsp_get_instantaneous_gfsk_rx_power_consumption(
+	const void *context,
+	bool rx_boosted,
+	uint32_t* pwr_consumption_in_ua)
+{
+    *pwr_consumption_in_ua = ( rx_boosted ) ? SX127X_GFSK_RX_BOOSTED_CONSUMPTION : SX127X_GFSK_RX_CONSUMPTION;
+
+    return RAL_STATUS_OK;
+}
+
+__weak ral_status_t ral_sx127x_bsp_get_instantaneous_lora_rx_power_consumption(
+	const void *context,
+	bool rx_boosted,
+	uint32_t* pwr_consumption_in_ua)
+{
+    if( rx_boosted )
+    {
+        return RAL_STATUS_UNSUPPORTED_FEATURE;
+    }
+
+    *pwr_consumption_in_ua = SX127X_LORA_RX_CONSUMPTION;
+
+    return RAL_STATUS_OK;
+}
@@ -0,0 +1,327 @@
+/*
+ * Copyright (c) 2024 Semtech Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr/device.h>
+#include <zephyr/drivers/gpio.h>
+#include <zephyr/drivers/spi.h>
+#include <zephyr/kernel.h>
+#include <zephyr/sys/byteorder.h>
+#include <zephyr/types.h>
+
+#include "sx128x_hal.h"
+#include "sx128x_hal_context.h"
+#include "lora_lbm_stats.h"
+#include "lora_lbm_transceiver.h"
+#include "lora_lbm_tracing.h"
+
+#include <zephyr/logging/log.h>
+LOG_MODULE_REGISTER(sx128x_hal, CONFIG_LORA_BASICS_MODEM_DRIVERS_LOG_LEVEL);
+
+/* SX128X_SET_TX, SX128X_SET_SLEEP, SX128X_GET_IRQ_STATUS and SX128X_CLR_IRQ_STATUS opcodes */
+#define SX128X_HAL_SET_TX_OC 0x83
+#define SX128X_HAL_SET_SLEEP_OC 0x84
+#define SX128X_HAL_GET_IRQ_STATUS_OC 0x15
+#define SX128X_HAL_CLR_IRQ_STATUS_OC 0x97
+
+/*
+ * Commands release BUSY within a few us. At the highest LoRa and FLRC bandwidths, sleeping
+ * 100us per command would be longer than a symbol: spin that long before sleeping.
+ */
+#define SX128X_HAL_BUSY_SPIN_US 100
+
+#ifdef CONFIG_LORA_BASICS_MODEM_DRIVERS_BUS_LOCK
+/* SX128X_SET_PKT_PARAMS opcode, opening the commands sequence of a radio operation */
+#define SX128X_HAL_SET_PKT_PARAMS_OC 0x8C
+
+/* Opcodes starting a radio operation or leaving it, closing the commands sequence */
+static bool sx128x_hal_is_sequence_end(uint8_t opcode)
+{
+	switch (opcode) {
+	case 0x80: // SetStandby
+	case 0x82: // SetRx
+	case 0x83: // SetTx
+	case 0x84: // SetSleep
+	case 0x94: // SetRxDutyCycle
+	case 0xC1: // SetFs
+	case 0xC5: // SetCad
+	case 0xD1: // SetTxContinuousWave
+	case 0xD2: // SetTxContinuousPreamble
+		return true;
+	default:
+		return false;
+	}
+}
+#endif /* CONFIG_LORA_BASICS_MODEM_DRIVERS_BUS_LOCK */
+
+#ifdef CONFIG_LORA_BASICS_MODEM_DRIVERS_STATS
+/* IRQ status flags, see sx128x_irq_masks_e */
+static const uint32_t sx128x_hal_stats_irqs[][2] = {
+	{ BIT(0), LORA_LBM_STATS_IRQ_TX_DONE },
+	{ BIT(1), LORA_LBM_STATS_IRQ_RX_DONE },
+	{ BIT(5), LORA_LBM_STATS_IRQ_HEADER_ERROR },
+	{ BIT(6), LORA_LBM_STATS_IRQ_CRC_ERROR },
+	{ BIT(12), LORA_LBM_STATS_IRQ_CAD_DONE },
+	{ BIT(13), LORA_LBM_STATS_IRQ_CAD_DETECTED },
+	{ BIT(14), LORA_LBM_STATS_IRQ_TIMEOUT },
+};
+
+/* LORA_LBM_STATS_IRQ_* flags of the chip IRQ flags */
+static uint32_t sx128x_hal_stats_convert(uint32_t chip_irqs)
+{
+	uint32_t irqs = 0;
+
+	for (int i = 0; i < ARRAY_SIZE(sx128x_hal_stats_irqs); i++) {
+		if (chip_irqs & sx128x_hal_stats_irqs[i][0]) {
+			irqs |= sx128x_hal_stats_irqs[i][1];
+			chip_irqs &= ~sx128x_hal_stats_irqs[i][0];
+		}
+	}
+	if (chip_irqs) {
+		irqs |= LORA_LBM_STATS_IRQ_OTHER;
+	}
+	return irqs;
+}
+#endif /* CONFIG_LORA_BASICS_MODEM_DRIVERS_STATS */
+
+/**
+ * @brief Waits for the BUSY pin of the transceiver to go back down
+ *
+ * @param context
+ */
+static void sx128x_hal_wait_on_busy(const void* context)
+{
+	const struct device *dev = (const struct device *)context;
+	const struct sx128x_hal_context_cfg_t *config = dev->config;
+	int64_t start = k_uptime_ticks();
+	bool ret;
+
+	LORA_LBM_TRACE_BEGIN(busy_wait, 0);
+	ret = WAIT_FOR(gpio_pin_get_dt(&config->busy) == 0, SX128X_HAL_BUSY_SPIN_US,
+		       k_busy_wait(1)) ||
+	      WAIT_FOR(gpio_pin_get_dt(&config->busy) == 0,
+		       (1000 * CONFIG_LORA_BASICS_MODEM_DRIVERS_HAL_WAIT_ON_BUSY_TIMEOUT_MSEC),
+		       k_usleep(100));
+	if (!ret) {
+		LOG_ERR("Timeout of %dms hit when waiting for sx128x busy!",
+			CONFIG_LORA_BASICS_MODEM_DRIVERS_HAL_WAIT_ON_BUSY_TIMEOUT_MSEC);
+		k_oops();
+	}
+	lora_lbm_stats_on_busy_wait(k_ticks_to_us_floor32(k_uptime_ticks() - start));
+	LORA_LBM_TRACE_END(busy_wait, 0);
+}
+
+/**
+ * @brief SPI transfer with the transceiver, in the ongoing radio transaction if any
+ *
+ * @param dev
+ * @param tx
+ * @param rx
+ */
+static int sx128x_hal_spi_transceive(const struct device *dev,
+	const struct spi_buf_set *tx, const struct spi_buf_set *rx)
+{
+#ifdef CONFIG_LORA_BASICS_MODEM_DRIVERS_BUS_LOCK
+	struct sx128x_hal_context_data_t *data = dev->data;
+
+	return lora_lbm_bus_transceive(&data->bus, tx, rx);
+#else
+	const struct sx128x_hal_context_cfg_t *config = dev->config;
+
+	return spi_transceive_dt(&config->spi, tx, rx);
+#endif /* CONFIG_LORA_BASICS_MODEM_DRIVERS_BUS_LOCK */
+}
+
+/**
+ * @brief Wake up the radio and ensure it's ready
+ *
+ * @param context
+ */
+static void sx128x_hal_check_device_ready(const void* context)
+{
+	const struct device *dev = (const struct device *)context;
+	struct sx128x_hal_context_data_t *data = dev->data;
+
+	if (data->radio_status != SX128X_RADIO_SLEEP) {
+		sx128x_hal_wait_on_busy(context);
+	} else {
+		// Busy is HIGH in sleep mode, wake-up the device with a small glitch on NSS
+		const struct sx128x_hal_context_cfg_t *config = dev->config;
+		const struct gpio_dt_spec *cs = &(config->spi.config.cs.gpio);
+
+		gpio_pin_set_dt(cs, 1);
+		k_usleep(100);
+		gpio_pin_set_dt(cs, 0);
+		sx128x_hal_wait_on_busy(context);
+		data->radio_status = SX128X_RADIO_AWAKE;
+	}
+}
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PUBLIC FUNCTIONS DEFINITION ---------------------------------------------
+ */
+
+sx128x_hal_status_t sx128x_hal_write(const void* context,
+	const uint8_t* command, const uint16_t command_length,
+	const uint8_t* data, const uint16_t data_length)
+{
+	const struct device *dev = (const struct device *)context;
+	struct sx128x_hal_context_data_t *dev_data = dev->data;
+	int ret;
+
+	LORA_LBM_TRACE_BEGIN(sx128x_write, command[0]);
+	sx128x_hal_check_device_ready(context);
+
+	const struct spi_buf tx_bufs[] = {
+		{
+			.buf = (void *)command,
+			.len = command_length
+		}, {
+			.buf = (void *)data,
+			.len = data_length
+		},
+	};
+
+	const struct spi_buf_set tx_buf_set = {tx_bufs, .count = ARRAY_SIZE(tx_bufs)};
+
+#ifdef CONFIG_LORA_BASICS_MODEM_DRIVERS_BUS_LOCK
+	if (command[0] == SX128X_HAL_SET_PKT_PARAMS_OC) {
+		lora_lbm_bus_sequence(&dev_data->bus, true);
+	}
+#endif /* CONFIG_LORA_BASICS_MODEM_DRIVERS_BUS_LOCK */
+
+	ret = sx128x_hal_spi_transceive(dev, &tx_buf_set, NULL);
+	lora_lbm_stats_on_spi(true, command_length + data_length, ret == 0);
+	if (ret) {
+		LORA_LBM_TRACE_END(sx128x_write, SX128X_HAL_STATUS_ERROR);
+		return SX128X_HAL_STATUS_ERROR;
+	}
+
+#ifdef CONFIG_LORA_BASICS_MODEM_DRIVERS_BUS_LOCK
+	if (sx128x_hal_is_sequence_end(command[0])) {
+		lora_lbm_bus_sequence(&dev_data->bus, false);
+	}
+#endif /* CONFIG_LORA_BASICS_MODEM_DRIVERS_BUS_LOCK */
+
+	if (command[0] == SX128X_HAL_SET_TX_OC) {
+		lora_lbm_stats_on_tx_start();
+	}
+
+#ifdef CONFIG_LORA_BASICS_MODEM_DRIVERS_STATS
+	if ((command[0] == SX128X_HAL_CLR_IRQ_STATUS_OC) && (command_length == 3)) {
+		lora_lbm_stats_on_irq_clear(sx128x_hal_stats_convert(sys_get_be16(&command[1])));
+	}
+#endif /* CONFIG_LORA_BASICS_MODEM_DRIVERS_STATS */
+
+	// In sleep mode BUSY stays high => do not test it
+	if (command[0] == SX128X_HAL_SET_SLEEP_OC) {
+		dev_data->radio_status = SX128X_RADIO_SLEEP;
+		k_usleep(500);
+	} else {
+		sx128x_hal_check_device_ready(context);
+	}
+
+	LORA_LBM_TRACE_END(sx128x_write, SX128X_HAL_STATUS_OK);
+	return SX128X_HAL_STATUS_OK;
+}
+
+sx128x_hal_status_t sx128x_hal_read(const void* context,
+	const uint8_t* command, const uint16_t command_length,
+	uint8_t* data, const uint16_t data_length)
+{
+	const struct device *dev = (const struct device *)context;
+	int ret;
+
+	LORA_LBM_TRACE_BEGIN(sx128x_read, command[0]);
+	sx128x_hal_check_device_ready(context);
+
+	const struct spi_buf tx_bufs[] = {
+		{
+			.buf = (uint8_t *)command,
+			.len = command_length
+		}, {
+			.buf = NULL,
+			.len = data_length
+		}
+	};
+
+	const struct spi_buf rx_bufs[] = {
+		{
+			.buf = NULL,
+			.len = command_length
+		}, {
+			.buf = data,
+			.len = data_length
+		}
+	};
+
+	const struct spi_buf_set tx_buf_set = {.buffers=tx_bufs, .count = ARRAY_SIZE(tx_bufs)};
+	const struct spi_buf_set rx_buf_set = {.buffers=rx_bufs, .count = ARRAY_SIZE(rx_bufs)};
+
+	ret = sx128x_hal_spi_transceive(dev, &tx_buf_set, &rx_buf_set);
+	lora_lbm_stats_on_spi(false, command_length + data_length, ret == 0);
+	if (ret) {
+		LORA_LBM_TRACE_END(sx128x_read, SX128X_HAL_STATUS_ERROR);
+		return SX128X_HAL_STATUS_ERROR;
+	}
+
+#ifdef CONFIG_LORA_BASICS_MODEM_DRIVERS_STATS
+	if ((command[0] == SX128X_HAL_GET_IRQ_STATUS_OC) && (data_length == 2)) {
+		lora_lbm_stats_on_irq_status(sx128x_hal_stats_convert(sys_get_be16(data)));
+	}
+#endif /* CONFIG_LORA_BASICS_MODEM_DRIVERS_STATS */
+	LORA_LBM_TRACE_END(sx128x_read, SX128X_HAL_STATUS_OK);
+	return SX128X_HAL_STATUS_OK;
+}
+
+sx128x_hal_status_t sx128x_hal_reset(const void* context)
+{
+	const struct device *dev = (const struct device *)context;
+	const struct sx128x_hal_context_cfg_t *config = dev->config;
+	struct sx128x_hal_context_data_t *data = dev->data;
+	const struct gpio_dt_spec *nrst = &(config->reset);
+
+	gpio_pin_set_dt(nrst, 1);
+	k_msleep(5);
+	gpio_pin_set_dt(nrst, 0);
+	k_msleep(5);
+
+#ifdef CONFIG_LORA_BASICS_MODEM_DRIVERS_BUS_LOCK
+	// A sequence cut by the reset never gets its end command
+	lora_lbm_bus_sequence(&data->bus, false);
+#endif /* CONFIG_LORA_BASICS_MODEM_DRIVERS_BUS_LOCK */
+	data->radio_status = SX128X_RADIO_AWAKE;
+	return SX128X_HAL_STATUS_OK;
+}
+
+sx128x_hal_status_t sx128x_hal_wakeup(const void* context)
+{
+	sx128x_hal_check_device_ready(context);
+	return SX128X_HAL_STATUS_OK;
+}
+
+int lora_transceiver_prewake(const struct device *dev)
+{
+	// Always clocked by a crystal, which starts with the wake-up
+	sx128x_hal_check_device_ready(dev);
+	return 0;
+}
+
+#ifdef CONFIG_LORA_BASICS_MODEM_DRIVERS_BUS_LOCK
+void lora_transceiver_transaction_begin(const struct device *dev)
+{
+	struct sx128x_hal_context_data_t *data = dev->data;
+
+	lora_lbm_bus_begin(&data->bus);
+}
+
+int lora_transceiver_transaction_end(const struct device *dev)
+{
+	struct sx128x_hal_context_data_t *data = dev->data;
+
+	return lora_lbm_bus_end(&data->bus);
+}
+#endif /* CONFIG_LORA_BASICS_MODEM_DRIVERS_BUS_LOCK */
@@ -0,0 +1,80 @@
+/*
+ * Copyright (c) 2024 Semtech Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr/kernel.h>
+
+#include "ral_sx128x_bsp.h"
+#include "radio_utilities.h"
+#include "sx128x.h"
+#include "sx128x_hal_context.h"
+
+
+void ral_sx128x_bsp_get_reg_mode(const void* context, sx128x_reg_mod_t* reg_mode)
+{
+	const struct device *dev = context;
+	const struct sx128x_hal_context_cfg_t *config = dev->config;
+	*reg_mode = config->reg_mode;
+}
+
+void ral_sx128x_bsp_get_tx_cfg(const void* context,
+	const ral_sx128x_bsp_tx_cfg_input_params_t* input_params,
+	ral_sx128x_bsp_tx_cfg_output_params_t* output_params)
+{
+	// get board tx power offset
+	int8_t board_tx_pwr_offset_db = radio_utilities_get_tx_power_offset(context);
+
+	int16_t power = input_params->system_output_pwr_in_dbm + board_tx_pwr_offset_db;
+
+	// Clamp power to the range of the PA
+	power = CLAMP(power, SX128X_MIN_PWR, SX128X_MAX_PWR);
+
+	output_params->pa_ramp_time                      = SX128X_RAMP_02_US;
+	output_params->chip_output_pwr_in_dbm_configured = (int8_t) power;
+	output_params->chip_output_pwr_in_dbm_expected   = (int8_t) power;
+}
+
+void radio_utilities_set_tx_power_offset(const void *context, uint8_t tx_pwr_offset_db)
+{
+	const struct device *dev = (const struct device *)context;
+	struct sx128x_hal_context_data_t *data = dev->data;
+	data->tx_offset = tx_pwr_offset_db;
+}
+
+uint8_t radio_utilities_get_tx_power_offset(const void *context)
+{
+	const struct device *dev = (const struct device *)context;
+	struct sx128x_hal_context_data_t *data = dev->data;
+	return data->tx_offset;
+}
+
+/*
+ * No consumption figures are provided for the SX128x yet, a board can override these with its
+ * measured values.
+ */
+__weak ral_status_t ral_sx128x_bsp_get_instantaneous_tx_power_consumption(
+	const void *context,
+	const ral_sx128x_bsp_tx_cfg_output_params_t* tx_cfg_output_params,
+	sx128x_reg_mod_t radio_reg_mode,
+	uint32_t* pwr_consumption_in_ua )
+{
+    return RAL_STATUS_UNSUPPORTED_FEATURE;
+}
+
+__weak ral_status_t ral_sx128x_bsp_get_instantaneous_gfsk_rx_power_consumption(
+	const void *context,
+	sx128x_reg_mod_t radio_reg_mode,
+	uint32_t* pwr_consumption_in_ua)
+{
+    return RAL_STATUS_UNSUPPORTED_FEATURE;
+}
+
+__weak ral_status_t ral_sx128x_bsp_get_instantaneous_lora_rx_power_consumption(
+	const void *context,
+	sx128x_reg_mod_t radio_reg_mode,
+	uint32_t* pwr_consumption_in_ua)
+{
+    return RAL_STATUS_UNSUPPORTED_FEATURE;
+}
@@ -0,0 +1,17 @@
+/*
+ * Copyright (c) 2024 Semtech Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef ZEPHYR_INCLUDE_DT_BINDINGS_LORA_LBM_SX128X_BINDINGS_DEF_H_
+#define ZEPHYR_INCLUDE_DT_BINDINGS_LORA_LBM_SX128X_BINDINGS_DEF_H_
+
+/* Those definitions were copied from
+ * modules/lib/lora_basics_modem/lbm_lib/smtc_modem_core/radio_drivers/sx128x_driver/src/sx128x.h
+ */
+
+#define SX128X_REG_MODE_LDO  0x00  // default
+#define SX128X_REG_MODE_DCDC 0x01
+
+#endif /* ZEPHYR_INCLUDE_DT_BINDINGS_LORA_LBM_SX128X_BINDINGS_DEF_H_*/
@@ -7,12 +7,31 @@
 #ifndef SUBSYS_LORAWAN_LBM_LBM_MAIN_THREAD_H
 #define SUBSYS_LORAWAN_LBM_LBM_MAIN_THREAD_H
 
+#include <stdbool.h>
+#include <stdint.h>
+
 #include <smtc_modem_hal_init.h>
 
 #ifdef __cplusplus
 extern "C" {
 #endif
 
+/**
+ * @brief Run and sleep statistics of the LBM main thread
+ */
+struct lora_basics_modem_thread_stats {
+	uint32_t engine_runs;
+	uint64_t engine_time_us;     /* Total run time of the engine */
+	uint32_t engine_time_max_us;
+	uint64_t sleep_requested_ms; /* Total sleep time requested by the engine */
+	uint64_t sleep_ms;           /* Total time actually slept */
+	uint32_t wake_timeout;       /* Sleeps that lasted the requested time */
+	uint32_t wake_radio_irq;
+	uint32_t wake_timer;
+	uint32_t wake_lbm;
+	uint32_t wake_user;          /* smtc_modem_hal_wake_up() and calls to run in the thread */
+};
+
 /**
  * @brief Initializes the LoRa Basics Modem callbacks and starts its work thread.
  *
@@ -22,6 +41,34 @@ extern "C" {
 
 void lora_basics_modem_start_work_thread(void (*event_callback)(void), struct smtc_modem_hal_cb *hal_cb);
 
+/**
+ * @brief Run a function in the LBM main thread, before the next engine run.
+ *
+ * The LBM API is not thread-safe, other threads use this to call it. When called from the
+ * LBM main thread, the function is run straight away. From an ISR it is always queued.
+ *
+ * @param fn Function to run
+ * @param arg Argument of the function
+ * @param wait Wait until the function returned, otherwise the call only queues it and can be
+ * done from ISR
+ *
+ * @retval 0 on success
+ * @retval -ENOMSG when the call queue is full
+ */
+int lora_basics_modem_run_in_thread(void (*fn)(void *arg), void *arg, bool wait);
+
+/**
+ * @brief Get the run and sleep statistics of the LBM main thread
+ *
+ * @param stats statistics since boot or last reset
+ */
+void lora_basics_modem_get_thread_stats(struct lora_basics_modem_thread_stats *stats);
+
+/**
+ * @brief Clear the run and sleep statistics of the LBM main thread
+ */
+void lora_basics_modem_reset_thread_stats(void);
+
 #ifdef __cplusplus
 }
 #endif
@@ -13,6 +13,7 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <time.h>
 
 #include <zephyr/kernel.h>
@@ -23,6 +24,8 @@
 #include <smtc_modem_api_str.h>
 
 #include <smtc_modem_hal_init.h>
+#include <lora_lbm_tracing.h>
+#include <lora_lbm_transceiver.h>
 
 LOG_MODULE_REGISTER(smtc_app, CONFIG_LORA_BASICS_MODEM_LOG_LEVEL);
 
@@ -136,7 +139,7 @@ void smtc_app_init(const struct device *lora_radio, struct smtc_app_event_callba
 	smtc_modem_hal_init(lora_radio);
 	smtc_modem_hal_register_callbacks(&prv_hal_cb);
 
-	smtc_modem_set_radio_context(lora_radio);
+	smtc_modem_set_radio_context(lora_transceiver_get_ral_context(lora_radio));
 	smtc_modem_init(&prv_event_process);
 }
 
@@ -191,7 +194,9 @@ smtc_modem_return_code_t smtc_app_on_join(uint8_t stack_id, struct smtc_app_lora
 void smtc_app_run_engine(void)
 {
 	/* Execute modem runtime, this function must be called again as soon as possible */
+	LORA_LBM_TRACE_BEGIN(engine, 0);
 	uint32_t sleep_time_ms = smtc_modem_run_engine();
+	LORA_LBM_TRACE_END(engine, sleep_time_ms);
 	// uint32_t sleep_time_ms = 3000;
 
 	LOG_INF("Sleeping for %d ms", sleep_time_ms);
@@ -200,7 +205,9 @@ void smtc_app_run_engine(void)
 
 
 
+	LORA_LBM_TRACE_BEGIN(sleep, sleep_time_ms);
 	smtc_modem_hal_interruptible_msleep(K_MSEC(sleep_time_ms));
+	LORA_LBM_TRACE_END(sleep, 0);
 	// k_sleep(K_MSEC(sleep_time_ms));
 }
 
@@ -236,211 +243,255 @@ smtc_modem_return_code_t smtc_app_get_utc_time(uint8_t stack_id, uint32_t *utc_t
 
 /* PRIVATE EVENT PROCESSOR - this calls registered callbacks from app layer */
 
+/* Events read in a single drain pass */
+static smtc_modem_event_t prv_event_batch[CONFIG_LORA_BASICS_MODEM_APP_EVENT_BATCH_SIZE];
+
+/* Number of events read since boot, per event type */
+static uint32_t prv_event_counts[SMTC_MODEM_EVENT_MAX];
+
+typedef void (*prv_event_handler_t)(const struct smtc_app_event_callbacks *cb,
+				    const smtc_modem_event_t *event);
+
+static void prv_on_reset(const struct smtc_app_event_callbacks *cb,
+			 const smtc_modem_event_t *event)
+{
+	if (cb->reset != NULL) {
+		cb->reset(event->event_data.reset.count);
+	}
+}
+
+static void prv_on_alarm(const struct smtc_app_event_callbacks *cb,
+			 const smtc_modem_event_t *event)
+{
+	if (cb->alarm != NULL) {
+		cb->alarm();
+	}
+}
+
+static void prv_on_joined(const struct smtc_app_event_callbacks *cb,
+			  const smtc_modem_event_t *event)
+{
+	if (cb->joined != NULL) {
+		cb->joined();
+	}
+}
+
+static void prv_on_tx_done(const struct smtc_app_event_callbacks *cb,
+			   const smtc_modem_event_t *event)
+{
+	LOG_DBG("TX DONE status: %s (%d)",
+		smtc_modem_event_txdone_status_to_str(event->event_data.txdone.status),
+		event->event_data.txdone.status);
+	if (cb->tx_done != NULL) {
+		cb->tx_done(event->event_data.txdone.status);
+	}
+}
+
+static void prv_on_down_data(const struct smtc_app_event_callbacks *cb,
+			     const smtc_modem_event_t *event)
+{
+	if (cb->down_data != NULL) {
+		cb->down_data();
+	}
+}
+
+static void prv_on_alcsync_time(const struct smtc_app_event_callbacks *cb,
+				const smtc_modem_event_t *event)
+{
+	if (cb->alcsync_update != NULL) {
+		cb->alcsync_update();
+	}
+}
+
+static void prv_on_join_fail(const struct smtc_app_event_callbacks *cb,
+			     const smtc_modem_event_t *event)
+{
+	if (cb->join_fail != NULL) {
+		cb->join_fail();
+	}
+}
+
+static void prv_on_link_check(const struct smtc_app_event_callbacks *cb,
+			      const smtc_modem_event_t *event)
+{
+	LOG_DBG("Link status: %s (%d)",
+		smtc_modem_event_mac_request_status_to_str(event->event_data.link_check.status),
+		event->event_data.link_check.status);
+	if (cb->link_check != NULL) {
+		cb->link_check(event->event_data.link_check.status);
+	}
+}
+
+static void prv_on_class_b_ping_slot_info(const struct smtc_app_event_callbacks *cb,
+					  const smtc_modem_event_t *event)
+{
+	LOG_DBG("Class B ping slot status: %s (%d)",
+		smtc_modem_event_mac_request_status_to_str(
+			event->event_data.class_b_ping_slot_info.status),
+		event->event_data.class_b_ping_slot_info.status);
+	if (cb->class_b_ping_slot_info != NULL) {
+		cb->class_b_ping_slot_info(event->event_data.class_b_ping_slot_info.status);
+	}
+}
+
+static void prv_on_class_b_status(const struct smtc_app_event_callbacks *cb,
+				  const smtc_modem_event_t *event)
+{
+	LOG_DBG("Class B status: %s (%d)",
+		smtc_modem_event_class_b_status_to_str(event->event_data.class_b_status.status),
+		event->event_data.class_b_status.status);
+	if (cb->class_b_status != NULL) {
+		cb->class_b_status(event->event_data.class_b_status.status);
+	}
+}
+
+static void prv_on_mac_time(const struct smtc_app_event_callbacks *cb,
+			    const smtc_modem_event_t *event)
+{
+	LOG_DBG("Time status: %s (%d)",
+		smtc_modem_event_mac_request_status_to_str(
+			event->event_data.lorawan_mac_time.status),
+		event->event_data.lorawan_mac_time.status);
+	if (cb->mac_time != NULL) {
+		cb->mac_time(event->event_data.lorawan_mac_time.status);
+	}
+}
+
+static void prv_on_fuota_done(const struct smtc_app_event_callbacks *cb,
+			      const smtc_modem_event_t *event)
+{
+	if (cb->fouta_done != NULL) {
+		cb->fouta_done();
+	}
+}
+
+static void prv_on_stream_done(const struct smtc_app_event_callbacks *cb,
+			       const smtc_modem_event_t *event)
+{
+	if (cb->stream_done != NULL) {
+		cb->stream_done();
+	}
+}
+
+static void prv_on_upload_done(const struct smtc_app_event_callbacks *cb,
+			       const smtc_modem_event_t *event)
+{
+	LOG_DBG("Upload status: %s (%d)",
+		smtc_modem_event_uploaddone_status_to_str(event->event_data.uploaddone.status),
+		event->event_data.uploaddone.status);
+	if (cb->upload_done != NULL) {
+		cb->upload_done(event->event_data.uploaddone.status);
+	}
+}
+
+static void prv_on_dm_set_conf(const struct smtc_app_event_callbacks *cb,
+			       const smtc_modem_event_t *event)
+{
+	LOG_DBG("Opcode: %s (%d)",
+		smtc_modem_event_setconf_opcode_to_str(event->event_data.setconf.opcode),
+		event->event_data.setconf.opcode);
+	if (cb->dm_set_conf != NULL) {
+		cb->dm_set_conf(event->event_data.setconf.opcode);
+	}
+}
+
+static void prv_on_mute(const struct smtc_app_event_callbacks *cb,
+			const smtc_modem_event_t *event)
+{
+	LOG_DBG("Mute: %s (%d)", smtc_modem_event_mute_status_to_str(event->event_data.mute.status),
+		event->event_data.mute.status);
+	if (cb->mute != NULL) {
+		cb->mute(event->event_data.mute.status);
+	}
+}
+
+/* Events without an entry (multicast, FMP, GNSS, WiFi and relay TX) have no dedicated callback,
+ * they are only available through the events batch callback.
+ */
+static const prv_event_handler_t prv_event_handlers[SMTC_MODEM_EVENT_MAX] = {
+	[SMTC_MODEM_EVENT_RESET] = prv_on_reset,
+	[SMTC_MODEM_EVENT_ALARM] = prv_on_alarm,
+	[SMTC_MODEM_EVENT_JOINED] = prv_on_joined,
+	[SMTC_MODEM_EVENT_TXDONE] = prv_on_tx_done,
+	[SMTC_MODEM_EVENT_DOWNDATA] = prv_on_down_data,
+	[SMTC_MODEM_EVENT_JOINFAIL] = prv_on_join_fail,
+	[SMTC_MODEM_EVENT_ALCSYNC_TIME] = prv_on_alcsync_time,
+	[SMTC_MODEM_EVENT_LINK_CHECK] = prv_on_link_check,
+	[SMTC_MODEM_EVENT_CLASS_B_PING_SLOT_INFO] = prv_on_class_b_ping_slot_info,
+	[SMTC_MODEM_EVENT_CLASS_B_STATUS] = prv_on_class_b_status,
+	[SMTC_MODEM_EVENT_LORAWAN_MAC_TIME] = prv_on_mac_time,
+	[SMTC_MODEM_EVENT_LORAWAN_FUOTA_DONE] = prv_on_fuota_done,
+	[SMTC_MODEM_EVENT_STREAM_DONE] = prv_on_stream_done,
+	[SMTC_MODEM_EVENT_UPLOAD_DONE] = prv_on_upload_done,
+	[SMTC_MODEM_EVENT_DM_SET_CONF] = prv_on_dm_set_conf,
+	[SMTC_MODEM_EVENT_MUTE] = prv_on_mute,
+};
+
+static void prv_event_dispatch(const smtc_modem_event_t *events, uint8_t count)
+{
+	if (prv_callbacks->events != NULL) {
+		prv_callbacks->events(events, count);
+	}
+
+	for (uint8_t i = 0; i < count; i++) {
+		const prv_event_handler_t handler = prv_event_handlers[events[i].event_type];
+
+		if (handler != NULL) {
+			handler(prv_callbacks, &events[i]);
+		}
+	}
+}
+
 static void prv_event_process(void)
 {
-	smtc_modem_event_t current_event;
 	smtc_modem_return_code_t return_code = SMTC_MODEM_RC_OK;
-	uint8_t event_pending_count;
+	uint8_t event_pending_count = 0;
+	uint8_t count;
+
+	/* Leave the events pending until there is a consumer */
+	if (prv_callbacks == NULL) {
+		LOG_DBG("prv_callbacks is NULL, can not call callback functions");
+		return;
+	}
 
 	do {
-		/* Read modem event */
-		return_code = smtc_modem_get_event(&current_event, &event_pending_count);
+		count = 0;
 
-		if (return_code != SMTC_MODEM_RC_OK) {
-			LOG_ERR("smtc_modem_get_event, err: %d", return_code);
-			return;
-		}
-		if (prv_callbacks == NULL) {
-			LOG_DBG("prv_callbacks is NULL, can not call callback functions");
-			continue;
-		}
+		/* Read the pending events, up to the batch size */
+		do {
+			smtc_modem_event_t *event = &prv_event_batch[count];
 
-		/* Handle event by calling external callback */
-		switch (current_event.event_type) {
-		case SMTC_MODEM_EVENT_RESET:
-			LOG_DBG("RESET EVENT");
-			LOG_DBG("Reset count: %u", current_event.event_data.reset.count);
-			if (prv_callbacks->reset != NULL) {
-				prv_callbacks->reset(current_event.event_data.reset.count);
-			}
-			break;
-		case SMTC_MODEM_EVENT_ALARM:
-			LOG_DBG("ALARM EVENT");
-			if (prv_callbacks->alarm != NULL) {
-				prv_callbacks->alarm();
-			}
-			break;
-		case SMTC_MODEM_EVENT_JOINED:
-			LOG_DBG("JOINED EVENT");
-			if (prv_callbacks->joined != NULL) {
-				prv_callbacks->joined();
-			}
-			break;
-		case SMTC_MODEM_EVENT_TXDONE:
-			LOG_DBG("TX DONE EVENT");
-			LOG_DBG("TX DONE status: %d", current_event.event_data.txdone.status);
-			if (prv_callbacks->tx_done != NULL) {
-				prv_callbacks->tx_done(current_event.event_data.txdone.status);
-			}
-			break;
-		case SMTC_MODEM_EVENT_DOWNDATA:
-			LOG_DBG("DOWNLINK EVENT");
-			if (prv_callbacks->down_data != NULL) {
-				prv_callbacks->down_data();
-			}
-			break;
-		case SMTC_MODEM_EVENT_JOINFAIL:
-			LOG_DBG("JOIN FAILED EVENT");
-			if (prv_callbacks->join_fail != NULL) {
-				prv_callbacks->join_fail();
-			}
-			break;
-		case SMTC_MODEM_EVENT_ALCSYNC_TIME:
-			LOG_DBG("ALC SYNC TIME EVENT");
-			/* TODO: */
-			break;
-		case SMTC_MODEM_EVENT_LINK_CHECK:
-			LOG_DBG("LINK CHECK EVENT");
-			LOG_DBG("Link status: %s (%d)",
-				smtc_modem_event_mac_request_status_to_str(
-					current_event.event_data.link_check.status),
-				current_event.event_data.link_check.status);
-			if (prv_callbacks->link_check != NULL) {
-				prv_callbacks->link_check(
-					current_event.event_data.link_check.status);
-			}
-			break;
-		case SMTC_MODEM_EVENT_CLASS_B_PING_SLOT_INFO:
-			LOG_DBG("CLASS B PING SLOT EVENT");
-			LOG_DBG("Class B ping slot status: %s (%d)",
-				smtc_modem_event_mac_request_status_to_str(
-					current_event.event_data.class_b_ping_slot_info.status),
-				current_event.event_data.class_b_ping_slot_info.status);
-			if (prv_callbacks->class_b_ping_slot_info != NULL) {
-				prv_callbacks->class_b_ping_slot_info(
-					current_event.event_data.class_b_ping_slot_info.status);
-			}
-			break;
-		case SMTC_MODEM_EVENT_CLASS_B_STATUS:
-			LOG_DBG("CLASS B STATUS EVENT");
-			LOG_DBG("Class B status: %s (%d)",
-				smtc_modem_event_class_b_status_to_str(
-					current_event.event_data.class_b_status.status),
-				current_event.event_data.class_b_status.status);
-			if (prv_callbacks->class_b_status != NULL) {
-				prv_callbacks->class_b_status(
-					current_event.event_data.class_b_status.status);
-			}
-			break;
-		case SMTC_MODEM_EVENT_LORAWAN_MAC_TIME:
-			LOG_DBG("LORAWAN MAC TIME EVENT");
-			LOG_DBG("Time status: %s (%d)",
-				smtc_modem_event_mac_request_status_to_str(
-					current_event.event_data.lorawan_mac_time.status),
-				current_event.event_data.lorawan_mac_time.status);
-			if (prv_callbacks->mac_time != NULL) {
-				prv_callbacks->mac_time(
-					current_event.event_data.lorawan_mac_time.status);
-			}
-			break;
-		case SMTC_MODEM_EVENT_LORAWAN_FUOTA_DONE:
-			LOG_DBG("LORAWAN FUOTA DONE EVENT");
-			if (prv_callbacks->fouta_done != NULL) {
-				prv_callbacks->fouta_done();
-			}
-			break;
-		case SMTC_MODEM_EVENT_NO_MORE_MULTICAST_SESSION_CLASS_C:
-			LOG_DBG("LORAWAN NO_MORE_MULTICAST_SESSION_CLASS_C EVENT");
-			/* TODO: */
-			break;
-		case SMTC_MODEM_EVENT_NO_MORE_MULTICAST_SESSION_CLASS_B:
-			LOG_DBG("LORAWAN NO_MORE_MULTICAST_SESSION_CLASS_B EVENT");
-			/* TODO: */
-			break;
-		case SMTC_MODEM_EVENT_NEW_MULTICAST_SESSION_CLASS_C:
-			LOG_DBG("LORAWAN NEW_MULTICAST_SESSION_CLASS_C EVENT");
-			/* TODO: */
-			break;
-		case SMTC_MODEM_EVENT_NEW_MULTICAST_SESSION_CLASS_B:
-			LOG_DBG("LORAWAN NEW_MULTICAST_SESSION_CLASS_B EVENT");
-			/* TODO: */
-			break;
-		case SMTC_MODEM_EVENT_FIRMWARE_MANAGEMENT:
-			LOG_DBG("LORAWAN FIRMWARE_MANAGEMENT EVENT");
-			/* TODO: */
-			break;
-		case SMTC_MODEM_EVENT_STREAM_DONE:
-			LOG_DBG("LORAWAN STREAM_DONE EVENT");
-			if (prv_callbacks->stream_done != NULL) {
-				prv_callbacks->stream_done();
+			return_code = smtc_modem_get_event(event, &event_pending_count);
+			if (return_code != SMTC_MODEM_RC_OK) {
+				LOG_ERR("smtc_modem_get_event, err: %d", return_code);
+				break;
 			}
-			break;
-		case SMTC_MODEM_EVENT_UPLOAD_DONE:
-			LOG_DBG("LORAWAN UPLOAD_DONE EVENT");
-			LOG_DBG("Upload status: %s (%d)",
-				smtc_modem_event_uploaddone_status_to_str(
-					current_event.event_data.uploaddone.status),
-				current_event.event_data.uploaddone.status);
-			if (prv_callbacks->upload_done != NULL) {
-				prv_callbacks->upload_done(
-					current_event.event_data.uploaddone.status);
+			if (event->event_type >= SMTC_MODEM_EVENT_MAX) {
+				LOG_WRN("UNKNOWN EVENT: %d", event->event_type);
+				continue;
 			}
-			break;
-		case SMTC_MODEM_EVENT_DM_SET_CONF:
-			LOG_DBG("LORAWAN DM_SET_CONF EVENT");
-			LOG_DBG("Opcode: %s (%d)",
-				smtc_modem_event_setconf_opcode_to_str(
-					current_event.event_data.setconf.opcode),
-				current_event.event_data.setconf.opcode);
-			if (prv_callbacks->dm_set_conf != NULL) {
-				prv_callbacks->dm_set_conf(current_event.event_data.setconf.opcode);
-			}
-			break;
-		case SMTC_MODEM_EVENT_MUTE:
-			LOG_DBG("MUTE EVENT");
-			LOG_DBG("Mute: %s (%d)",
-				smtc_modem_event_mute_status_to_str(
-					current_event.event_data.mute.status),
-				current_event.event_data.mute.status);
-			if (prv_callbacks->mute != NULL) {
-				prv_callbacks->mute(current_event.event_data.mute.status);
-			}
-			break;
-		case SMTC_MODEM_EVENT_GNSS_SCAN_DONE:
-			LOG_DBG("LORAWAN GNSS_SCAN_DONE EVENT");
-			/* TODO: */
-			break;
-		case SMTC_MODEM_EVENT_GNSS_TERMINATED:
-			LOG_DBG("LORAWAN GNSS_TERMINATED EVENT");
-			/* TODO: */
-			break;
-		case SMTC_MODEM_EVENT_GNSS_ALMANAC_DEMOD_UPDATE:
-			LOG_DBG("LORAWAN ALMANAC_DEMOD_UPDATE EVENT");
-			/* TODO: */
-			break;
-		case SMTC_MODEM_EVENT_WIFI_SCAN_DONE:
-			LOG_DBG("LORAWAN WIFI_SCAN_DONE EVENT");
-			/* TODO: */
-			break;
-		case SMTC_MODEM_EVENT_WIFI_TERMINATED:
-			LOG_DBG("LORAWAN WIFI_TERMINATED EVENT");
-			/* TODO: */
-			break;
-		case SMTC_MODEM_EVENT_RELAY_TX_DYNAMIC:
-			LOG_DBG("LORAWAN TX_DYNAMIC EVENT");
-			/* TODO: */
-			break;
-		case SMTC_MODEM_EVENT_RELAY_TX_MODE:
-			LOG_DBG("LORAWAN RELAY_TX_MODE EVENT");
-			/* TODO: */
-			break;
-		case SMTC_MODEM_EVENT_RELAY_TX_SYNC:
-			LOG_DBG("LORAWAN RELAY_TX_SYNC EVENT");
-			/* TODO: */
-			break;
-		default:
-			LOG_WRN("UNKNOWN EVENT: %d", current_event.event_type);
-			break;
+
+			LOG_DBG("%s", smtc_modem_event_type_to_str(event->event_type));
+			prv_event_counts[event->event_type]++;
+			count++;
+		} while ((event_pending_count > 0) && (count < ARRAY_SIZE(prv_event_batch)));
+
+		if (count > 0) {
+			prv_event_dispatch(prv_event_batch, count);
 		}
 	} while ((return_code == SMTC_MODEM_RC_OK) && (event_pending_count > 0));
 }
+
+uint32_t smtc_app_get_event_count(smtc_modem_event_type_t event_type)
+{
+	if (event_type >= SMTC_MODEM_EVENT_MAX) {
+		return 0;
+	}
+
+	return prv_event_counts[event_type];
+}
+
+void smtc_app_reset_event_counts(void)
+{
+	memset(prv_event_counts, 0, sizeof(prv_event_counts));
+}
@@ -163,6 +163,18 @@ struct smtc_app_event_callbacks {
 	/* TODO: GNSS event callbacks */
 	/* TODO: WiFi event callbacks */
 	/* TODO: Relay TX event callbacks */
+
+	/**
+	 * @brief All events read in one pass of the modem event queue
+	 *
+	 * Called once per pass, before the per-event callbacks above, so a burst such as
+	 * TXDONE, DOWNDATA and ALARM is delivered in a single call. It also receives the events
+	 * without a dedicated callback.
+	 *
+	 * @param [in] events Events in the order they were raised, only valid during the call.
+	 * @param [in] count Number of events, up to CONFIG_LORA_BASICS_MODEM_APP_EVENT_BATCH_SIZE.
+	 */
+	void (*events)(const smtc_modem_event_t *events, uint8_t count);
 };
 
 /**
@@ -338,6 +350,23 @@ void smtc_app_run_engine(void);
  */
 void smtc_app_run_now(void);
 
+/**
+ * @brief Get the number of events of a type raised by the modem since boot or last reset
+ *
+ * Useful to monitor event rates.
+ *
+ * @param[in] event_type The event type.
+ *
+ * @return uint32_t The number of events, 0 for an unknown type.
+ */
+uint32_t smtc_app_get_event_count(smtc_modem_event_type_t event_type);
+
+/**
+ * @brief Clear the event counters
+ *
+ */
+void smtc_app_reset_event_counts(void);
+
 #ifdef __cplusplus
 }
 #endif
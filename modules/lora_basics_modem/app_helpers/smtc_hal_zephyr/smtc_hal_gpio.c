@@ -11,56 +11,62 @@
 
 #include <zephyr/device.h>
 #include <zephyr/drivers/gpio.h>
+#include <zephyr/kernel.h>
 #include <zephyr/logging/log.h>
+#include <zephyr/sys/slist.h>
 
 LOG_MODULE_REGISTER(hal_gpio, 3);
 
-#define PIN_COUNT 4
-/* Storage for interrupt context pointers */
-struct cb_data {
-	hal_gpio_irq_t *irq;
-	struct gpio_callback cb;
-	const struct gpio_dt_spec *gpio;
-	bool used;
-};
-
-static struct cb_data prv_cb_data[PIN_COUNT];
+/* Pins with a callback. The callback storage lives in the caller's hal_gpio_irq_t, so there is
+ * no slot limit and the ISR finds its context in O(1). */
+static sys_slist_t prv_irqs = SYS_SLIST_STATIC_INIT(&prv_irqs);
 
-static bool prv_irq_enable = true;
+/* Protects the list and the enable/pending flags against the callbacks */
+static struct k_spinlock prv_lock;
 
-static struct cb_data *prv_get_cb_data(const struct gpio_dt_spec *pin)
+static hal_gpio_irq_t *prv_find_irq(const struct gpio_dt_spec *pin)
 {
-	/* Check if this pin has an associated callback */
-	for (int i = 0; i < PIN_COUNT; i++) {
-		if (prv_cb_data[i].gpio == pin) {
-			return &prv_cb_data[i];
-		}
-	}
+	hal_gpio_irq_t *irq;
 
-	/* If not, assign a free one */
-	for (int i = 0; i < PIN_COUNT; i++) {
-		if (!prv_cb_data[i].used) {
-			prv_cb_data[i].gpio = pin;
-			prv_cb_data[i].used = true;
-			return &prv_cb_data[i];
+	SYS_SLIST_FOR_EACH_CONTAINER(&prv_irqs, irq, node) {
+		if ((irq->pin->port == pin->port) && (irq->pin->pin == pin->pin)) {
+			return irq;
 		}
 	}
 
-	__ASSERT(false, "All callback slots are used!");
 	return NULL;
 }
 
 /**
- * @brief Call the corresponding callback function for the given pin
+ * @brief Call the callback of the pin, or latch it while the pin IRQ is disabled
  */
-void prv_callback(const struct device *dev, struct gpio_callback *cb, uint32_t pins)
+static void prv_callback(const struct device *dev, struct gpio_callback *cb, uint32_t pins)
 {
-	if (!prv_irq_enable) {
-		return;
+	hal_gpio_irq_t *irq = CONTAINER_OF(cb, hal_gpio_irq_t, cb);
+	k_spinlock_key_t key = k_spin_lock(&prv_lock);
+	bool enabled = irq->enabled;
+
+	irq->pending = !enabled;
+	k_spin_unlock(&prv_lock, key);
+
+	if (enabled) {
+		irq->callback(irq->context);
 	}
+}
+
+/**
+ * @brief Enable or disable the callback of a pin, lock must be held
+ *
+ * @return true if an edge was latched while the pin was disabled and must be replayed
+ */
+static bool prv_irq_enable_set(hal_gpio_irq_t *irq, bool enable)
+{
+	bool replay = enable && irq->pending;
 
-	struct cb_data *data = CONTAINER_OF(cb, struct cb_data, cb);
-	data->irq->callback(data->irq->context);
+	irq->enabled = enable;
+	irq->pending = false;
+
+	return replay;
 }
 
 void hal_gpio_init_out(const struct gpio_dt_spec *pin, const uint32_t value)
@@ -107,17 +113,30 @@ void hal_gpio_init_in(const struct gpio_dt_spec *pin, const hal_gpio_pull_mode_t
 
 	gpio_pin_interrupt_configure_dt(pin, irq_flags);
 
-	/* Configure callback */
-	struct cb_data *cb_data = prv_get_cb_data(pin);
+	/* Configure callback, dropping the one of a previous init of the pin */
+	k_spinlock_key_t key = k_spin_lock(&prv_lock);
+	hal_gpio_irq_t *old_irq = prv_find_irq(pin);
+
+	if ((old_irq != NULL) && ((irq_mode == BSP_GPIO_IRQ_MODE_OFF) || (old_irq != irq))) {
+		sys_slist_find_and_remove(&prv_irqs, &old_irq->node);
+		gpio_remove_callback(pin->port, &old_irq->cb);
+	}
 
 	if (irq_mode == BSP_GPIO_IRQ_MODE_OFF) {
-		gpio_remove_callback(pin->port, &cb_data->cb);
+		k_spin_unlock(&prv_lock, key);
 		return;
 	}
 
-	cb_data->irq = irq;
-	gpio_init_callback(&cb_data->cb, prv_callback, BIT(pin->pin));
-	gpio_add_callback(pin->port, &cb_data->cb);
+	__ASSERT(irq != NULL, "irq must be provided");
+	irq->enabled = true;
+	irq->pending = false;
+	if (!sys_slist_find(&prv_irqs, &irq->node, NULL)) {
+		sys_slist_append(&prv_irqs, &irq->node);
+	}
+	k_spin_unlock(&prv_lock, key);
+
+	gpio_init_callback(&irq->cb, prv_callback, BIT(pin->pin));
+	gpio_add_callback(pin->port, &irq->cb);
 }
 
 void hal_gpio_set_value(const struct gpio_dt_spec *pin, const uint32_t value)
@@ -132,5 +151,30 @@ uint32_t hal_gpio_get_value(const struct gpio_dt_spec *pin)
 
 void hal_gpio_irq_enable_set(bool enable)
 {
-	prv_irq_enable = enable;
+	hal_gpio_irq_t *irq;
+
+	/* The list only changes on pin init, the lock protects the flags */
+	SYS_SLIST_FOR_EACH_CONTAINER(&prv_irqs, irq, node) {
+		k_spinlock_key_t key = k_spin_lock(&prv_lock);
+		bool replay = prv_irq_enable_set(irq, enable);
+
+		k_spin_unlock(&prv_lock, key);
+
+		if (replay) {
+			irq->callback(irq->context);
+		}
+	}
+}
+
+void hal_gpio_irq_pin_enable_set(const struct gpio_dt_spec *pin, bool enable)
+{
+	k_spinlock_key_t key = k_spin_lock(&prv_lock);
+	hal_gpio_irq_t *irq = prv_find_irq(pin);
+	bool replay = (irq != NULL) && prv_irq_enable_set(irq, enable);
+
+	k_spin_unlock(&prv_lock, key);
+
+	if (replay) {
+		irq->callback(irq->context);
+	}
 }
@@ -18,6 +18,7 @@ extern "C" {
 
 #include <stdbool.h>
 #include <zephyr/drivers/gpio.h>
+#include <zephyr/sys/slist.h>
 
 /*
  * -----------------------------------------------------------------------------
@@ -42,6 +43,12 @@ typedef struct gpio_irq_s
     const struct gpio_dt_spec *pin;
     void*   context;
     void ( *callback )( void* context );
+
+    /* Private, managed by hal_gpio */
+    struct gpio_callback cb;
+    sys_snode_t          node;
+    bool                 enabled;
+    bool                 pending;  // Edge received while disabled
 } hal_gpio_irq_t;
 
 /*!
@@ -114,8 +121,23 @@ void hal_gpio_set_value( const struct gpio_dt_spec *pin, const uint32_t value );
  */
 uint32_t hal_gpio_get_value( const struct gpio_dt_spec *pin );
 
+/*!
+ * Enables or disables the callbacks of all the input pins.
+ * Edges received while disabled are not lost, the callback is called once on enable.
+ *
+ * \param [in] enable Callbacks state
+ */
 void hal_gpio_irq_enable_set(bool enable);
 
+/*!
+ * Enables or disables the callback of a single input pin, leaving the others untouched.
+ * Edges received while disabled are not lost, the callback is called once on enable.
+ *
+ * \param [in] pin    MCU pin initialized with an IRQ
+ * \param [in] enable Callback state
+ */
+void hal_gpio_irq_pin_enable_set(const struct gpio_dt_spec *pin, bool enable);
+
 #ifdef __cplusplus
 }
 #endif
@@ -8,6 +8,8 @@
 #include <smtc_modem_hal_init.h>
 
 #include <stdint.h>
+#include <string.h>
+#include <zephyr/init.h>
 #include <zephyr/kernel.h>
 #include <zephyr/random/random.h>
 #include <zephyr/settings/settings.h>
@@ -17,7 +19,9 @@
 #include <zephyr/drivers/flash.h>
 #include <zephyr/storage/flash_map.h>
 
+#include <lora_lbm_stats.h>
 #include <lora_lbm_transceiver.h>
+#include <lora_lbm_tracing.h>
 
 // for variadic args
 #include <stdarg.h>
@@ -28,8 +32,8 @@ LOG_MODULE_REGISTER(smtc_modem_hal, CONFIG_LORA_BASICS_MODEM_LOG_LEVEL);
 
 /* ------------ Local context ------------ */
 
-/* A binary semaphore to notify the main LBM loop */
-K_SEM_DEFINE(prv_main_event_sem, 0, 1);
+/* Wake-up reasons of the main LBM loop, SMTC_MODEM_HAL_WAKE_* bits */
+K_EVENT_DEFINE(prv_main_event);
 
 /* transceiver device pointer */
 static const struct device *prv_transceiver_dev;
@@ -44,13 +48,49 @@ static void (*prv_smtc_modem_hal_timer_callback)(void *context);
 /* flag for enabling/disabling timer interrupt. This is set by the libraray during "critical"
  * sections */
 static bool prv_modem_irq_enabled = true;
-static bool prv_modem_irq_pending_while_disabled = false;
-static bool prv_radio_irq_pending_while_disabled = false;
+
+/* Interrupts held back while disabled, and radio event state, set from ISR and thread context */
+#define PRV_PENDING_TIMER_IRQ 0 /* Timer expired while the modem irq was disabled */
+#define PRV_PENDING_RADIO_IRQ 1 /* Radio event while the modem irq was disabled */
+#define PRV_RADIO_IRQ_GIVEN   2 /* Radio event given to the stack, not serviced by the engine yet */
+#define PRV_TIMER_ARMED       3 /* Timer started and its callback not delivered yet */
+#define PRV_RADIO_PREWOKEN    4 /* Radio woken up ahead of the current timer expiry */
+static atomic_t prv_irq_pending;
+
+/* Radio events recovered from the event line level, their edge was missed */
+static atomic_t prv_radio_irq_missed;
+
+static void prv_radio_irq_check(void);
 
 /* The timer and work used for the modem_hal_timer */
 static void prv_smtc_modem_hal_timer_handler(struct k_timer *timer);
 K_TIMER_DEFINE(prv_smtc_modem_hal_timer, prv_smtc_modem_hal_timer_handler, NULL);
 
+/* Incremented by each start, a delivery queued before a restart is dropped */
+static atomic_t prv_timer_generation;
+static atomic_val_t prv_timer_expired_generation;
+/* Cycle count at the timer expiry interrupt */
+static volatile uint32_t prv_timer_expiry_cycles;
+
+#ifdef CONFIG_LORA_BASICS_MODEM_RADIO_PREWAKE
+/* Wakes the LBM loop ahead of the modem timer, in a wake-up bit kept from the application */
+#define PRV_WAKE_RADIO_PREWAKE BIT(SMTC_MODEM_HAL_WAKE_APP_SHIFT - 1)
+
+static void prv_smtc_modem_hal_prewake_handler(struct k_timer *timer)
+{
+	ARG_UNUSED(timer);
+
+	smtc_modem_hal_wake_up_with_reason(PRV_WAKE_RADIO_PREWAKE);
+}
+
+K_TIMER_DEFINE(prv_smtc_modem_hal_prewake_timer, prv_smtc_modem_hal_prewake_handler, NULL);
+#endif /* CONFIG_LORA_BASICS_MODEM_RADIO_PREWAKE */
+
+#ifdef CONFIG_LORA_BASICS_MODEM_TIMER_LATENCY
+static struct k_spinlock prv_timer_latency_lock;
+static struct smtc_modem_hal_timer_latency prv_timer_latency;
+#endif /* CONFIG_LORA_BASICS_MODEM_TIMER_LATENCY */
+
 /* context and callback for the event pin interrupt */
 static void *prv_smtc_modem_hal_radio_irq_context;
 static void (*prv_smtc_modem_hal_radio_irq_callback)(void *context);
@@ -127,48 +167,262 @@ void smtc_modem_hal_set_offset_to_test_wrapping(const uint32_t offset_to_test_wr
 	/* We're using RTOS which handles RTC wrapping. */
 }
 
+#ifdef CONFIG_LORA_BASICS_MODEM_RADIO_PREWAKE
+/**
+ * @brief Time from the radio pre-wake to the modem timer expiry
+ */
+static uint32_t prv_radio_prewake_lead_ms(void)
+{
+	return CONFIG_LORA_BASICS_MODEM_RADIO_PREWAKE_LEAD_MS +
+	       lora_transceiver_get_tcxo_startup_delay_ms(prv_transceiver_dev);
+}
+
+/**
+ * @brief Wake the transceiver up if the modem timer is about to expire
+ *
+ * The pre-wake event may be served late, after the timer expired and the engine put the radio
+ * back to sleep, or after the timer was restarted further away.
+ *
+ * The timer and radio callbacks drive the radio too, from their own context. They are held
+ * back like in the modem critical sections, and delivered once the radio is awake.
+ */
+static void prv_radio_prewake(void)
+{
+	int64_t remaining_ms;
+	int ret;
+
+	if (!prv_modem_irq_enabled) {
+		/* In a modem critical section, the engine drives the radio itself */
+		return;
+	}
+	smtc_modem_hal_disable_modem_irq();
+
+	remaining_ms = k_ticks_to_ms_ceil64(k_timer_remaining_ticks(&prv_smtc_modem_hal_timer));
+	if (atomic_test_bit(&prv_irq_pending, PRV_TIMER_ARMED) && (remaining_ms > 0) &&
+	    (remaining_ms <= prv_radio_prewake_lead_ms())) {
+		LORA_LBM_TRACE_EVENT(prewake, remaining_ms);
+		ret = lora_transceiver_prewake(prv_transceiver_dev);
+		if (ret < 0) {
+			LOG_WRN("Radio pre-wake failed: %d", ret);
+		} else {
+			atomic_set_bit(&prv_irq_pending, PRV_RADIO_PREWOKEN);
+		}
+	}
+
+	smtc_modem_hal_enable_modem_irq();
+}
+#endif /* CONFIG_LORA_BASICS_MODEM_RADIO_PREWAKE */
+
 void smtc_modem_hal_interruptible_msleep(k_timeout_t timeout)
 {
-	/* Notify the main loop if it's sleeping */
-	k_sem_take(&prv_main_event_sem, timeout);
+	(void)smtc_modem_hal_wait_for_wake_up(timeout);
+}
+
+uint32_t smtc_modem_hal_wait_for_wake_up(k_timeout_t timeout)
+{
+	/*
+	 * The engine ran since the previous sleep, unless a radio event is still to be handled.
+	 * The event callback posts the wake-up before it marks the event given, so clearing first
+	 * and then testing the wake-up never drops the mark of an event posted meanwhile.
+	 */
+	atomic_clear_bit(&prv_irq_pending, PRV_RADIO_IRQ_GIVEN);
+	if (k_event_test(&prv_main_event, SMTC_MODEM_HAL_WAKE_RADIO_IRQ)) {
+		atomic_set_bit(&prv_irq_pending, PRV_RADIO_IRQ_GIVEN);
+	} else {
+		prv_radio_irq_check();
+	}
+
+#ifdef CONFIG_LORA_BASICS_MODEM_RADIO_PREWAKE
+	k_timepoint_t end = sys_timepoint_calc(timeout);
+	uint32_t reasons;
+
+	do {
+		reasons = k_event_wait(&prv_main_event, UINT32_MAX, false,
+				       sys_timepoint_timeout(end));
+		k_event_clear(&prv_main_event, reasons);
+		if (reasons & PRV_WAKE_RADIO_PREWAKE) {
+			/* Served here, the radio is driven from this thread */
+			prv_radio_prewake();
+			reasons &= ~PRV_WAKE_RADIO_PREWAKE;
+		}
+	} while ((reasons == 0) && !sys_timepoint_expired(end));
+#else
+	uint32_t reasons = k_event_wait(&prv_main_event, UINT32_MAX, false, timeout);
+
+	/* A reason posted again before the clear is handled by the loop iteration to come */
+	k_event_clear(&prv_main_event, reasons);
+#endif /* CONFIG_LORA_BASICS_MODEM_RADIO_PREWAKE */
+
+	if (reasons & SMTC_MODEM_HAL_WAKE_RADIO_IRQ) {
+		/* In this thread, before the engine reads the IRQ status through the RAL */
+		lora_transceiver_fetch_irq_status(prv_transceiver_dev);
+	}
+	return reasons;
+}
+
+void smtc_modem_hal_wake_up_with_reason(uint32_t reasons)
+{
+	k_event_post(&prv_main_event, reasons);
 }
 
 void smtc_modem_hal_wake_up()
 {
-	k_sem_give(&prv_main_event_sem);
+	smtc_modem_hal_wake_up_with_reason(SMTC_MODEM_HAL_WAKE_USER);
 }
 
 /* ------------ Timer management ------------ */
 
+#ifdef CONFIG_LORA_BASICS_MODEM_TIMER_LATENCY
+static void prv_timer_latency_add(uint32_t latency_us)
+{
+	k_spinlock_key_t key = k_spin_lock(&prv_timer_latency_lock);
+	uint32_t bin = (latency_us == 0) ? 0 : (31 - __builtin_clz(latency_us));
+
+	prv_timer_latency.count++;
+	prv_timer_latency.total_us += latency_us;
+	prv_timer_latency.max_us = MAX(prv_timer_latency.max_us, latency_us);
+	prv_timer_latency.bins[MIN(bin, SMTC_MODEM_HAL_TIMER_LATENCY_BINS - 1)]++;
+	k_spin_unlock(&prv_timer_latency_lock, key);
+}
+
+void smtc_modem_hal_get_timer_latency(struct smtc_modem_hal_timer_latency *latency)
+{
+	k_spinlock_key_t key = k_spin_lock(&prv_timer_latency_lock);
+
+	*latency = prv_timer_latency;
+	latency->last_expiry_cycles = prv_timer_expiry_cycles;
+	k_spin_unlock(&prv_timer_latency_lock, key);
+}
+
+void smtc_modem_hal_reset_timer_latency(void)
+{
+	k_spinlock_key_t key = k_spin_lock(&prv_timer_latency_lock);
+
+	memset(&prv_timer_latency, 0, sizeof(prv_timer_latency));
+	k_spin_unlock(&prv_timer_latency_lock, key);
+}
+#endif /* CONFIG_LORA_BASICS_MODEM_TIMER_LATENCY */
+
 /**
- * @brief Called when the prv_smtc_modem_hal_timer expires.
+ * @brief Calls the modem timer callback, which starts the radio operation it was armed for
  *
- * Submits the prv_smtc_modem_hal_timer_work to be handle the callback.
+ * A pre-wake only shortens the board delay of that operation, not of the ones scheduled from
+ * its completion, such as the RX windows following a TX.
  */
-static void prv_smtc_modem_hal_timer_handler(struct k_timer *timer)
+static void prv_smtc_modem_hal_timer_run(void)
 {
-	ARG_UNUSED(timer);
+	prv_smtc_modem_hal_timer_callback(prv_smtc_modem_hal_timer_context);
+	atomic_clear_bit(&prv_irq_pending, PRV_RADIO_PREWOKEN);
+}
 
+/**
+ * @brief Calls the modem timer callback, in the context chosen by
+ * CONFIG_LORA_BASICS_MODEM_TIMER_CALLBACK_*
+ */
+static void prv_smtc_modem_hal_timer_deliver(void)
+{
+	/* Stopped or restarted since the expiry */
+	if ((prv_timer_expired_generation != atomic_get(&prv_timer_generation)) ||
+	    !atomic_test_and_clear_bit(&prv_irq_pending, PRV_TIMER_ARMED)) {
+		return;
+	}
+
+#ifdef CONFIG_LORA_BASICS_MODEM_TIMER_LATENCY
+	prv_timer_latency_add(k_cyc_to_us_floor32(k_cycle_get_32() - prv_timer_expiry_cycles));
+#endif /* CONFIG_LORA_BASICS_MODEM_TIMER_LATENCY */
 	if (prv_modem_irq_enabled) {
-		prv_smtc_modem_hal_timer_callback(prv_smtc_modem_hal_timer_context);
+		prv_smtc_modem_hal_timer_run();
 	} else {
-		prv_modem_irq_pending_while_disabled = true;
+		atomic_set_bit(&prv_irq_pending, PRV_PENDING_TIMER_IRQ);
+	}
+}
+
+#if defined(CONFIG_LORA_BASICS_MODEM_TIMER_CALLBACK_THREAD)
+static K_SEM_DEFINE(prv_timer_sem, 0, 1);
+
+static void prv_smtc_modem_hal_timer_thread(void *p1, void *p2, void *p3)
+{
+	ARG_UNUSED(p1);
+	ARG_UNUSED(p2);
+	ARG_UNUSED(p3);
+
+	while (1) {
+		k_sem_take(&prv_timer_sem, K_FOREVER);
+		prv_smtc_modem_hal_timer_deliver();
 	}
+}
+
+K_THREAD_DEFINE(prv_timer_thread, CONFIG_LORA_BASICS_MODEM_TIMER_CALLBACK_THREAD_STACK_SIZE,
+		prv_smtc_modem_hal_timer_thread, NULL, NULL, NULL,
+		K_PRIO_COOP(CONFIG_LORA_BASICS_MODEM_TIMER_CALLBACK_THREAD_PRIORITY), 0, 0);
+#elif defined(CONFIG_LORA_BASICS_MODEM_TIMER_CALLBACK_RADIO_QUEUE)
+static void prv_smtc_modem_hal_timer_work_handler(struct k_work *work)
+{
+	ARG_UNUSED(work);
+
+	prv_smtc_modem_hal_timer_deliver();
+}
+
+static K_WORK_DEFINE(prv_timer_work, prv_smtc_modem_hal_timer_work_handler);
+#endif
+
+/**
+ * @brief Called when the prv_smtc_modem_hal_timer expires.
+ *
+ * Calls the timer callback or hands it over to its thread or work queue.
+ */
+static void prv_smtc_modem_hal_timer_handler(struct k_timer *timer)
+{
+	ARG_UNUSED(timer);
+
+	prv_timer_expiry_cycles = k_cycle_get_32();
+	prv_timer_expired_generation = atomic_get(&prv_timer_generation);
+	LORA_LBM_TRACE_EVENT(timer_irq, prv_modem_irq_enabled);
+	smtc_modem_hal_wake_up_with_reason(SMTC_MODEM_HAL_WAKE_TIMER);
+#if defined(CONFIG_LORA_BASICS_MODEM_TIMER_CALLBACK_THREAD)
+	k_sem_give(&prv_timer_sem);
+#elif defined(CONFIG_LORA_BASICS_MODEM_TIMER_CALLBACK_RADIO_QUEUE)
+	k_work_submit(&prv_timer_work);
+#else
+	prv_smtc_modem_hal_timer_deliver();
+#endif
 };
 
 void smtc_modem_hal_start_timer(const uint32_t milliseconds, void (*callback)(void *context),
 				void *context)
 {
+	LORA_LBM_TRACE_EVENT(timer_start, milliseconds);
+
 	prv_smtc_modem_hal_timer_callback = callback;
 	prv_smtc_modem_hal_timer_context = context;
+	atomic_inc(&prv_timer_generation);
+	atomic_clear_bit(&prv_irq_pending, PRV_RADIO_PREWOKEN);
+	atomic_set_bit(&prv_irq_pending, PRV_TIMER_ARMED);
 
 	/* start one-shot timer */
 	k_timer_start(&prv_smtc_modem_hal_timer, K_MSEC(milliseconds), K_NO_WAIT);
+#ifdef CONFIG_LORA_BASICS_MODEM_RADIO_PREWAKE
+	uint32_t lead_ms = prv_radio_prewake_lead_ms();
+
+	if (milliseconds > lead_ms) {
+		k_timer_start(&prv_smtc_modem_hal_prewake_timer, K_MSEC(milliseconds - lead_ms),
+			      K_NO_WAIT);
+	} else {
+		/* Too close, the engine wakes the radio up itself */
+		k_timer_stop(&prv_smtc_modem_hal_prewake_timer);
+	}
+#endif /* CONFIG_LORA_BASICS_MODEM_RADIO_PREWAKE */
 }
 
 void smtc_modem_hal_stop_timer(void)
 {
+	LORA_LBM_TRACE_EVENT(timer_stop, 0);
+	atomic_clear_bit(&prv_irq_pending, PRV_TIMER_ARMED);
+	atomic_clear_bit(&prv_irq_pending, PRV_RADIO_PREWOKEN);
 	k_timer_stop(&prv_smtc_modem_hal_timer);
+#ifdef CONFIG_LORA_BASICS_MODEM_RADIO_PREWAKE
+	k_timer_stop(&prv_smtc_modem_hal_prewake_timer);
+#endif /* CONFIG_LORA_BASICS_MODEM_RADIO_PREWAKE */
 }
 
 /* ------------ IRQ management ------------ */
@@ -182,17 +436,23 @@ void smtc_modem_hal_enable_modem_irq(void)
 {
 	prv_modem_irq_enabled = true;
 	lora_transceiver_board_enable_interrupt(prv_transceiver_dev);
-	// FIXME: pending timer IRQ should be called at reenable time?
-	if (prv_radio_irq_pending_while_disabled) {
-		prv_radio_irq_pending_while_disabled = false;
+	if (atomic_test_and_clear_bit(&prv_irq_pending, PRV_PENDING_RADIO_IRQ)) {
 		prv_smtc_modem_hal_radio_irq_callback(prv_smtc_modem_hal_radio_irq_context);
+	} else {
+		/* Re-arming an edge interrupt may drop an edge raised meanwhile */
+		prv_radio_irq_check();
 	}
-	if (prv_modem_irq_pending_while_disabled) {
-		prv_modem_irq_pending_while_disabled = false;
-		prv_smtc_modem_hal_timer_callback(prv_smtc_modem_hal_timer_context);
+	/* The timer expired in the critical section, it is delivered late rather than lost */
+	if (atomic_test_and_clear_bit(&prv_irq_pending, PRV_PENDING_TIMER_IRQ)) {
+		prv_smtc_modem_hal_timer_run();
 	}
 }
 
+uint32_t smtc_modem_hal_get_radio_irq_missed(void)
+{
+	return (uint32_t)atomic_get(&prv_radio_irq_missed);
+}
+
 /* ------------ Context saving management ------------ */
 
 #ifdef CONFIG_LORA_BASICS_MODEM_USER_STORAGE_IMPL
@@ -206,7 +466,10 @@ void smtc_modem_hal_context_restore(const modem_context_type_t ctx_type, uint32_
 void smtc_modem_hal_context_store(const modem_context_type_t ctx_type, uint32_t offset,
 				  const uint8_t *buffer, const uint32_t size)
 {
+	LORA_LBM_TRACE_BEGIN(ctx_store, ctx_type);
 	prv_hal_cb->context_store(ctx_type, offset, buffer, size);
+	lora_lbm_stats_on_context_store(size);
+	LORA_LBM_TRACE_END(ctx_store, size);
 }
 
 #define CRASH_LOG_ID	    0xFE
@@ -239,206 +502,576 @@ bool smtc_modem_hal_crashlog_get_status(void)
 
 #ifdef CONFIG_LORA_BASICS_MODEM_PROVIDED_STORAGE_IMPL
 
-// FIXME: That whole storage bit should be revamped to something more generic,
-// that would remove the whole read-erase-write logics and leverage the zephyr flash stack.
-// Maybe split the flash in half, one with contexts and one with store-and-forward.
-// Maybe remove the store-and-forward circularfs backend and just use NVS.
-
 #if DT_HAS_CHOSEN(lora_basics_modem_context_partition)
-#define CONTEXT_PARTITION DT_FIXED_PARTITION_ID(DT_CHOSEN(lora_basics_modem_context_partition))
+#define CONTEXT_PARTITION_NODE DT_CHOSEN(lora_basics_modem_context_partition)
+#else
+#define CONTEXT_PARTITION_NODE DT_NODELABEL(storage_partition)
+#endif
+#define CONTEXT_PARTITION DT_FIXED_PARTITION_ID(CONTEXT_PARTITION_NODE)
+
+/*
+ * Context layout, computed at build time from the devicetree flash geometry.
+ * Each context has its own erase unit, so storing one context never erases another one.
+ * The geometry is checked against the flash driver at boot, see flash_init().
+ */
+#define CONTEXT_FLASH_NODE DT_MTD_FROM_FIXED_PARTITION(CONTEXT_PARTITION_NODE)
+
+#if DT_NODE_HAS_PROP(CONTEXT_FLASH_NODE, erase_block_size)
+#define CONTEXT_PAGE_SIZE DT_PROP(CONTEXT_FLASH_NODE, erase_block_size)
+#elif defined(CONFIG_SPI_NOR_FLASH_LAYOUT_PAGE_SIZE)
+#define CONTEXT_PAGE_SIZE CONFIG_SPI_NOR_FLASH_LAYOUT_PAGE_SIZE
 #else
-#define CONTEXT_PARTITION FIXED_PARTITION_ID(storage_partition)
+#define CONTEXT_PAGE_SIZE 4096
+#endif
+#define CONTEXT_WRITE_BLOCK_SIZE DT_PROP_OR(CONTEXT_FLASH_NODE, write_block_size, 1)
+
+/* Written in its own slot once the contexts follow this layout */
+static const uint8_t context_layout_tag[] = {'L', 'B', 'M', 2};
+
+/* Largest size of each context */
+#define LORAWAN_CONTEXT_SIZE 256 // in case of multistack the size of the lorawan context shall be extended
+#define MODEM_KEY_CONTEXT_SIZE 256
+#define MODEM_CONTEXT_SIZE 256
+#define SECURE_ELEMENT_CONTEXT_SIZE 1024
+#define CRASHLOG_CONTEXT_SIZE (2 + UINT8_MAX) // status, length and string
+#define CONTEXT_MAX_SIZE                                                                           \
+	MAX(MAX(LORAWAN_CONTEXT_SIZE, MODEM_KEY_CONTEXT_SIZE),                                     \
+	    MAX(MAX(MODEM_CONTEXT_SIZE, SECURE_ELEMENT_CONTEXT_SIZE), CRASHLOG_CONTEXT_SIZE))
+
+#define CONTEXT_SLOT_SIZE(size) ROUND_UP(size, CONTEXT_PAGE_SIZE)
+
+#define ADDR_LORAWAN_CONTEXT_OFFSET 0
+#define ADDR_MODEM_KEY_CONTEXT_OFFSET                                                              \
+	(ADDR_LORAWAN_CONTEXT_OFFSET + CONTEXT_SLOT_SIZE(LORAWAN_CONTEXT_SIZE))
+#define ADDR_MODEM_CONTEXT_OFFSET                                                                  \
+	(ADDR_MODEM_KEY_CONTEXT_OFFSET + CONTEXT_SLOT_SIZE(MODEM_KEY_CONTEXT_SIZE))
+#define ADDR_SECURE_ELEMENT_CONTEXT_OFFSET                                                         \
+	(ADDR_MODEM_CONTEXT_OFFSET + CONTEXT_SLOT_SIZE(MODEM_CONTEXT_SIZE))
+#define ADDR_CRASHLOG_CONTEXT_OFFSET                                                               \
+	(ADDR_SECURE_ELEMENT_CONTEXT_OFFSET + CONTEXT_SLOT_SIZE(SECURE_ELEMENT_CONTEXT_SIZE))
+#define ADDR_LAYOUT_CONTEXT_OFFSET                                                                 \
+	(ADDR_CRASHLOG_CONTEXT_OFFSET + CONTEXT_SLOT_SIZE(CRASHLOG_CONTEXT_SIZE))
+#define ADDR_STORE_AND_FORWARD_CONTEXT_OFFSET                                                      \
+	(ADDR_LAYOUT_CONTEXT_OFFSET + CONTEXT_SLOT_SIZE(sizeof(context_layout_tag)))
+
+/* Fixed layout of the previous releases, see priv_hal_context_migrate() */
+#define LEGACY_ADDR_MODEM_KEY_CONTEXT_OFFSET      256
+#define LEGACY_ADDR_MODEM_CONTEXT_OFFSET          512
+#define LEGACY_ADDR_SECURE_ELEMENT_CONTEXT_OFFSET 768
+
+BUILD_ASSERT((DT_REG_ADDR(CONTEXT_PARTITION_NODE) % CONTEXT_PAGE_SIZE) == 0,
+	     "LoRa Basics Modem context partition is not aligned on a flash page");
+BUILD_ASSERT(ADDR_STORE_AND_FORWARD_CONTEXT_OFFSET <= DT_REG_SIZE(CONTEXT_PARTITION_NODE),
+	     "LoRa Basics Modem context partition is too small for the contexts");
+/*
+ * Below 256 B, the slots are at their legacy offsets and nothing moves. From 2 KiB, the legacy
+ * contexts all sit in the LoRaWAN slot, which the move never erases, so it can be done again.
+ * In between, a slot overlaps legacy contexts still to be moved, and an interrupted move
+ * would lose them.
+ */
+BUILD_ASSERT((CONTEXT_PAGE_SIZE <= LEGACY_ADDR_MODEM_KEY_CONTEXT_OFFSET) ||
+		     (CONTEXT_PAGE_SIZE >= 2048),
+	     "LoRa Basics Modem context migration needs flash pages up to 256 B or from 2 KiB");
+#if defined(CONFIG_LORA_BASICS_MODEM_STORE_AND_FORWARD) &&                                         \
+	!DT_HAS_CHOSEN(lora_basics_modem_store_and_forward_partition)
+BUILD_ASSERT(DT_REG_SIZE(CONTEXT_PARTITION_NODE) - ADDR_STORE_AND_FORWARD_CONTEXT_OFFSET >=
+		     CONFIG_LORA_BASICS_MODEM_STORE_AND_FORWARD_MIN_PAGES * CONTEXT_PAGE_SIZE,
+	     "No room left for the store and forward pages after the LoRa Basics Modem contexts");
 #endif
 
 const struct flash_area *context_flash_area;
 
-#define ADDR_LORAWAN_CONTEXT_OFFSET 0  // in case of multistack the size of the lorawan context shall be extended
-#define ADDR_MODEM_KEY_CONTEXT_OFFSET 256
-#define ADDR_MODEM_CONTEXT_OFFSET 512
-#define ADDR_SECURE_ELEMENT_CONTEXT_OFFSET 768
-#define ADDR_CRASHLOG_CONTEXT_OFFSET 4096
-#define ADDR_STORE_AND_FORWARD_CONTEXT_OFFSET 8192
+static int context_flash_status = 1; /* 1 before the init, then 0 or the init error */
+static uint8_t context_erase_value;
+
+/* A context with its padding to the write block */
+static uint8_t context_buffer[ROUND_UP(CONTEXT_MAX_SIZE, CONTEXT_WRITE_BLOCK_SIZE)];
 
-static void flash_init(void)
+static int flash_init(void)
 {
-	if (context_flash_area) {
-		return;
+	static const uint32_t boundaries[] = {
+		ADDR_LORAWAN_CONTEXT_OFFSET,        ADDR_MODEM_KEY_CONTEXT_OFFSET,
+		ADDR_MODEM_CONTEXT_OFFSET,          ADDR_SECURE_ELEMENT_CONTEXT_OFFSET,
+		ADDR_CRASHLOG_CONTEXT_OFFSET,       ADDR_LAYOUT_CONTEXT_OFFSET,
+		ADDR_STORE_AND_FORWARD_CONTEXT_OFFSET,
+	};
+	const struct device *dev;
+	struct flash_pages_info info;
+	size_t write_block_size;
+
+	if (context_flash_status <= 0) {
+		return context_flash_status;
 	}
-	int err = flash_area_open(CONTEXT_PARTITION, &context_flash_area);
-	if (err != 0) {
-		LOG_ERR("Could not open flash area for context (%d)", err);
+	context_flash_status = flash_area_open(CONTEXT_PARTITION, &context_flash_area);
+	if (context_flash_status != 0) {
+		LOG_ERR("Could not open flash area for context (%d)", context_flash_status);
+		return context_flash_status;
 	}
 	LOG_INF("Opened flash area of size %d", context_flash_area->fa_size);
+
+	dev = flash_area_get_device(context_flash_area);
+	context_erase_value = flash_get_parameters(dev)->erase_value;
+
+	// The build time layout only works if the driver agrees with the devicetree
+	context_flash_status = -EINVAL;
+	write_block_size = flash_get_write_block_size(dev);
+	if (write_block_size == 0 || (CONTEXT_WRITE_BLOCK_SIZE % write_block_size) != 0) {
+		LOG_ERR("Write block size %zu does not match the context layout", write_block_size);
+		return context_flash_status;
+	}
+	for (size_t i = 0; i < ARRAY_SIZE(boundaries); i++) {
+		off_t offset = context_flash_area->fa_off + boundaries[i];
+
+		if (boundaries[i] == context_flash_area->fa_size) {
+			break;
+		}
+		if (flash_get_page_info_by_offs(dev, offset, &info) != 0 ||
+		    info.start_offset != offset) {
+			LOG_ERR("Context at %u does not start a flash page", boundaries[i]);
+			return context_flash_status;
+		}
+	}
+
+	context_flash_status = 0;
+	return context_flash_status;
+}
+
+/*
+ * Store and forward area, used by the LBM circular storage as a ring of flash pages.
+ * It is either its own partition, chosen with lora-basics-modem-store-and-forward-partition,
+ * or the end of the context partition. Pages are only erased when the ring wraps on them
+ * and records are appended to erased flash, so there is no read-modify-erase here.
+ */
+#if DT_HAS_CHOSEN(lora_basics_modem_store_and_forward_partition)
+#define STORE_AND_FORWARD_PARTITION                                                                \
+	DT_FIXED_PARTITION_ID(DT_CHOSEN(lora_basics_modem_store_and_forward_partition))
+#endif
+
+/* Largest supported write block, the unaligned tail of a record is padded to it */
+#define STORE_AND_FORWARD_WRITE_BLOCK_MAX 32
+
+static struct {
+	const struct flash_area *fa;
+	off_t offset;              /* Start of the area in the partition */
+	size_t size;
+	uint16_t page_size;
+	uint16_t nb_pages;
+	size_t write_block_size;
+	uint8_t erase_value;
+	int status;                /* 1 before the init, then 0 or the init error */
+} snf = {.status = 1};
+
+static int snf_init(void)
+{
+	const struct device *dev;
+	struct flash_pages_info first, last;
+	off_t start;
+
+	if (snf.status <= 0) {
+		return snf.status;
+	}
+
+#ifdef STORE_AND_FORWARD_PARTITION
+	snf.status = flash_area_open(STORE_AND_FORWARD_PARTITION, &snf.fa);
+	if (snf.status != 0) {
+		LOG_ERR("Could not open flash area for store and forward (%d)", snf.status);
+		return snf.status;
+	}
+	snf.offset = 0;
+#else
+	snf.status = flash_init();
+	if (snf.status != 0) {
+		return snf.status;
+	}
+	snf.fa = context_flash_area;
+	snf.offset = ADDR_STORE_AND_FORWARD_CONTEXT_OFFSET;
+#endif
+
+	snf.status = -EINVAL;
+	if (snf.fa->fa_size <= snf.offset) {
+		LOG_ERR("No room left for store and forward");
+		return snf.status;
+	}
+	snf.size = snf.fa->fa_size - snf.offset;
+
+	dev = flash_area_get_device(snf.fa);
+	snf.write_block_size = flash_get_write_block_size(dev);
+	snf.erase_value = flash_get_parameters(dev)->erase_value;
+	if (snf.write_block_size == 0 ||
+	    snf.write_block_size > STORE_AND_FORWARD_WRITE_BLOCK_MAX) {
+		LOG_ERR("Unsupported write block size %zu", snf.write_block_size);
+		return snf.status;
+	}
+
+	// Pages are erased one by one: the area must be made of whole pages of a single size
+	start = snf.fa->fa_off + snf.offset;
+	if (flash_get_page_info_by_offs(dev, start, &first) != 0 ||
+	    flash_get_page_info_by_offs(dev, start + snf.size - 1, &last) != 0) {
+		LOG_ERR("Could not get the store and forward pages layout");
+		return snf.status;
+	}
+	if (first.start_offset != start || first.size != last.size ||
+	    (snf.size % first.size) != 0 || first.size > UINT16_MAX ||
+	    (snf.size / first.size) > UINT16_MAX) {
+		LOG_ERR("Store and forward area is not made of whole %zu B pages", first.size);
+		return snf.status;
+	}
+	snf.page_size = first.size;
+	snf.nb_pages = snf.size / first.size;
+
+	LOG_INF("Store and forward area of %u pages of %u B", snf.nb_pages, snf.page_size);
+	snf.status = 0;
+	return snf.status;
 }
 
-static uint32_t priv_hal_context_address(const modem_context_type_t ctx_type, uint32_t offset)
+static void snf_restore(uint32_t offset, uint8_t *buffer, uint32_t size)
+{
+	if (snf_init() != 0 || offset + size > snf.size) {
+		memset(buffer, snf.erase_value, size);
+		return;
+	}
+	flash_area_read(snf.fa, snf.offset + offset, buffer, size);
+}
+
+static void snf_store(uint32_t offset, const uint8_t *buffer, uint32_t size)
+{
+	uint8_t tail[STORE_AND_FORWARD_WRITE_BLOCK_MAX];
+	uint32_t aligned;
+	int rc = 0;
+
+	if (snf_init() != 0) {
+		return;
+	}
+	if ((offset % snf.write_block_size) != 0 ||
+	    offset + ROUND_UP(size, snf.write_block_size) > snf.size) {
+		LOG_ERR("Invalid store and forward write of %u B at %u", size, offset);
+		return;
+	}
+
+	aligned = ROUND_DOWN(size, snf.write_block_size);
+	if (aligned > 0) {
+		rc = flash_area_write(snf.fa, snf.offset + offset, buffer, aligned);
+	}
+	if (rc == 0 && aligned < size) {
+		// Pad with the erase value, the padding can still be written by a later append
+		memset(tail, snf.erase_value, snf.write_block_size);
+		memcpy(tail, buffer + aligned, size - aligned);
+		rc = flash_area_write(snf.fa, snf.offset + offset + aligned, tail,
+				      snf.write_block_size);
+	}
+	if (rc != 0) {
+		LOG_ERR("Store and forward write failed (%d)", rc);
+	}
+}
+
+static void snf_erase(uint32_t offset, uint8_t nb_page)
+{
+	int rc;
+
+	if (snf_init() != 0) {
+		return;
+	}
+	if ((offset % snf.page_size) != 0 ||
+	    offset + (uint32_t)nb_page * snf.page_size > snf.size) {
+		LOG_ERR("Invalid store and forward erase of %u pages at %u", nb_page, offset);
+		return;
+	}
+
+	rc = flash_area_erase(snf.fa, snf.offset + offset, (size_t)nb_page * snf.page_size);
+	if (rc != 0) {
+		LOG_ERR("Store and forward erase failed (%d)", rc);
+	}
+}
+
+/* Offset of the context in the partition, and its largest size */
+static uint32_t priv_hal_context_address(const modem_context_type_t ctx_type, uint32_t *max_size)
 {
 	switch( ctx_type )
 	{
 	case CONTEXT_MODEM:
-		return ADDR_MODEM_CONTEXT_OFFSET + offset;
+		*max_size = MODEM_CONTEXT_SIZE;
+		return ADDR_MODEM_CONTEXT_OFFSET;
 	case CONTEXT_KEY_MODEM:
-		return ADDR_MODEM_KEY_CONTEXT_OFFSET + offset;
+		*max_size = MODEM_KEY_CONTEXT_SIZE;
+		return ADDR_MODEM_KEY_CONTEXT_OFFSET;
 	case CONTEXT_LORAWAN_STACK:
-		return ADDR_LORAWAN_CONTEXT_OFFSET + offset;
+		*max_size = LORAWAN_CONTEXT_SIZE;
+		return ADDR_LORAWAN_CONTEXT_OFFSET;
 	case CONTEXT_FUOTA:
-		// no fuota example on stm32l0
+		// no fuota storage
+		*max_size = 0;
 		return 0;
 	case CONTEXT_STORE_AND_FORWARD:
-		return ADDR_STORE_AND_FORWARD_CONTEXT_OFFSET + offset;
+		// handled by the snf_* functions
+		*max_size = 0;
+		return 0;
 	case CONTEXT_SECURE_ELEMENT:
-		return ADDR_SECURE_ELEMENT_CONTEXT_OFFSET + offset;
+		*max_size = SECURE_ELEMENT_CONTEXT_SIZE;
+		return ADDR_SECURE_ELEMENT_CONTEXT_OFFSET;
 	}
 	k_oops();
 	CODE_UNREACHABLE;
 }
 
-void smtc_modem_hal_context_restore(const modem_context_type_t ctx_type, uint32_t offset,
-				    uint8_t *buffer, const uint32_t size)
+/* Erase a context slot, then write the first size bytes of context_buffer */
+static int priv_hal_context_write(uint32_t address, uint32_t max_size, uint32_t size)
 {
+	uint32_t padded_size = ROUND_UP(size, CONTEXT_WRITE_BLOCK_SIZE);
 	int rc;
-	uint32_t real_offset;
 
-	flash_init();
-	real_offset = priv_hal_context_address(ctx_type, offset);
-	rc = flash_area_read(context_flash_area, real_offset, buffer, size);
-	return;
+	memset(context_buffer + size, context_erase_value, padded_size - size);
+	rc = flash_area_erase(context_flash_area, address, CONTEXT_SLOT_SIZE(max_size));
+	if (rc == 0) {
+		rc = flash_area_write(context_flash_area, address, context_buffer, padded_size);
+	}
+	return rc;
+}
+
+/* Compare the flash content with a buffer, a few bytes at a time */
+static bool priv_hal_context_is_unchanged(uint32_t address, const uint8_t *buffer, uint32_t size)
+{
+	uint8_t chunk[32];
+
+	for (uint32_t done = 0; done < size; done += sizeof(chunk)) {
+		uint32_t len = MIN(sizeof(chunk), size - done);
+
+		if (flash_area_read(context_flash_area, address + done, chunk, len) != 0 ||
+		    memcmp(chunk, buffer + done, len) != 0) {
+			return false;
+		}
+	}
+	return true;
 }
 
-uint8_t page_buffer[4096];
+void smtc_modem_hal_context_restore(const modem_context_type_t ctx_type, uint32_t offset,
+				    uint8_t *buffer, const uint32_t size)
+{
+	uint32_t address;
+	uint32_t max_size;
+
+	if (ctx_type == CONTEXT_STORE_AND_FORWARD) {
+		snf_restore(offset, buffer, size);
+		return;
+	}
+
+	address = priv_hal_context_address(ctx_type, &max_size);
+	if (flash_init() != 0 || offset + size > max_size) {
+		LOG_ERR("Cannot restore %u B of context %d at %u", size, ctx_type, offset);
+		memset(buffer, 0, size);
+		return;
+	}
+	flash_area_read(context_flash_area, address + offset, buffer, size);
+}
 
-// We assume (FIXME:) that stores are only on one sector.
-// FIXME: we assume page size = 4096B like in nrf
 void smtc_modem_hal_context_store(const modem_context_type_t ctx_type, uint32_t offset,
 				  const uint8_t *buffer, const uint32_t size)
 {
+	uint32_t address;
+	uint32_t max_size;
 	int rc;
-	uint32_t real_offset;
-	uint32_t real_size;
-
-	// shitty workaround because some 4-bytes writes will come while flash supports only 8
-	real_size = size + 8 - (size % 8);
-
-	flash_init();
-	real_offset = priv_hal_context_address(ctx_type, offset);
-
-	// read-erase-write
-	if (real_offset < ADDR_STORE_AND_FORWARD_CONTEXT_OFFSET) {
-		memset(page_buffer, 0, 4096);
-		flash_area_read(context_flash_area, 0, page_buffer, 4096);
-		memset(page_buffer + real_offset, 0, real_size);
-		memcpy(page_buffer + real_offset, buffer, real_size);
-		flash_area_erase(context_flash_area, 0, 4096);
-		rc = flash_area_write(context_flash_area, 0, page_buffer, 4096);
-	} else {
-		// LOG_INF("%s: offset %d, real_offset=%d", __FUNCTION__, offset, real_offset);
-		memset(page_buffer, 0, real_size);
-		// yes, size, not real_size
-		memcpy(page_buffer, buffer, size);
-		rc = flash_area_write(context_flash_area, real_offset, page_buffer, real_size);
+
+	LORA_LBM_TRACE_BEGIN(ctx_store, ctx_type);
+
+	if (ctx_type == CONTEXT_STORE_AND_FORWARD) {
+		// Append only, the LBM circular storage erases the pages before reusing them
+		snf_store(offset, buffer, size);
+		lora_lbm_stats_on_context_store(size);
+		LORA_LBM_TRACE_END(ctx_store, size);
+		return;
+	}
+
+	address = priv_hal_context_address(ctx_type, &max_size);
+	if (flash_init() != 0 || offset + size > max_size) {
+		LOG_ERR("Cannot store %u B of context %d at %u", size, ctx_type, offset);
+		LORA_LBM_TRACE_END(ctx_store, 0);
+		return;
+	}
+
+	// The modem stores its contexts again and again, most of the time unchanged
+	if (priv_hal_context_is_unchanged(address + offset, buffer, size)) {
+		LORA_LBM_TRACE_END(ctx_store, 0);
+		return;
+	}
+
+	// The slot is erased as a whole, keep what the modem does not store this time
+	rc = flash_area_read(context_flash_area, address, context_buffer, max_size);
+	if (rc == 0) {
+		memcpy(context_buffer + offset, buffer, size);
+		rc = priv_hal_context_write(address, max_size, max_size);
+	}
+	if (rc != 0) {
+		LOG_ERR("Context %d store failed (%d)", ctx_type, rc);
 	}
 
-	return;
+	lora_lbm_stats_on_context_store(size);
+	LORA_LBM_TRACE_END(ctx_store, size);
 }
 
-// We assume (FIXME:) that erases are aligned on sectors
 void smtc_modem_hal_context_flash_pages_erase(const modem_context_type_t ctx_type,
 						uint32_t offset,
 					      uint8_t nb_page)
 {
-	int rc;
-	uint32_t real_offset;
+	uint32_t address;
+	uint32_t max_size;
+
+	if (ctx_type == CONTEXT_STORE_AND_FORWARD) {
+		snf_erase(offset, nb_page);
+		return;
+	}
 
-	flash_init();
-	real_offset = priv_hal_context_address(ctx_type, offset);
-	rc = flash_area_erase(context_flash_area, real_offset, smtc_modem_hal_flash_get_page_size() * nb_page);
-	return;
+	address = priv_hal_context_address(ctx_type, &max_size);
+	if (flash_init() != 0 || (offset % CONTEXT_PAGE_SIZE) != 0 ||
+	    offset + (uint32_t)nb_page * CONTEXT_PAGE_SIZE > CONTEXT_SLOT_SIZE(max_size)) {
+		LOG_ERR("Cannot erase %u pages of context %d at %u", nb_page, ctx_type, offset);
+		return;
+	}
+	flash_area_erase(context_flash_area, address + offset, (size_t)nb_page * CONTEXT_PAGE_SIZE);
 }
 
 uint16_t smtc_modem_hal_flash_get_page_size()
 {
-	const struct device *flash_device;
-	struct flash_pages_info info;
-
-	flash_init();
-	flash_device = flash_area_get_device(context_flash_area);
-	flash_get_page_info_by_offs(flash_device, ADDR_STORE_AND_FORWARD_CONTEXT_OFFSET, &info);
-	return info.size;
+	// Only used by the store and forward storage
+	if (snf_init() != 0) {
+		return 0;
+	}
+	return snf.page_size;
 }
 
 uint16_t smtc_modem_hal_store_and_forward_get_number_of_pages()
 {
-	uint16_t page_size;
-	size_t flash_size;
-	uint16_t pages_possible;
-
-	page_size = smtc_modem_hal_flash_get_page_size();
-	flash_size = context_flash_area->fa_size;
-
-	pages_possible = (flash_size - 8192) / page_size; // 8192B are taken by stuff before store_and_forward
-
-	return pages_possible;
+	// Validated and cached at init, no flash access here
+	if (snf_init() != 0) {
+		return 0;
+	}
+	return snf.nb_pages;
 }
 
 void smtc_modem_hal_crashlog_store(const uint8_t *crashlog, uint8_t crash_string_length)
 {
-	flash_init();
-
-	memset(page_buffer, 0, 4096);
-	page_buffer[0] = 1;
-	page_buffer[1] = crash_string_length;
-	memcpy(page_buffer + 2, crashlog, crash_string_length);
-
-	flash_area_erase(context_flash_area, ADDR_CRASHLOG_CONTEXT_OFFSET, 4096);
-	flash_area_write(context_flash_area, ADDR_CRASHLOG_CONTEXT_OFFSET, page_buffer, 4096);
+	if (flash_init() != 0) {
+		return;
+	}
 
-	// prv_store("smtc_modem_hal/crashlog", crashlog, crash_string_length);
+	context_buffer[0] = 1;
+	context_buffer[1] = crash_string_length;
+	memcpy(context_buffer + 2, crashlog, crash_string_length);
+	priv_hal_context_write(ADDR_CRASHLOG_CONTEXT_OFFSET, CRASHLOG_CONTEXT_SIZE,
+			       2 + crash_string_length);
 }
 
 void smtc_modem_hal_crashlog_restore(uint8_t *crashlog, uint8_t *crash_string_length)
 {
-	flash_init();
-	flash_area_read(context_flash_area, ADDR_CRASHLOG_CONTEXT_OFFSET, page_buffer, 4096);
-	int available = page_buffer[0];
-	int length = page_buffer[1];
+	uint8_t header[2] = {0};
 
 	crashlog[0] = 0;
-	*crash_string_length = length;
+	*crash_string_length = 0;
 
-	if (available != 0) {
-		memcpy(crashlog, page_buffer + 2, length);
+	if (flash_init() != 0) {
+		return;
 	}
+	flash_area_read(context_flash_area, ADDR_CRASHLOG_CONTEXT_OFFSET, header, sizeof(header));
+	*crash_string_length = header[1];
 
-	// uint8_t length = strlen(crashlog_default);
-	// memcpy(crashlog, crashlog_default, length);
-	// *crash_string_length = length;
-	// prv_load("smtc_modem_hal/crashlog", crashlog, *crash_string_length);
+	if (header[0] != 0) {
+		flash_area_read(context_flash_area, ADDR_CRASHLOG_CONTEXT_OFFSET + 2, crashlog,
+				header[1]);
+	}
 }
 
 void smtc_modem_hal_crashlog_set_status(bool available)
 {
-	flash_init();
-	if (!available) {
-		flash_area_erase(context_flash_area, ADDR_CRASHLOG_CONTEXT_OFFSET, smtc_modem_hal_flash_get_page_size());
+	if (!available && flash_init() == 0) {
+		flash_area_erase(context_flash_area, ADDR_CRASHLOG_CONTEXT_OFFSET,
+				 CONTEXT_SLOT_SIZE(CRASHLOG_CONTEXT_SIZE));
 	}
-	// prv_store("smtc_modem_hal/crashlog_status", (uint8_t *)&available, sizeof(available));
 }
 
 bool smtc_modem_hal_crashlog_get_status(void)
 {
-	flash_init();
-	flash_area_read(context_flash_area, ADDR_CRASHLOG_CONTEXT_OFFSET, page_buffer, 1);
+	uint8_t status = 0;
 
-	// Any other state might mean uninitialized flash area
-	return (page_buffer[0] == 1);
+	if (flash_init() == 0) {
+		flash_area_read(context_flash_area, ADDR_CRASHLOG_CONTEXT_OFFSET, &status, 1);
+	}
 
-	// bool available;
-	// prv_load("smtc_modem_hal/crashlog_status", (uint8_t *)&available, sizeof(available));
-	// return available;
+	// Any other state might mean uninitialized flash area
+	return (status == 1);
 }
 
+/*
+ * Move the contexts stored with the fixed layout of the previous releases, where the LoRaWAN,
+ * modem key, modem and secure element contexts shared the first 4 KiB of the partition.
+ * The LoRaWAN context is already in place. Each other slot starts at or after its legacy
+ * offset, so copying them from the last one down never overwrites a context still to be
+ * copied. The page size is checked at build time so that an interrupted move is simply done
+ * again at the next boot. The legacy crash log and store and forward data are dropped, their
+ * areas now hold other contexts.
+ */
+static int priv_hal_context_migrate(void)
+{
+	static const struct {
+		uint32_t from;
+		uint32_t to;
+		uint32_t size;
+	} moves[] = {
+		{LEGACY_ADDR_SECURE_ELEMENT_CONTEXT_OFFSET, ADDR_SECURE_ELEMENT_CONTEXT_OFFSET,
+		 SECURE_ELEMENT_CONTEXT_SIZE},
+		{LEGACY_ADDR_MODEM_CONTEXT_OFFSET, ADDR_MODEM_CONTEXT_OFFSET, MODEM_CONTEXT_SIZE},
+		{LEGACY_ADDR_MODEM_KEY_CONTEXT_OFFSET, ADDR_MODEM_KEY_CONTEXT_OFFSET,
+		 MODEM_KEY_CONTEXT_SIZE},
+	};
+	uint8_t tag[sizeof(context_layout_tag)];
+	int rc;
+
+	rc = flash_area_read(context_flash_area, ADDR_LAYOUT_CONTEXT_OFFSET, tag, sizeof(tag));
+	if (rc != 0 || memcmp(tag, context_layout_tag, sizeof(tag)) == 0) {
+		return rc;
+	}
+	LOG_INF("Moving the contexts to the flash page layout");
+
+	for (size_t i = 0; rc == 0 && i < ARRAY_SIZE(moves); i++) {
+		rc = flash_area_read(context_flash_area, moves[i].from, context_buffer,
+				     moves[i].size);
+		if (rc == 0 &&
+		    !priv_hal_context_is_unchanged(moves[i].to, context_buffer, moves[i].size)) {
+			rc = priv_hal_context_write(moves[i].to, moves[i].size, moves[i].size);
+		}
+	}
+	if (rc == 0) {
+		rc = flash_area_erase(context_flash_area, ADDR_CRASHLOG_CONTEXT_OFFSET,
+				      CONTEXT_SLOT_SIZE(CRASHLOG_CONTEXT_SIZE));
+	}
+#ifndef STORE_AND_FORWARD_PARTITION
+	if (rc == 0 && context_flash_area->fa_size > ADDR_STORE_AND_FORWARD_CONTEXT_OFFSET) {
+		rc = flash_area_erase(context_flash_area, ADDR_STORE_AND_FORWARD_CONTEXT_OFFSET,
+				      ROUND_DOWN(context_flash_area->fa_size -
+							 ADDR_STORE_AND_FORWARD_CONTEXT_OFFSET,
+						 CONTEXT_PAGE_SIZE));
+	}
+#endif
+	// The tag goes last, so that nothing is lost if the move is interrupted
+	if (rc == 0) {
+		memcpy(context_buffer, context_layout_tag, sizeof(context_layout_tag));
+		rc = priv_hal_context_write(ADDR_LAYOUT_CONTEXT_OFFSET, sizeof(context_layout_tag),
+					    sizeof(context_layout_tag));
+	}
+	if (rc != 0) {
+		LOG_ERR("Could not move the contexts (%d)", rc);
+	}
+	return rc;
+}
 
+/* Check the flash layout at boot rather than on the first context access */
+static int prv_storage_init(void)
+{
+	if (flash_init() == 0) {
+		priv_hal_context_migrate();
+	}
+	snf_init();
+	return 0;
+}
 
+SYS_INIT(prv_storage_init, APPLICATION, CONFIG_APPLICATION_INIT_PRIORITY);
 
 #endif /* CONFIG_LORA_BASICS_MODEM_USER_STORAGE_IMPL */
 
@@ -487,19 +1120,46 @@ uint32_t smtc_modem_hal_get_random_nb_in_range(const uint32_t val_1, const uint3
 /**
  * @brief Called when the transceiver event pin interrupt is triggered.
  *
- * If CONFIG_TRANSCEIVER_EVENT_TRIGGER_GLOBAL_THREAD=y, this is called in the system workq.
- * If CONFIG_TRANSCEIVER_EVENT_TRIGGER_OWN_THREAD=y, this is called in the transceiver event thread.
+ * With CONFIG_LORA_BASICS_MODEM_DRIVERS_EVENT_TRIGGER_GLOBAL_THREAD, this runs in the system workq.
+ * With CONFIG_LORA_BASICS_MODEM_DRIVERS_EVENT_TRIGGER_OWN_THREAD, this runs in the driver thread.
+ * With CONFIG_LORA_BASICS_MODEM_DRIVERS_EVENT_TRIGGER_ISR, this runs in the radio interrupt.
  *
  * @param[in] dev The transceiver device.
  */
 void prv_transceiver_event_cb(const struct device *dev)
 {
+	LORA_LBM_TRACE_BEGIN(radio_irq, prv_modem_irq_enabled);
+	lora_lbm_stats_on_event();
+	/* Posted first, see smtc_modem_hal_wait_for_wake_up() */
+	smtc_modem_hal_wake_up_with_reason(SMTC_MODEM_HAL_WAKE_RADIO_IRQ);
+	atomic_set_bit(&prv_irq_pending, PRV_RADIO_IRQ_GIVEN);
 	if (prv_modem_irq_enabled) {
-		/* Due to the way the transceiver driver is implemented, this is called from the system workq. */
 		prv_smtc_modem_hal_radio_irq_callback(prv_smtc_modem_hal_radio_irq_context);
 	} else {
-		prv_radio_irq_pending_while_disabled = true;
+		atomic_set_bit(&prv_irq_pending, PRV_PENDING_RADIO_IRQ);
+	}
+	LORA_LBM_TRACE_END(radio_irq, 0);
+}
+
+/**
+ * @brief Recover a radio event whose edge was missed, from the event line level
+ *
+ * The line stays active until the IRQ status is cleared. When it is active while no
+ * event is queued by the driver nor waiting for the engine, its edge was lost.
+ */
+static void prv_radio_irq_check(void)
+{
+	if ((prv_smtc_modem_hal_radio_irq_callback == NULL) ||
+	    !lora_transceiver_board_is_event_pending(prv_transceiver_dev) ||
+	    atomic_test_and_set_bit(&prv_irq_pending, PRV_RADIO_IRQ_GIVEN)) {
+		return;
 	}
+
+	atomic_inc(&prv_radio_irq_missed);
+	lora_lbm_stats_on_irq_missed();
+	LORA_LBM_TRACE_EVENT(irq_missed, 0);
+	LOG_DBG("Missed radio irq recovered");
+	prv_transceiver_event_cb(prv_transceiver_dev);
 }
 
 void smtc_modem_hal_irq_config_radio_irq(void (*callback)(void *context), void *context)
@@ -522,20 +1182,25 @@ void smtc_modem_hal_irq_reset_radio_irq(void)
 
 void smtc_modem_hal_radio_irq_clear_pending(void)
 {
-	prv_modem_irq_pending_while_disabled = false;
-	prv_radio_irq_pending_while_disabled = false;
+	atomic_clear_bit(&prv_irq_pending, PRV_PENDING_TIMER_IRQ);
+	atomic_clear_bit(&prv_irq_pending, PRV_PENDING_RADIO_IRQ);
 }
 
 void smtc_modem_hal_start_radio_tcxo(void)
 {
-	/* We only support TCXO's that are wired to the transceiver. In such cases, this function must be
-	 * empty. See 5.25 of the porting guide. */
+	/* See 5.25 of the porting guide. A TCXO wired to the transceiver is started by the
+	 * transceiver itself. A TCXO powered by a board GPIO is powered here without waiting: it
+	 * starts while the radio is configured, and the driver only delays the first command
+	 * running on it. */
+	lora_transceiver_board_set_tcxo(prv_transceiver_dev, true);
 }
 
 void smtc_modem_hal_stop_radio_tcxo(void)
 {
-	/* We only support TCXO's that are wired to the transceiver. In such cases, this function must be
-	 * empty. See 5.26 of the porting guide. */
+	/* See 5.26 of the porting guide. The antenna switch is not needed either once the radio
+	 * operation is over. */
+	lora_transceiver_board_set_rf_switch(prv_transceiver_dev, LORA_TRANSCEIVER_RF_SWITCH_OFF);
+	lora_transceiver_board_set_tcxo(prv_transceiver_dev, false);
 }
 
 uint32_t smtc_modem_hal_get_radio_tcxo_startup_delay_ms(void)
@@ -551,7 +1216,11 @@ void smtc_modem_hal_set_ant_switch(bool is_tx_on)
 {
 	/* From the porting guide:
 	 * If no antenna switch is used then implement an empty command.
+	 * The switch GPIOs are powered down again when the radio operation is over.
 	 */
+	lora_transceiver_board_set_rf_switch(prv_transceiver_dev,
+					     is_tx_on ? LORA_TRANSCEIVER_RF_SWITCH_TX :
+							LORA_TRANSCEIVER_RF_SWITCH_RX);
 }
 
 /* ------------ Environment management ------------ */
@@ -619,11 +1288,14 @@ uint16_t smtc_modem_hal_get_voltage_mv(void)
 int8_t smtc_modem_hal_get_board_delay_ms(void)
 {
 	/* the wakeup time is probably closer to 0ms then 1ms,
-	 * but just to be safe: */
+	 * but just to be safe. When the radio was pre-woken for the timer being delivered, it
+	 * is already awake with its TCXO running when the engine configures it. */
+	int8_t prewoken = atomic_test_bit(&prv_irq_pending, PRV_RADIO_PREWOKEN) ? 1 : 0;
+
 #if defined(CONFIG_LORA_BASICS_MODEM_LR1121)
-	return 2;
+	return 2 - prewoken;
 #else
-	return 1;
+	return 1 - prewoken;
 #endif
 }
 
@@ -699,5 +1371,5 @@ uint8_t smtc_modem_hal_get_fw_delete_status_for_fuota(uint32_t fw_to_delete_vers
 
 void smtc_modem_hal_user_lbm_irq(void)
 {
-	smtc_modem_hal_wake_up();
+	smtc_modem_hal_wake_up_with_reason(SMTC_MODEM_HAL_WAKE_LBM);
 }
@@ -10,6 +10,7 @@
 #include <stdint.h>
 #include <zephyr/device.h>
 #include <zephyr/sys_clock.h>
+#include <zephyr/sys/util_macro.h>
 
 #ifdef __cplusplus
 extern "C" {
@@ -168,12 +169,81 @@ void smtc_modem_hal_register_callbacks(struct smtc_modem_hal_cb *hal_cb);
  */
 void smtc_modem_hal_irq_reset_radio_irq(void);
 
+/**
+ * @brief Number of radio events recovered from the event line level, their edge was missed.
+ *
+ * The event line is sampled when the modem irq is re-enabled and before each sleep of the
+ * main LBM loop. An active line with no event given to the stack is delivered right away.
+ *
+ * @return uint32_t Missed radio events since boot, wraps
+ */
+uint32_t smtc_modem_hal_get_radio_irq_missed(void);
+
+#ifdef CONFIG_LORA_BASICS_MODEM_TIMER_LATENCY
+
+/* Number of bins of the timer latency histogram */
+#define SMTC_MODEM_HAL_TIMER_LATENCY_BINS 16
+
+/**
+ * @brief Latency from the modem timer expiry interrupt to its callback.
+ *
+ * bins[n] counts the latencies from 2^n to 2^(n+1) - 1 us, bins[0] also counts 0 us and the
+ * last bin every longer latency.
+ */
+struct smtc_modem_hal_timer_latency {
+	uint32_t count;
+	uint32_t max_us;
+	uint64_t total_us;
+	/* k_cycle_get_32() at the last expiry interrupt */
+	uint32_t last_expiry_cycles;
+	uint32_t bins[SMTC_MODEM_HAL_TIMER_LATENCY_BINS];
+};
+
+/**
+ * @brief Get the modem timer callback latency histogram.
+ *
+ * @param[out] latency Copy of the histogram
+ */
+void smtc_modem_hal_get_timer_latency(struct smtc_modem_hal_timer_latency *latency);
+
+/**
+ * @brief Clear the modem timer callback latency histogram.
+ */
+void smtc_modem_hal_reset_timer_latency(void);
+
+#endif /* CONFIG_LORA_BASICS_MODEM_TIMER_LATENCY */
+
+/* Reasons waking up the main LBM loop, several can be reported by one wake-up */
+#define SMTC_MODEM_HAL_WAKE_RADIO_IRQ BIT(0) /* Transceiver event */
+#define SMTC_MODEM_HAL_WAKE_TIMER     BIT(1) /* Modem timer expiry */
+#define SMTC_MODEM_HAL_WAKE_LBM       BIT(2) /* Request of the stack (smtc_modem_hal_user_lbm_irq) */
+#define SMTC_MODEM_HAL_WAKE_USER      BIT(3) /* smtc_modem_hal_wake_up() */
+/* First bit free for application specific reasons */
+#define SMTC_MODEM_HAL_WAKE_APP_SHIFT 8
+
 /**
  * @brief Interruptible sleep that will exit when radio events happen.
  *
  */
 void smtc_modem_hal_interruptible_msleep(k_timeout_t timeout);
 
+/**
+ * @brief Interruptible sleep that reports why it exited.
+ *
+ * @param[in] timeout Maximum sleep time
+ *
+ * @return uint32_t SMTC_MODEM_HAL_WAKE_* and application bits posted since the last call,
+ * 0 on timeout
+ */
+uint32_t smtc_modem_hal_wait_for_wake_up(k_timeout_t timeout);
+
+/**
+ * @brief Wake up the main LBM loop. Can be called from ISR.
+ *
+ * @param[in] reasons SMTC_MODEM_HAL_WAKE_* or application bits reported to the loop
+ */
+void smtc_modem_hal_wake_up_with_reason(uint32_t reasons);
+
 void smtc_modem_hal_wake_up();
 
 #ifdef __cplusplus
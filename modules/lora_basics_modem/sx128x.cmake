@@ -4,11 +4,11 @@
 # Used by LBM
 zephyr_compile_definitions(SX128X)
 zephyr_compile_definitions(SX128X_DISABLE_WARNINGS)
-zephyr_compile_definitions_ifdef(CONFIG_DT_HAS_SEMTECH_SX1282_NEW_ENABLED SX1282)
-zephyr_compile_definitions_ifdef(CONFIG_DT_HAS_SEMTECH_SX1286_NEW_ENABLED SX1286)
-zephyr_compile_definitions_ifdef(CONFIG_DT_HAS_SEMTECH_SX1288_NEW_ENABLED SX1288)
+zephyr_compile_definitions_ifdef(CONFIG_DT_HAS_SEMTECH_SX1280_NEW_ENABLED SX1280)
+zephyr_compile_definitions_ifdef(CONFIG_DT_HAS_SEMTECH_SX1281_NEW_ENABLED SX1281)
 
 set(LBM_SX128X_LIB_DIR ${LBM_RADIO_DRIVERS_DIR}/sx128x_driver/src)
+zephyr_include_directories(${LBM_SX128X_LIB_DIR})
 
 #-----------------------------------------------------------------------------
 # Radio specific sources
@@ -27,10 +27,23 @@
 #include "modem_pinout.h"
 #include "smtc_hal_gpio.h"
 #include "smtc_hal_mcu.h"
+#include "hw_modem.h"
 
 #include "radio_utilities.h"
+#if defined( CONFIG_LORA_BASICS_MODEM_DRIVERS_ENERGY )
+#include "lora_lbm_energy.h"
+#endif
+#if defined( CONFIG_LORA_BASICS_MODEM_DRIVERS_STATS )
+#include <zephyr/stats/stats.h>
+#include "lora_lbm_stats.h"
+#endif
 
 #include <string.h>  //for memset
+#include <zephyr/sys/crc.h>
+#if defined( CONFIG_HW_MODEM_LFU_FLASH )
+#include <zephyr/storage/flash_map.h>
+#include <zephyr/storage/stream_flash.h>
+#endif
 #if defined( USE_RELAY_TX )
 #include "smtc_modem_relay_api.h"
 #endif
@@ -45,13 +58,27 @@
  */
 
 #define STACK_ID 0
-#if defined( STM32L073xx )
+#if defined( CONFIG_HW_MODEM_LFU_FLASH )
+#define LFU_PARTITION lfu_partition
+#define FILE_UPLOAD_MAX_SIZE FIXED_PARTITION_SIZE( LFU_PARTITION )
+// The internal flash is memory mapped, the stack reads the staged file in place
+#define LFU_FILE_ADDRESS \
+    ( DT_REG_ADDR( DT_GPARENT( DT_NODELABEL( LFU_PARTITION ) ) ) + FIXED_PARTITION_OFFSET( LFU_PARTITION ) )
+// Multiple of the write block size of usual internal flashes
+#define LFU_FLASH_BUFFER_SIZE 128
+#elif defined( STM32L073xx )
 #define FILE_UPLOAD_MAX_SIZE 4096
 #else
 #define FILE_UPLOAD_MAX_SIZE 8192
 #endif
 
 #define MODEM_MAX_INFO_FIELD_SIZE 19
+
+// Payload of a response, its length is sent on one byte
+#define CMD_RESPONSE_MAX_LENGTH 255
+// Largest event serialized by cmd_parser_event_serialize (reset event)
+#define CMD_EVENT_MAX_LENGTH 4
+#define CMD_DL_METADATA_LENGTH 11
 /*
  * -----------------------------------------------------------------------------
  * --- PRIVATE TYPES -----------------------------------------------------------
@@ -95,11 +122,27 @@ static void *transceiver_context;
 static bool                     modem_in_test_mode = false;
 static smtc_modem_dl_metadata_t last_dl_metadata   = { 0 };
 
+// Downlink fetched by CMD_GET_EVENTS that did not fit in its response, returned by the next CMD_GET_DOWNLINK_DATA
+static struct
+{
+    bool                     valid;
+    uint8_t                  length;
+    uint8_t                  remaining;
+    smtc_modem_dl_metadata_t metadata;
+    uint8_t                  data[SMTC_MODEM_MAX_LORAWAN_PAYLOAD_LENGTH];
+} held_dl;
+
 // LFU handling
-static uint8_t         file_store[FILE_UPLOAD_MAX_SIZE] = { 0 };
-static uint16_t        file_size                        = 0;
-static uint16_t        upload_current_size              = 0;
-static upload_status_t upload_status                    = UPLOAD_NOT_INIT;
+#if defined( CONFIG_HW_MODEM_LFU_FLASH )
+static struct stream_flash_ctx file_stream;
+static uint8_t                 file_stream_buffer[LFU_FLASH_BUFFER_SIZE];
+#else
+static uint8_t file_store[FILE_UPLOAD_MAX_SIZE];
+#endif
+static uint16_t        file_size           = 0;
+static uint16_t        upload_current_size = 0;
+static uint32_t        upload_current_crc  = 0;  // CRC32 of the data received so far
+static upload_status_t upload_status       = UPLOAD_NOT_INIT;
 
 #if defined( ADD_APP_GEOLOCATION ) && (defined( STM32L476xx ) || defined (NRF52840_XXAA))
 // Geolocation handling
@@ -153,7 +196,11 @@ static const uint8_t host_cmd_tab[CMD_MAX][HOST_CMD_TAB_IDX_COUNT] = {
     [CMD_LBT_GET_PARAMS]                        = { 1, 0, 0 },
     [CMD_LBT_SET_STATE]                         = { 1, 1, 1 },
     [CMD_LBT_GET_STATE]                         = { 1, 0, 0 },
+#if defined( CONFIG_LORA_BASICS_MODEM_DRIVERS_ENERGY )
+    [CMD_GET_CHARGE]                            = { 1, 0, 1 },
+#else
     [CMD_GET_CHARGE]                            = { 1, 0, 0 },
+#endif
     [CMD_RESET_CHARGE]                          = { 1, 0, 0 },
     [CMD_SET_CLASS]                             = { 1, 1, 1 },
     [CMD_CLASS_B_SET_PING_SLOT_PERIODICITY]    = { 1, 1, 1 },
@@ -253,6 +300,8 @@ static const uint8_t host_cmd_tab[CMD_MAX][HOST_CMD_TAB_IDX_COUNT] = {
     [CMD_GET_BYPASS_JOIN_DUTY_CYCLE_BACKOFF]    = { 1, 0, 0 },
     [CMD_SET_BYPASS_JOIN_DUTY_CYCLE_BACKOFF]    = { 1, 1, 1 },
     [CMD_MODEM_GET_CRASHLOG]                 = { 1, 0, 0 },
+    [CMD_GET_EVENTS]                         = { 1, 0, 0 },
+    [CMD_GET_WAKE_STATS]                     = { 1, 0, 1 },
 };
 
 /**
@@ -280,6 +329,7 @@ static const uint8_t host_cmd_test_tab[CMD_TST_MAX][HOST_CMD_TAB_IDX_COUNT] = {
     [CMD_TST_WATCHDOG]             = { 1, 0, 0 },    //
     [CMD_TST_RADIO_READ]           = { 1, 0, 255 },  //
     [CMD_TST_RADIO_WRITE]          = { 1, 0, 255 },  //
+    [CMD_TST_RADIO_STATS]          = { 1, 0, 1 },    //
 };
 
 #if HAL_DBG_TRACE == HAL_FEATURE_ON
@@ -425,6 +475,8 @@ static const char* host_cmd_str[CMD_MAX] = {
     [CMD_GET_BYPASS_JOIN_DUTY_CYCLE_BACKOFF] = "CMD_GET_BYPASS_JOIN_DUTY_CYCLE_BACKOFF",
     [CMD_SET_BYPASS_JOIN_DUTY_CYCLE_BACKOFF] = "CMD_SET_BYPASS_JOIN_DUTY_CYCLE_BACKOFF",
     [CMD_MODEM_GET_CRASHLOG]                 = "CMD_GET_CRASHLOG",
+    [CMD_GET_EVENTS]                         = "CMD_GET_EVENTS",
+    [CMD_GET_WAKE_STATS]                     = "CMD_GET_WAKE_STATS",
 };
 #endif
 
@@ -453,6 +505,7 @@ static const char* host_cmd_test_str[CMD_TST_MAX] = {
     [CMD_TST_WATCHDOG]             = "WATCHDOG",
     [CMD_TST_RADIO_READ]           = "RADIO_READ",
     [CMD_TST_RADIO_WRITE]          = "RADIO_WRITE",
+    [CMD_TST_RADIO_STATS]          = "RADIO_STATS",
 };
 #endif
 
@@ -550,13 +603,64 @@ static cmd_length_valid_t cmd_parser_check_cmd_size( host_cmd_id_t cmd_id, uint8
 static cmd_length_valid_t cmd_test_parser_check_cmd_size( host_cmd_test_id_t test_id, uint8_t length );
 
 /**
- * @brief Crc function used for LFU (Large File Upload)
+ * @brief Prepare the storage of a LFU (Large File Upload) file
+ *
+ * @param [in] size Size of the file
+ * @return uint8_t* Address of the file, NULL if the storage can not hold it
+ */
+static uint8_t* cmd_parser_lfu_storage_init( uint16_t size );
+
+/**
+ * @brief Append a chunk of a LFU (Large File Upload) file to its storage
+ *
+ * @param [in] data Chunk
+ * @param [in] len Length of the chunk
+ * @param [in] flush Last chunk, flush the pending data
+ * @return bool True if the chunk is stored
+ */
+static bool cmd_parser_lfu_storage_write( const uint8_t* data, uint16_t len, bool flush );
+
+/**
+ * @brief Serialize an event as returned by CMD_GET_EVENT
+ *
+ * @param [in] event Event to serialize
+ * @param [out] buffer Output buffer, at least CMD_EVENT_MAX_LENGTH bytes
+ * @return uint8_t Serialized length, 0 for an unknown event
+ */
+static uint8_t cmd_parser_event_serialize( const smtc_modem_event_t* event, uint8_t* buffer );
+
+/**
+ * @brief Serialize downlink metadata as returned by CMD_GET_DOWNLINK_METADATA
  *
- * @param [in] buf Payload buffer
- * @param [in] len Length of the payload
- * @return uint32_t The calculated CRC
+ * @param [in] metadata Metadata to serialize
+ * @param [out] buffer Output buffer, at least CMD_DL_METADATA_LENGTH bytes
+ * @return uint8_t Serialized length
  */
-uint32_t cmd_parser_crc( const uint8_t* buf, int len );
+static uint8_t cmd_parser_dl_metadata_serialize( const smtc_modem_dl_metadata_t* metadata, uint8_t* buffer );
+
+/**
+ * @brief Fetch the next downlink and serialize it inline in a CMD_GET_EVENTS record
+ *
+ * The downlink is kept for CMD_GET_DOWNLINK_DATA when it does not fit
+ *
+ * @param [out] buffer Output buffer
+ * @param [in] max_length Space left in the output buffer
+ * @return uint8_t Serialized length ([payload length][metadata][payload]), 0 if not inlined
+ */
+static uint8_t cmd_parser_dl_inline( uint8_t* buffer, uint16_t max_length );
+
+#if defined( CONFIG_LORA_BASICS_MODEM_DRIVERS_STATS )
+/**
+ * @brief Append a radio statistics counter to a CMD_TST_RADIO_STATS response, stats_walk callback
+ *
+ * @param [in] hdr Stats group
+ * @param [out] arg Test command response (cmd_tst_response_t)
+ * @param [in] name Counter name
+ * @param [in] off Counter offset in the group
+ * @return int 0 to continue the walk
+ */
+static int cmd_parser_stats_serialize( struct stats_hdr* hdr, void* arg, const char* name, uint16_t off );
+#endif
 /*
  * -----------------------------------------------------------------------------
  * --- PUBLIC FUNCTIONS DEFINITION ---------------------------------------------
@@ -602,117 +706,77 @@ cmd_parse_status_t parse_cmd( cmd_input_t* cmd_input, cmd_response_t* cmd_output
             break;
         }
 
-        // buffer[0]: event type
-        cmd_output->buffer[0] = events_lut[current_event.event_type];
+        // buffer[0]: event type, buffer[1]: missed event, buffer[2-N]; event data
+        cmd_output->length = cmd_parser_event_serialize( &current_event, cmd_output->buffer );
 
-        // buffer[1]: missed event
-        cmd_output->buffer[1] = current_event.missed_events;
+        // Handle event_pending_count
+        if( event_pending_count == 0 )
+        {
+            // de-assert hw_modem irq line to indicate host that all events have been retrieved
+            hw_modem_event_line_release( );
+        }
+        break;
+    }
+    case CMD_GET_EVENTS:
+    {
+        // buffer[0]: events still pending, then one record per event: [record length][event as CMD_GET_EVENT]
+        // DOWNDATA records are followed by [payload length][metadata][payload] when the downlink fits
+        smtc_modem_event_t current_event       = { 0 };
+        uint8_t            event_pending_count = 0;
+        uint16_t           offset              = 1;
 
-        // buffer[2-N]; event data, depend on event_type
-        switch( current_event.event_type )
+        while( ( offset + 1 + CMD_EVENT_MAX_LENGTH ) <= CMD_RESPONSE_MAX_LENGTH )
         {
-        case SMTC_MODEM_EVENT_RESET:
-            cmd_output->buffer[2] = ( uint8_t ) ( current_event.event_data.reset.count >> 8 );
-            cmd_output->buffer[3] = ( uint8_t ) ( current_event.event_data.reset.count );
-            cmd_output->length    = 4;
-            break;
-        case SMTC_MODEM_EVENT_TXDONE:
-            cmd_output->buffer[2] = current_event.event_data.txdone.status;
-            cmd_output->length    = 3;
-            break;
-        case SMTC_MODEM_EVENT_LINK_CHECK:
-            cmd_output->buffer[2] = current_event.event_data.link_check.status;
-            cmd_output->length    = 3;
-            break;
-        case SMTC_MODEM_EVENT_CLASS_B_PING_SLOT_INFO:
-            cmd_output->buffer[2] = current_event.event_data.class_b_ping_slot_info.status;
-            cmd_output->length    = 3;
-            break;
-        case SMTC_MODEM_EVENT_CLASS_B_STATUS:
-            cmd_output->buffer[2] = current_event.event_data.class_b_status.status;
-            cmd_output->length    = 3;
-            break;
-        case SMTC_MODEM_EVENT_LORAWAN_MAC_TIME:
-            cmd_output->buffer[2] = current_event.event_data.lorawan_mac_time.status;
-            cmd_output->length    = 3;
-            break;
-        case SMTC_MODEM_EVENT_LORAWAN_FUOTA_DONE:
-            cmd_output->buffer[2] = current_event.event_data.fuota_status.successful;
-            cmd_output->length    = 3;
-            break;
-        case SMTC_MODEM_EVENT_NEW_MULTICAST_SESSION_CLASS_C:
-            cmd_output->buffer[2] = current_event.event_data.new_multicast_class_c.group_id;
-            cmd_output->length    = 3;
-            break;
-        case SMTC_MODEM_EVENT_NEW_MULTICAST_SESSION_CLASS_B:
-            cmd_output->buffer[2] = current_event.event_data.new_multicast_class_b.group_id;
-            cmd_output->length    = 3;
-            break;
-        case SMTC_MODEM_EVENT_FIRMWARE_MANAGEMENT:
-            cmd_output->buffer[2] = current_event.event_data.fmp.status;
-            cmd_output->length    = 3;
-            break;
-        case SMTC_MODEM_EVENT_UPLOAD_DONE:
-            cmd_output->buffer[2] = current_event.event_data.uploaddone.status;
-            cmd_output->length    = 3;
-            break;
-        case SMTC_MODEM_EVENT_DM_SET_CONF:
-            cmd_output->buffer[2] = current_event.event_data.setconf.opcode;
-            cmd_output->length    = 3;
-            break;
-        case SMTC_MODEM_EVENT_MUTE:
-            cmd_output->buffer[2] = current_event.event_data.mute.status;
-            cmd_output->length    = 3;
-            break;
-        case SMTC_MODEM_EVENT_DOWNDATA:
-        case SMTC_MODEM_EVENT_ALCSYNC_TIME:
-        case SMTC_MODEM_EVENT_ALARM:
-        case SMTC_MODEM_EVENT_JOINED:
-        case SMTC_MODEM_EVENT_JOINFAIL:
-        case SMTC_MODEM_EVENT_NO_MORE_MULTICAST_SESSION_CLASS_C:
-        case SMTC_MODEM_EVENT_NO_MORE_MULTICAST_SESSION_CLASS_B:
-        case SMTC_MODEM_EVENT_STREAM_DONE:
-        case SMTC_MODEM_EVENT_GNSS_SCAN_DONE:
-        case SMTC_MODEM_EVENT_GNSS_TERMINATED:
-        case SMTC_MODEM_EVENT_GNSS_ALMANAC_DEMOD_UPDATE:
-        case SMTC_MODEM_EVENT_WIFI_SCAN_DONE:
-        case SMTC_MODEM_EVENT_WIFI_TERMINATED:
-            cmd_output->length = 2;
-            break;
+            if( smtc_modem_get_event( &current_event, &event_pending_count ) != SMTC_MODEM_RC_OK )
+            {
+                break;
+            }
 
-        case SMTC_MODEM_EVENT_RELAY_TX_DYNAMIC:
-        case SMTC_MODEM_EVENT_RELAY_TX_MODE:
-        case SMTC_MODEM_EVENT_RELAY_TX_SYNC:
-            cmd_output->buffer[2] = current_event.event_data.relay_tx.status;
-            cmd_output->length    = 3;
-            break;
-        case SMTC_MODEM_EVENT_RELAY_RX_RUNNING:
-            cmd_output->buffer[2] = current_event.event_data.relay_rx.status;
-            cmd_output->length    = 3;
-            break;
-        case SMTC_MODEM_EVENT_TEST_MODE:
-            cmd_output->buffer[2] = current_event.event_data.test_mode_status.status;
-            cmd_output->length    = 3;
-            break;
-        case SMTC_MODEM_EVENT_REGIONAL_DUTY_CYCLE:
-            cmd_output->buffer[2] = current_event.event_data.regional_duty_cycle.status;
-            cmd_output->length    = 3;
-            break;
-        default:
-            cmd_output->length = 0;
+            uint8_t* record = &cmd_output->buffer[offset];
+            record[0]       = cmd_parser_event_serialize( &current_event, &record[1] );
+            if( current_event.event_type == SMTC_MODEM_EVENT_DOWNDATA )
+            {
+                record[0] += cmd_parser_dl_inline( &record[1 + record[0]],
+                                                   CMD_RESPONSE_MAX_LENGTH - ( offset + 1 + record[0] ) );
+            }
+            offset += 1 + record[0];
+
+            if( event_pending_count == 0 )
+            {
+                break;
+            }
+        }
+
+        if( offset == 1 )
+        {
+            cmd_output->return_code = CMD_RC_NO_EVENT;
+            cmd_output->length      = 0;
             break;
         }
+        cmd_output->buffer[0] = event_pending_count;
+        cmd_output->length    = offset;
 
-        // Handle event_pending_count
         if( event_pending_count == 0 )
         {
             // de-assert hw_modem irq line to indicate host that all events have been retrieved
-            hal_gpio_set_value( HW_MODEM_EVENT_PIN, 0 );
+            hw_modem_event_line_release( );
         }
         break;
     }
     case CMD_GET_DOWNLINK_DATA:
     {
+        if( held_dl.valid == true )
+        {
+            // downlink already fetched by CMD_GET_EVENTS
+            memcpy( &cmd_output->buffer[2], held_dl.data, held_dl.length );
+            cmd_output->buffer[0]   = held_dl.remaining;
+            cmd_output->buffer[1]   = held_dl.length;
+            last_dl_metadata        = held_dl.metadata;
+            held_dl.valid           = false;
+            cmd_output->return_code = CMD_RC_OK;
+            cmd_output->length      = 2 + held_dl.length;
+            break;
+        }
         cmd_output->return_code = rc_lut[smtc_modem_get_downlink_data( &cmd_output->buffer[2], &cmd_output->buffer[1],
                                                                        &last_dl_metadata, &cmd_output->buffer[0] )];
 
@@ -725,20 +789,7 @@ cmd_parse_status_t parse_cmd( cmd_input_t* cmd_input, cmd_response_t* cmd_output
     case CMD_GET_DOWNLINK_METADATA:
     {
         cmd_output->return_code = CMD_RC_OK;
-
-        cmd_output->buffer[0]  = last_dl_metadata.stack_id;
-        cmd_output->buffer[1]  = last_dl_metadata.rssi;
-        cmd_output->buffer[2]  = last_dl_metadata.snr;
-        cmd_output->buffer[3]  = last_dl_metadata.window;
-        cmd_output->buffer[4]  = last_dl_metadata.fport;
-        cmd_output->buffer[5]  = last_dl_metadata.fpending_bit;
-        cmd_output->buffer[6]  = ( last_dl_metadata.frequency_hz >> 24 ) & 0xff;
-        cmd_output->buffer[7]  = ( last_dl_metadata.frequency_hz >> 16 ) & 0xff;
-        cmd_output->buffer[8]  = ( last_dl_metadata.frequency_hz >> 8 ) & 0xff;
-        cmd_output->buffer[9]  = ( last_dl_metadata.frequency_hz & 0xff );
-        cmd_output->buffer[10] = last_dl_metadata.datarate;
-
-        cmd_output->length = 11;
+        cmd_output->length      = cmd_parser_dl_metadata_serialize( &last_dl_metadata, cmd_output->buffer );
         break;
     }
     case CMD_RESET:
@@ -750,10 +801,46 @@ cmd_parse_status_t parse_cmd( cmd_input_t* cmd_input, cmd_response_t* cmd_output
     case CMD_RESET_CHARGE:
     {
         cmd_output->return_code = rc_lut[smtc_modem_reset_charge( )];
+#if defined( CONFIG_LORA_BASICS_MODEM_DRIVERS_ENERGY )
+        lora_lbm_energy_reset( transceiver_context );
+#endif
         break;
     }
     case CMD_GET_CHARGE:
     {
+#if defined( CONFIG_LORA_BASICS_MODEM_DRIVERS_ENERGY )
+        // Optional payload: transceiver activity (enum lora_lbm_energy_category)
+        // Returns its charge in uAh and the time spent in ms
+        if( cmd_input->length == 1 )
+        {
+            struct lora_lbm_energy_stats stats;
+            uint8_t                      category = cmd_input->buffer[0];
+
+            if( category >= LORA_LBM_ENERGY_CATEGORY_COUNT )
+            {
+                cmd_output->return_code = CMD_RC_INVALID;
+                break;
+            }
+            lora_lbm_energy_get_stats( transceiver_context, &stats );
+
+            // rounded to the nearest uAh, a few RX windows stay below 1 uAh
+            uint32_t charge_uah = ( uint32_t ) ( ( stats.charge_ua_ms[category] + 1800000 ) / 3600000 );
+            uint32_t time_ms =
+                ( stats.time_ms[category] > UINT32_MAX ) ? UINT32_MAX : ( uint32_t ) stats.time_ms[category];
+
+            cmd_output->buffer[0]   = ( charge_uah >> 24 ) & 0xFF;
+            cmd_output->buffer[1]   = ( charge_uah >> 16 ) & 0xFF;
+            cmd_output->buffer[2]   = ( charge_uah >> 8 ) & 0xFF;
+            cmd_output->buffer[3]   = ( charge_uah & 0xFF );
+            cmd_output->buffer[4]   = ( time_ms >> 24 ) & 0xFF;
+            cmd_output->buffer[5]   = ( time_ms >> 16 ) & 0xFF;
+            cmd_output->buffer[6]   = ( time_ms >> 8 ) & 0xFF;
+            cmd_output->buffer[7]   = ( time_ms & 0xFF );
+            cmd_output->length      = 8;
+            cmd_output->return_code = CMD_RC_OK;
+            break;
+        }
+#endif
         uint32_t charge         = 0;
         cmd_output->return_code = rc_lut[smtc_modem_get_charge( &charge )];
         if( cmd_output->return_code == CMD_RC_OK )
@@ -1604,11 +1691,18 @@ cmd_parse_status_t parse_cmd( cmd_input_t* cmd_input, cmd_response_t* cmd_output
         file_size           = size;
         upload_status       = UPLOAD_NOT_INIT;
         upload_current_size = 0;
-        // empty the file_storage buffer
-        memset( file_store, 0, FILE_UPLOAD_MAX_SIZE );
+        upload_current_crc  = 0;
+
+        uint8_t* file = cmd_parser_lfu_storage_init( file_size );
+        if( file == NULL )
+        {
+            cmd_output->return_code = CMD_RC_INVALID;
+            SMTC_HAL_TRACE_ERROR( "Upload file size invalid\n" );
+            break;
+        }
 
         cmd_output->return_code = rc_lut[smtc_modem_file_upload_init(
-            STACK_ID, cmd_input->buffer[0], cmd_input->buffer[1], file_store, file_size, average_delay )];
+            STACK_ID, cmd_input->buffer[0], cmd_input->buffer[1], file, file_size, average_delay )];
         if( cmd_output->return_code == CMD_RC_OK )
         {
             upload_status = UPLOAD_INIT;
@@ -1647,8 +1741,17 @@ cmd_parse_status_t parse_cmd( cmd_input_t* cmd_input, cmd_response_t* cmd_output
             }
             else
             {
-                memcpy( ( uint8_t* ) file_store + upload_current_size, &cmd_input->buffer[0], cmd_input->length );
+                // The last chunk flushes the flash staging buffer
+                bool last = ( upload_current_size + cmd_input->length ) == file_size;
+
+                if( cmd_parser_lfu_storage_write( &cmd_input->buffer[0], cmd_input->length, last ) == false )
+                {
+                    cmd_output->return_code = CMD_RC_FAIL;
+                    SMTC_HAL_TRACE_ERROR( "Upload file data, storage failed\n" );
+                    break;
+                }
                 upload_current_size += cmd_input->length;
+                upload_current_crc = crc32_ieee_update( upload_current_crc, &cmd_input->buffer[0], cmd_input->length );
 
                 upload_status = UPLOAD_DATA_ON_GOING;
             }
@@ -1670,7 +1773,7 @@ cmd_parse_status_t parse_cmd( cmd_input_t* cmd_input, cmd_response_t* cmd_output
             SMTC_HAL_TRACE_ERROR( "Data size uploaded does not correspond to what was defined\n" );
             smtc_modem_file_upload_reset( STACK_ID );
         }
-        else if( input_crc != cmd_parser_crc( file_store, file_size ) )
+        else if( input_crc != upload_current_crc )
         {
             cmd_output->return_code = CMD_RC_BAD_CRC;
             SMTC_HAL_TRACE_ERROR( "Bad crc after uploading file data\n" );
@@ -1832,6 +1935,26 @@ cmd_parse_status_t parse_cmd( cmd_input_t* cmd_input, cmd_response_t* cmd_output
         cmd_output->return_code = CMD_RC_OK;
         break;
     }
+    case CMD_GET_WAKE_STATS:
+    {
+        // Main loop wake-ups per reason (hw_modem_wake_reason_t order), 4 bytes each
+        // Optional payload: 1 to clear the histogram once read
+        for( int i = 0; i < HW_MODEM_WAKE_REASON_COUNT; i++ )
+        {
+            uint32_t count                = hw_modem_get_wake_count( i );
+            cmd_output->buffer[4 * i]     = ( count >> 24 ) & 0xff;
+            cmd_output->buffer[4 * i + 1] = ( count >> 16 ) & 0xff;
+            cmd_output->buffer[4 * i + 2] = ( count >> 8 ) & 0xff;
+            cmd_output->buffer[4 * i + 3] = ( count & 0xff );
+        }
+        if( ( cmd_input->length == 1 ) && ( cmd_input->buffer[0] == 1 ) )
+        {
+            hw_modem_reset_wake_counts( );
+        }
+        cmd_output->length      = 4 * HW_MODEM_WAKE_REASON_COUNT;
+        cmd_output->return_code = CMD_RC_OK;
+        break;
+    }
 #if (defined( STM32L476xx ) || defined (NRF52840_XXAA))
     case CMD_STORE_AND_FORWARD_SET_STATE:
     {
@@ -2669,6 +2792,28 @@ cmd_parse_status_t cmd_test_parser( cmd_tst_input_t* cmd_tst_input, cmd_tst_resp
         cmd_tst_output->length = 0;
         break;
     }
+    case CMD_TST_RADIO_STATS:
+    {
+#if defined( CONFIG_LORA_BASICS_MODEM_DRIVERS_STATS )
+        // Radio statistics in the lora_lbm stats group order, 4 bytes each
+        // Optional payload: 1 to clear them once read
+        struct stats_hdr* hdr = stats_group_find( LORA_LBM_STATS_GROUP );
+
+        if( hdr == NULL )
+        {
+            cmd_tst_output->return_code = CMD_RC_FAIL;
+            break;
+        }
+        stats_walk( hdr, cmd_parser_stats_serialize, cmd_tst_output );
+        if( ( cmd_tst_input->length == 1 ) && ( cmd_tst_input->buffer[0] == 1 ) )
+        {
+            stats_reset( hdr );
+        }
+#else
+        cmd_tst_output->return_code = CMD_RC_NOT_IMPLEMENTED;
+#endif
+        break;
+    }
     default:
     {
         cmd_tst_output->return_code = CMD_RC_UNKNOWN;
@@ -2689,6 +2834,132 @@ cmd_parse_status_t cmd_test_parser( cmd_tst_input_t* cmd_tst_input, cmd_tst_resp
  * --- PRIVATE FUNCTIONS DEFINITION --------------------------------------------
  */
 
+static uint8_t cmd_parser_event_serialize( const smtc_modem_event_t* event, uint8_t* buffer )
+{
+    // buffer[0]: event type
+    buffer[0] = events_lut[event->event_type];
+
+    // buffer[1]: missed event
+    buffer[1] = event->missed_events;
+
+    // buffer[2-N]; event data, depend on event_type
+    switch( event->event_type )
+    {
+    case SMTC_MODEM_EVENT_RESET:
+        buffer[2] = ( uint8_t ) ( event->event_data.reset.count >> 8 );
+        buffer[3] = ( uint8_t ) ( event->event_data.reset.count );
+        return 4;
+    case SMTC_MODEM_EVENT_TXDONE:
+        buffer[2] = event->event_data.txdone.status;
+        return 3;
+    case SMTC_MODEM_EVENT_LINK_CHECK:
+        buffer[2] = event->event_data.link_check.status;
+        return 3;
+    case SMTC_MODEM_EVENT_CLASS_B_PING_SLOT_INFO:
+        buffer[2] = event->event_data.class_b_ping_slot_info.status;
+        return 3;
+    case SMTC_MODEM_EVENT_CLASS_B_STATUS:
+        buffer[2] = event->event_data.class_b_status.status;
+        return 3;
+    case SMTC_MODEM_EVENT_LORAWAN_MAC_TIME:
+        buffer[2] = event->event_data.lorawan_mac_time.status;
+        return 3;
+    case SMTC_MODEM_EVENT_LORAWAN_FUOTA_DONE:
+        buffer[2] = event->event_data.fuota_status.successful;
+        return 3;
+    case SMTC_MODEM_EVENT_NEW_MULTICAST_SESSION_CLASS_C:
+        buffer[2] = event->event_data.new_multicast_class_c.group_id;
+        return 3;
+    case SMTC_MODEM_EVENT_NEW_MULTICAST_SESSION_CLASS_B:
+        buffer[2] = event->event_data.new_multicast_class_b.group_id;
+        return 3;
+    case SMTC_MODEM_EVENT_FIRMWARE_MANAGEMENT:
+        buffer[2] = event->event_data.fmp.status;
+        return 3;
+    case SMTC_MODEM_EVENT_UPLOAD_DONE:
+        buffer[2] = event->event_data.uploaddone.status;
+        return 3;
+    case SMTC_MODEM_EVENT_DM_SET_CONF:
+        buffer[2] = event->event_data.setconf.opcode;
+        return 3;
+    case SMTC_MODEM_EVENT_MUTE:
+        buffer[2] = event->event_data.mute.status;
+        return 3;
+    case SMTC_MODEM_EVENT_DOWNDATA:
+    case SMTC_MODEM_EVENT_ALCSYNC_TIME:
+    case SMTC_MODEM_EVENT_ALARM:
+    case SMTC_MODEM_EVENT_JOINED:
+    case SMTC_MODEM_EVENT_JOINFAIL:
+    case SMTC_MODEM_EVENT_NO_MORE_MULTICAST_SESSION_CLASS_C:
+    case SMTC_MODEM_EVENT_NO_MORE_MULTICAST_SESSION_CLASS_B:
+    case SMTC_MODEM_EVENT_STREAM_DONE:
+    case SMTC_MODEM_EVENT_GNSS_SCAN_DONE:
+    case SMTC_MODEM_EVENT_GNSS_TERMINATED:
+    case SMTC_MODEM_EVENT_GNSS_ALMANAC_DEMOD_UPDATE:
+    case SMTC_MODEM_EVENT_WIFI_SCAN_DONE:
+    case SMTC_MODEM_EVENT_WIFI_TERMINATED:
+        return 2;
+    case SMTC_MODEM_EVENT_RELAY_TX_DYNAMIC:
+    case SMTC_MODEM_EVENT_RELAY_TX_MODE:
+    case SMTC_MODEM_EVENT_RELAY_TX_SYNC:
+        buffer[2] = event->event_data.relay_tx.status;
+        return 3;
+    case SMTC_MODEM_EVENT_RELAY_RX_RUNNING:
+        buffer[2] = event->event_data.relay_rx.status;
+        return 3;
+    case SMTC_MODEM_EVENT_TEST_MODE:
+        buffer[2] = event->event_data.test_mode_status.status;
+        return 3;
+    case SMTC_MODEM_EVENT_REGIONAL_DUTY_CYCLE:
+        buffer[2] = event->event_data.regional_duty_cycle.status;
+        return 3;
+    default:
+        return 0;
+    }
+}
+
+static uint8_t cmd_parser_dl_metadata_serialize( const smtc_modem_dl_metadata_t* metadata, uint8_t* buffer )
+{
+    buffer[0]  = metadata->stack_id;
+    buffer[1]  = metadata->rssi;
+    buffer[2]  = metadata->snr;
+    buffer[3]  = metadata->window;
+    buffer[4]  = metadata->fport;
+    buffer[5]  = metadata->fpending_bit;
+    buffer[6]  = ( metadata->frequency_hz >> 24 ) & 0xff;
+    buffer[7]  = ( metadata->frequency_hz >> 16 ) & 0xff;
+    buffer[8]  = ( metadata->frequency_hz >> 8 ) & 0xff;
+    buffer[9]  = ( metadata->frequency_hz & 0xff );
+    buffer[10] = metadata->datarate;
+    return CMD_DL_METADATA_LENGTH;
+}
+
+static uint8_t cmd_parser_dl_inline( uint8_t* buffer, uint16_t max_length )
+{
+    if( held_dl.valid == false )
+    {
+        if( smtc_modem_get_downlink_data( held_dl.data, &held_dl.length, &held_dl.metadata, &held_dl.remaining ) !=
+            SMTC_MODEM_RC_OK )
+        {
+            return 0;
+        }
+        held_dl.valid = true;
+    }
+
+    if( ( 1 + CMD_DL_METADATA_LENGTH + held_dl.length ) > max_length )
+    {
+        // host gets it with CMD_GET_DOWNLINK_DATA
+        return 0;
+    }
+
+    buffer[0] = held_dl.length;
+    cmd_parser_dl_metadata_serialize( &held_dl.metadata, &buffer[1] );
+    memcpy( &buffer[1 + CMD_DL_METADATA_LENGTH], held_dl.data, held_dl.length );
+    last_dl_metadata = held_dl.metadata;
+    held_dl.valid    = false;
+    return 1 + CMD_DL_METADATA_LENGTH + held_dl.length;
+}
+
 static cmd_length_valid_t cmd_parser_check_cmd_size( host_cmd_id_t cmd_id, uint8_t length )
 {
     // cmd len too small
@@ -2723,19 +2994,63 @@ static cmd_length_valid_t cmd_test_parser_check_cmd_size( host_cmd_test_id_t tst
     return CMD_LENGTH_VALID;
 }
 
-uint32_t cmd_parser_crc( const uint8_t* buf, int len )
+#if defined( CONFIG_HW_MODEM_LFU_FLASH )
+
+static uint8_t* cmd_parser_lfu_storage_init( uint16_t size )
 {
-    uint32_t crc = 0xFFFFFFFF;
-    while( len-- > 0 )
+    if( size > FILE_UPLOAD_MAX_SIZE )
     {
-        crc = crc ^ *buf++;
-        for( int i = 0; i < 8; i++ )
-        {
-            uint32_t mask = -( crc & 1 );
-            crc           = ( crc >> 1 ) ^ ( 0xEDB88320 & mask );
-        }
+        return NULL;
     }
-    return ~crc;
+
+    // Pages are erased as the stream progresses
+    if( stream_flash_init( &file_stream, FIXED_PARTITION_DEVICE( LFU_PARTITION ), file_stream_buffer,
+                           sizeof( file_stream_buffer ), FIXED_PARTITION_OFFSET( LFU_PARTITION ),
+                           FIXED_PARTITION_SIZE( LFU_PARTITION ), NULL ) != 0 )
+    {
+        return NULL;
+    }
+    return ( uint8_t* ) LFU_FILE_ADDRESS;
+}
+
+static bool cmd_parser_lfu_storage_write( const uint8_t* data, uint16_t len, bool flush )
+{
+    return stream_flash_buffered_write( &file_stream, data, len, flush ) == 0;
 }
 
+#else
+
+static uint8_t* cmd_parser_lfu_storage_init( uint16_t size )
+{
+    if( size > FILE_UPLOAD_MAX_SIZE )
+    {
+        return NULL;
+    }
+    return file_store;
+}
+
+static bool cmd_parser_lfu_storage_write( const uint8_t* data, uint16_t len, bool flush )
+{
+    memcpy( file_store + upload_current_size, data, len );
+    return true;
+}
+
+#endif  // CONFIG_HW_MODEM_LFU_FLASH
+
+#if defined( CONFIG_LORA_BASICS_MODEM_DRIVERS_STATS )
+static int cmd_parser_stats_serialize( struct stats_hdr* hdr, void* arg, const char* name, uint16_t off )
+{
+    cmd_tst_response_t* cmd_tst_output = arg;
+    uint32_t            count          = *( uint32_t* ) ( ( uint8_t* ) hdr + off );
+    uint8_t*            buffer         = &cmd_tst_output->buffer[cmd_tst_output->length];
+
+    buffer[0] = ( count >> 24 ) & 0xff;
+    buffer[1] = ( count >> 16 ) & 0xff;
+    buffer[2] = ( count >> 8 ) & 0xff;
+    buffer[3] = ( count & 0xff );
+    cmd_tst_output->length += 4;
+    return 0;
+}
+#endif
+
 /* --- EOF ------------------------------------------------------------------ */
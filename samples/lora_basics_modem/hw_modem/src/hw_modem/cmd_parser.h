@@ -178,6 +178,8 @@ typedef enum host_cmd_id_e
     CMD_GET_BYPASS_JOIN_DUTY_CYCLE_BACKOFF = 0x96,
     CMD_SET_BYPASS_JOIN_DUTY_CYCLE_BACKOFF = 0x97,
     CMD_MODEM_GET_CRASHLOG                 = 0x98,
+    CMD_GET_EVENTS                         = 0x99,
+    CMD_GET_WAKE_STATS                     = 0x9A,
     CMD_MAX
 } host_cmd_id_t;
 
@@ -205,6 +207,7 @@ typedef enum host_cmd_test_id_e
     CMD_TST_WATCHDOG             = 0x10,
     CMD_TST_RADIO_READ           = 0x11,
     CMD_TST_RADIO_WRITE          = 0x12,
+    CMD_TST_RADIO_STATS          = 0x13,
     CMD_TST_MAX
 } host_cmd_test_id_t;
 
@@ -39,18 +39,15 @@ LOG_MODULE_DECLARE(hw_modem, 3);
 
 #define HW_MODEM_RX_BUFF_MAX_LENGTH 261
 
+// application specific wake-up reasons of the main loop
+#define HW_MODEM_WAKE_HOST_CMD BIT( SMTC_MODEM_HAL_WAKE_APP_SHIFT )
+#define HW_MODEM_WAKE_MODEM_EVENT BIT( SMTC_MODEM_HAL_WAKE_APP_SHIFT + 1 )
+
 /*
  * -----------------------------------------------------------------------------
  * --- PRIVATE TYPES -----------------------------------------------------------
  */
 
-typedef enum
-{
-    HW_MODEM_LP_ENABLE,
-    HW_MODEM_LP_DISABLE_ONCE,
-    HW_MODEM_LP_DISABLE,
-} hw_modem_lp_mode_t;
-
 /*
  * -----------------------------------------------------------------------------
  * --- PRIVATE VARIABLES -------------------------------------------------------
@@ -62,7 +59,26 @@ static uint8_t            response_length;
 static volatile bool      hw_cmd_available             = false;
 static volatile bool      is_hw_modem_ready_to_receive = true;
 static hal_gpio_irq_t     wakeup_line_irq              = { 0 };
-static hw_modem_lp_mode_t lp_mode                      = HW_MODEM_LP_ENABLE;
+
+// wake-up histogram of the main loop, and the wake-up bits counted in each bin
+static uint32_t       wake_counts[HW_MODEM_WAKE_REASON_COUNT];
+static const uint32_t wake_reason_bits[HW_MODEM_WAKE_REASON_COUNT] = {
+    [HW_MODEM_WAKE_REASON_HOST_CMD]    = HW_MODEM_WAKE_HOST_CMD,
+    [HW_MODEM_WAKE_REASON_RADIO_IRQ]   = SMTC_MODEM_HAL_WAKE_RADIO_IRQ,
+    [HW_MODEM_WAKE_REASON_TIMER]       = SMTC_MODEM_HAL_WAKE_TIMER,
+    [HW_MODEM_WAKE_REASON_LBM]         = SMTC_MODEM_HAL_WAKE_LBM,
+    [HW_MODEM_WAKE_REASON_MODEM_EVENT] = HW_MODEM_WAKE_MODEM_EVENT,
+};
+
+// response sent by the system work queue once the bridge turnaround delay elapsed
+static struct k_work_delayable response_work;
+// cycle count when the host released the COMMAND line, for turnaround measurement
+static volatile uint32_t cmd_end_cycles;
+static uint32_t          turnaround_max_us;
+
+// events notified since the EVENT line was released, and hold-off before raising it
+static uint32_t       event_burst_count;
+static struct k_timer event_holdoff_timer;
 
 /*
  * -----------------------------------------------------------------------------
@@ -90,6 +106,20 @@ void wakeup_line_irq_handler( void* context );
  */
 void hw_modem_event_handler( void );
 
+/**
+ * @brief send the prepared response on uart and report the command turnaround time
+ * @param *work  unused work item
+ * @return none
+ */
+void hw_modem_send_response( struct k_work* work );
+
+/**
+ * @brief raise the EVENT line once the event hold-off time elapsed
+ * @param *timer  unused timer
+ * @return none
+ */
+void hw_modem_event_holdoff_expiry( struct k_timer* timer );
+
 /*
  * -----------------------------------------------------------------------------
  * --- PUBLIC FUNCTIONS DEFINITION ---------------------------------------------
@@ -113,6 +143,8 @@ void hw_modem_init( void )
     memset( modem_response_buff, 0, HW_MODEM_RX_BUFF_MAX_LENGTH );
     hw_cmd_available             = false;
     is_hw_modem_ready_to_receive = true;
+    k_work_init_delayable( &response_work, hw_modem_send_response );
+    k_timer_init( &event_holdoff_timer, hw_modem_event_holdoff_expiry, NULL );
 
     // init the soft modem
     smtc_modem_init( &hw_modem_event_handler );
@@ -190,23 +222,24 @@ void hw_modem_process_cmd( void )
         LOG_HEXDUMP_INF(modem_response_buff, response_length+2, "Cmd output on uart");
         // SMTC_HAL_TRACE_ARRAY( "Cmd output on uart", modem_response_buff, response_length + 2 );
 
-        // now the hw modem can accept new commands
-        is_hw_modem_ready_to_receive = true;
-        hw_cmd_available             = false;
-
-        // set busy pin to indicate to bridge or host that the hw_modem answer will be soon sent
-        hal_gpio_set_value( HW_MODEM_BUSY_PIN, 1 );
-
-        // wait to to bridge delay
-        hal_mcu_wait_us( 1000 );
-
         for( int i = 0; i < response_length + 2; i++ )
         {
             crc = crc ^ modem_response_buff[i];
         }
         modem_response_buff[response_length + 2] = crc;
 
-        hw_modem_uart_tx( modem_response_buff, response_length + 3 );
+        // new commands are accepted once the response is sent, see hw_modem_send_response
+        hw_cmd_available = false;
+
+        // set busy pin to indicate to bridge or host that the hw_modem answer will be soon sent
+        hal_gpio_set_value( HW_MODEM_BUSY_PIN, 1 );
+
+        // send after the bridge delay, the modem engine keeps running meanwhile
+#if( CONFIG_HW_MODEM_RESPONSE_DELAY_US > 0 )
+        k_work_schedule( &response_work, K_USEC( CONFIG_HW_MODEM_RESPONSE_DELAY_US ) );
+#else
+        hw_modem_send_response( NULL );
+#endif
     }
     else
     {
@@ -224,24 +257,48 @@ bool hw_modem_is_a_cmd_available( void )
     return hw_cmd_available;
 }
 
-bool hw_modem_is_low_power_ok( void )
+void hw_modem_event_line_release( void )
 {
-    if( lp_mode == HW_MODEM_LP_ENABLE )
+    k_timer_stop( &event_holdoff_timer );
+    event_burst_count = 0;
+    hal_gpio_set_value( HW_MODEM_EVENT_PIN, 0 );
+}
+
+void hw_modem_sleep( uint32_t sleep_time_ms )
+{
+    uint32_t reasons = smtc_modem_hal_wait_for_wake_up( K_MSEC( sleep_time_ms ) );
+
+    if( reasons == 0 )
     {
-        return true;
+        wake_counts[HW_MODEM_WAKE_REASON_TIMEOUT]++;
+        return;
     }
-    else if( lp_mode == HW_MODEM_LP_DISABLE_ONCE )
+
+    // a wake-up can have several reasons, count each of them
+    for( int i = 0; i < HW_MODEM_WAKE_REASON_COUNT; i++ )
     {
-        // next time lp  will be ok
-        lp_mode = HW_MODEM_LP_ENABLE;
-        return false;
+        if( ( reasons & wake_reason_bits[i] ) != 0 )
+        {
+            wake_counts[i]++;
+            reasons &= ~wake_reason_bits[i];
+        }
     }
-    else
+    if( reasons != 0 )
     {
-        return false;
+        wake_counts[HW_MODEM_WAKE_REASON_OTHER]++;
     }
 }
 
+uint32_t hw_modem_get_wake_count( hw_modem_wake_reason_t reason )
+{
+    return ( reason < HW_MODEM_WAKE_REASON_COUNT ) ? wake_counts[reason] : 0;
+}
+
+void hw_modem_reset_wake_counts( void )
+{
+    memset( wake_counts, 0, sizeof( wake_counts ) );
+}
+
 /*
  * -----------------------------------------------------------------------------
  * --- PRIVATE FUNCTIONS DEFINITION --------------------------------------------
@@ -254,9 +311,6 @@ void wakeup_line_irq_handler( void* context )
         // start receiving uart with dma
         hw_modem_start_reception( );
 
-        // force exit of stop mode
-        lp_mode = HW_MODEM_LP_DISABLE;
-
         // TEMPORARY WORKAROUND to avoid issue for print in hw_modem_process_cmd function
         // k_busy_wait( 2000 );
     }
@@ -266,23 +320,57 @@ void wakeup_line_irq_handler( void* context )
         hw_modem_uart_dma_stop_rx( );
 
         // inform that a command has arrived
+        cmd_end_cycles   = k_cycle_get_32( );
         hw_cmd_available = true;
 
-        // wake up thread to process the command
-        smtc_modem_hal_wake_up();
+        // wake up thread to process the command, whatever the sleep time requested by the engine
+        smtc_modem_hal_wake_up_with_reason( HW_MODEM_WAKE_HOST_CMD );
+    }
+}
+
+void hw_modem_send_response( struct k_work* work )
+{
+    ARG_UNUSED( work );
+
+    hw_modem_uart_tx( modem_response_buff, response_length + 3 );
 
-        // force one more loop in main loop and then re-enable low power feature
-        lp_mode = HW_MODEM_LP_DISABLE_ONCE;
-        // smtc_modem_hal_wake_up();
+    // now the hw modem can accept new commands, the response buffer is free again
+    is_hw_modem_ready_to_receive = true;
+
+    // from COMMAND line release to the last response byte, processing and bridge delay included
+    uint32_t turnaround_us = k_cyc_to_us_floor32( k_cycle_get_32( ) - cmd_end_cycles );
+    if( turnaround_us > turnaround_max_us )
+    {
+        turnaround_max_us = turnaround_us;
     }
+    LOG_INF( "Cmd turnaround %u us (max %u us)", turnaround_us, turnaround_max_us );
 }
 
-void hw_modem_event_handler( void )
+void hw_modem_event_holdoff_expiry( struct k_timer* timer )
 {
-    // raise the event line to indicate to host that events are available
+    ARG_UNUSED( timer );
+
     hal_gpio_set_value( HW_MODEM_EVENT_PIN, 1 );
-    smtc_modem_hal_wake_up();
-    LOG_INF( "Event available");
+}
+
+void hw_modem_event_handler( void )
+{
+    event_burst_count++;
+    LOG_DBG( "Event available (%u in burst)", event_burst_count );
+
+    // raise the event line to indicate to host that events are available, either at once or when the burst
+    // reached the coalescing count or hold-off time, so that the host wakes up once per burst
+    if( ( CONFIG_HW_MODEM_EVENT_HOLDOFF_MS == 0 ) ||
+        ( ( CONFIG_HW_MODEM_EVENT_COALESCE_COUNT > 0 ) && ( event_burst_count >= CONFIG_HW_MODEM_EVENT_COALESCE_COUNT ) ) )
+    {
+        k_timer_stop( &event_holdoff_timer );
+        hal_gpio_set_value( HW_MODEM_EVENT_PIN, 1 );
+    }
+    else if( event_burst_count == 1 )
+    {
+        k_timer_start( &event_holdoff_timer, K_MSEC( CONFIG_HW_MODEM_EVENT_HOLDOFF_MS ), K_NO_WAIT );
+    }
+    smtc_modem_hal_wake_up_with_reason( HW_MODEM_WAKE_MODEM_EVENT );
 }
 
 /* --- EOF ------------------------------------------------------------------ */
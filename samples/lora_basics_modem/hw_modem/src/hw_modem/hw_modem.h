@@ -29,6 +29,21 @@ extern "C" {
  * --- PUBLIC TYPES ------------------------------------------------------------
  */
 
+/**
+ * @brief Wake-up reasons of the main loop, bins of the wake-up histogram
+ */
+typedef enum hw_modem_wake_reason_e
+{
+    HW_MODEM_WAKE_REASON_TIMEOUT,      //!< Sleep time requested by the engine elapsed
+    HW_MODEM_WAKE_REASON_HOST_CMD,     //!< Command received from the host
+    HW_MODEM_WAKE_REASON_RADIO_IRQ,    //!< Transceiver event
+    HW_MODEM_WAKE_REASON_TIMER,        //!< Modem timer expiry
+    HW_MODEM_WAKE_REASON_LBM,          //!< Request of the stack
+    HW_MODEM_WAKE_REASON_MODEM_EVENT,  //!< Modem event for the host
+    HW_MODEM_WAKE_REASON_OTHER,
+    HW_MODEM_WAKE_REASON_COUNT,
+} hw_modem_wake_reason_t;
+
 /*
  * -----------------------------------------------------------------------------
  * --- PUBLIC FUNCTIONS DEFINITION ---------------------------------------------
@@ -52,11 +67,29 @@ void hw_modem_process_cmd( void );
 bool hw_modem_is_a_cmd_available( void );
 
 /**
- * @brief Indicates if main application can go in low power
+ * @brief Sleep until the engine sleep time elapsed or something wakes the modem up, host commands included
+ *
+ * @param [in] sleep_time_ms Maximum sleep time
+ */
+void hw_modem_sleep( uint32_t sleep_time_ms );
+
+/**
+ * @brief Get the number of wake-ups of the main loop for a reason
  *
- * @return true/false
+ * @param [in] reason Wake-up reason
+ * @return uint32_t Number of wake-ups since boot or last reset
+ */
+uint32_t hw_modem_get_wake_count( hw_modem_wake_reason_t reason );
+
+/**
+ * @brief Clear the wake-up histogram
+ */
+void hw_modem_reset_wake_counts( void );
+
+/**
+ * @brief De-assert the EVENT line once the host retrieved all the events, and start a new event burst
  */
-bool hw_modem_is_low_power_ok( void );
+void hw_modem_event_line_release( void );
 
 #ifdef __cplusplus
 }
@@ -29,6 +29,7 @@
 
 #include <zephyr/kernel.h>
 #include <smtc_modem_hal_init.h>
+#include <lora_lbm_tracing.h>
 
 #include <zephyr/logging/log.h>
 
@@ -108,36 +109,28 @@ void main_hw_modem( void )
         if( hw_modem_is_a_cmd_available( ) == true )
         {
             // Command may generate work for the stack, so drop down to smtc_modem_run_engine().
+            LORA_LBM_TRACE_BEGIN( host_cmd, 0 );
             hw_modem_process_cmd( );
+            LORA_LBM_TRACE_END( host_cmd, 0 );
         }
 
         // Modem process launch
+        LORA_LBM_TRACE_BEGIN( engine, 0 );
         sleep_time_ms = smtc_modem_run_engine( );
+        LORA_LBM_TRACE_END( engine, sleep_time_ms );
 
-
-	// Atomically check sleep conditions (no command available and low power is possible)
-	//
-	// NOTE: We have to remove the hal_mcu_disable_irq() and hal_mcu_enable_irq() calls
-	// here because of the way GPIO interrupts are implemented in smtc_hal_gpio.c.
-	//
-	// Even as the code as now, any command received while hal_mcu_set_sleep_for_ms is active
-	// will wait for hal_mcu_set_sleep_for_ms to finish before being processed.
-	// Is this intended?? (up to 20s delay between commands?)
-
-        // hal_mcu_disable_irq( );
-        if( ( hw_modem_is_a_cmd_available( ) == false ) && ( hw_modem_is_low_power_ok( ) == true ) &&
-            ( smtc_modem_is_irq_flag_pending( ) == false ) )
+        // Sleep conditions: no command available and no pending stack work.
+        // Wake-ups are latched, so a command received from here on ends the sleep straight away.
+        if( ( hw_modem_is_a_cmd_available( ) == false ) && ( smtc_modem_is_irq_flag_pending( ) == false ) )
         {
             hal_watchdog_reload( );
 
             uint32_t real_sleep_time_ms = MIN( sleep_time_ms, WATCHDOG_RELOAD_PERIOD_MS );
-            // LOG_INF( "Sleeping for %d ms", real_sleep_time_ms);
-            // hal_mcu_set_sleep_for_ms(real_sleep_time_ms);
-            // real_sleep_time_ms = 1;
-            smtc_modem_hal_interruptible_msleep(K_MSEC(real_sleep_time_ms));
+            LORA_LBM_TRACE_BEGIN( sleep, real_sleep_time_ms );
+            hw_modem_sleep( real_sleep_time_ms );
+            LORA_LBM_TRACE_END( sleep, 0 );
         }
         hal_watchdog_reload( );
-	// hal_mcu_enable_irq( );
     }
 }
 
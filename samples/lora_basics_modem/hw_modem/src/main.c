@@ -8,6 +8,7 @@
 #include "smtc_modem_hal_init.h"
 #include "smtc_modem_utilities.h"
 #include <smtc_modem_api.h>
+#include <lora_lbm_transceiver.h>
 
 #include "cmd_parser.h"
 
@@ -92,7 +93,7 @@ int main(void)
 #endif /* CONFIG_LORA_BASICS_MODEM_FUOTA */
 	};
 
-	smtc_modem_set_radio_context(transceiver);
+	smtc_modem_set_radio_context(lora_transceiver_get_ral_context(transceiver));
 	smtc_modem_hal_init(transceiver);
 	smtc_modem_hal_register_callbacks(&prv_hal_cb);
 
@@ -20,6 +20,7 @@
 #include "smtc_hal_gpio.h"
 #include "smtc_hal_watchdog.h"
 #include <smtc_modem_hal_init.h>
+#include <lora_lbm_transceiver.h>
 
 // #include "modem_pinout.h"
 
@@ -284,7 +285,7 @@ int                                main( void )
 
 	smtc_modem_hal_init(transceiver);
 	smtc_modem_hal_register_callbacks(&prv_hal_cb);
-    smtc_modem_set_radio_context(transceiver);
+    smtc_modem_set_radio_context( lora_transceiver_get_ral_context( transceiver ) );
 
     // Disable IRQ to avoid unwanted behavior during init
     hal_mcu_disable_irq( );
@@ -35,6 +35,8 @@ LOG_MODULE_REGISTER(porting_tests, 3);
 
 #if defined( SX128X )
 #include "ralf_sx128x.h"
+#elif defined( SX127X )
+#include "ralf_sx127x.h"
 #elif defined( SX126X )
 #include "ralf_sx126x.h"
 #include "sx126x.h"
@@ -57,6 +59,12 @@ LOG_MODULE_REGISTER(porting_tests, 3);
 
 #define NB_LOOP_TEST_SPI 2
 #define NB_LOOP_TEST_CONFIG_RADIO 2
+#define NB_LOOP_TEST_RADIO_IRQ_STRESS 200
+#define NB_LOOP_TEST_RADIO_IRQ_OVERLAP 20
+
+#define RX_TIMEOUT_RADIO_IRQ_STRESS_IN_MS 5
+// One SF12 CAD symbol lasts 33 ms
+#define CAD_DURATION_RADIO_IRQ_OVERLAP_IN_MS 100
 
 #define FREQ_NO_RADIO 868300000
 #define SYNC_WORD_NO_RADIO 0x21
@@ -99,6 +107,9 @@ static volatile bool     irq_rx_timeout_raised = false;
 static volatile bool     timer_irq_raised      = false;
 static volatile uint32_t irq_time_ms           = 0;
 static volatile uint32_t irq_time_s            = 0;
+static volatile uint32_t irq_stress_count      = 0;
+static volatile uint32_t irq_stress_spurious   = 0;
+static volatile uint32_t irq_overlap_status    = 0;
 
 // LoRa configurations TO NOT receive or transmit
 static ralf_params_lora_t rx_lora_param = { .sync_word                       = SYNC_WORD_NO_RADIO,
@@ -138,6 +149,8 @@ static const char* name_context_type[] = { "MODEM", "LR1MAC", "DEVNONCE", "SECUR
 static void radio_tx_irq_callback( void* obj );
 static void radio_rx_irq_callback( void* obj );
 static void radio_irq_callback_get_time_in_s( void* obj );
+static void radio_irq_stress_callback( void* obj );
+static void radio_irq_overlap_callback( void* obj );
 static void timer_irq_callback( void* obj );
 
 static bool               reset_init_radio( void );
@@ -146,6 +159,8 @@ static return_code_test_t test_get_time_in_ms( void );
 
 static bool porting_test_spi( void );
 static bool porting_test_radio_irq( void );
+static bool porting_test_radio_irq_stress( void );
+static bool porting_test_radio_irq_overlap( void );
 static bool porting_test_get_time( void );
 static bool porting_test_timer_irq( void );
 static bool porting_test_stop_timer( void );
@@ -250,7 +265,7 @@ int main( void )
 #endif /* CONFIG_LORA_BASICS_MODEM_FUOTA */
 	};
 
-    modem_radio.ral.context = transceiver;
+    modem_radio.ral.context = lora_transceiver_get_ral_context( transceiver );
 
 	smtc_modem_hal_init(transceiver);
 	smtc_modem_hal_register_callbacks(&prv_hal_cb);
@@ -277,6 +292,14 @@ int main( void )
     if( ret == false )
         return 1;
 
+    ret = porting_test_radio_irq_stress( );
+    if( ret == false )
+        return 1;
+
+    ret = porting_test_radio_irq_overlap( );
+    if( ret == false )
+        return 1;
+
     ret = porting_test_get_time( );
 
     ret = porting_test_timer_irq( );
@@ -576,6 +599,202 @@ static bool porting_test_radio_irq( void )
     return true;
 }
 
+/**
+ * @brief Test radio irq fired back to back
+ *
+ * @remark
+ * Test processing:
+ * - Reset and init radio
+ * - Configure radio irq
+ * - Configure radio in reception mode with a short timeout
+ * - In the irq callback, clear the irq and restart the reception right away
+ * - Check that each rx timeout raised exactly one irq, none lost or duplicated
+ *
+ * Ported functions:
+ * smtc_modem_hal_irq_config_radio_irq
+ * lora_transceiver_board_enable_interrupt
+ *
+ * @return bool True if test is successful
+ */
+static bool porting_test_radio_irq_stress( void )
+{
+    SMTC_HAL_TRACE_MSG( "---------------------------------------- porting_test_radio_irq_stress : " );
+
+    // Generous bound, the reception is restarted from the event callback context
+    uint32_t timeout_ms = NB_LOOP_TEST_RADIO_IRQ_STRESS * ( RX_TIMEOUT_RADIO_IRQ_STRESS_IN_MS + 20 );
+
+    irq_stress_count    = 0;
+    irq_stress_spurious = 0;
+
+    if( reset_init_radio( ) == false )
+    {
+        PORTING_TEST_MSG_NOK( " Could not reset radio \n" );
+        return false;
+    }
+
+    smtc_modem_hal_irq_config_radio_irq( radio_irq_stress_callback, NULL );
+    smtc_modem_hal_start_radio_tcxo( );
+    smtc_modem_hal_set_ant_switch( false );
+    if( ralf_setup_lora( &modem_radio, &rx_lora_param ) != RAL_STATUS_OK )
+    {
+        PORTING_TEST_MSG_NOK( " ralf_setup_lora() function failed \n" );
+        return false;
+    }
+
+    if( ral_set_dio_irq_params( &( modem_radio.ral ), RAL_IRQ_RX_DONE | RAL_IRQ_RX_TIMEOUT | RAL_IRQ_RX_HDR_ERROR |
+                                                          RAL_IRQ_RX_CRC_ERROR ) != RAL_STATUS_OK )
+    {
+        PORTING_TEST_MSG_NOK( " ral_set_dio_irq_params() function failed \n" );
+        return false;
+    }
+
+    if( ral_set_rx( &( modem_radio.ral ), RX_TIMEOUT_RADIO_IRQ_STRESS_IN_MS ) != RAL_STATUS_OK )
+    {
+        PORTING_TEST_MSG_NOK( " ral_set_rx() function failed \n" );
+        return false;
+    }
+
+    uint32_t time = smtc_modem_hal_get_time_in_ms( );
+    while( ( irq_stress_count < NB_LOOP_TEST_RADIO_IRQ_STRESS ) &&
+           ( ( smtc_modem_hal_get_time_in_ms( ) - time ) < timeout_ms ) )
+    {
+        k_msleep( 10 );
+    }
+    // Leave time for a duplicated irq of the last reception
+    k_msleep( 100 );
+
+    if( irq_stress_count < NB_LOOP_TEST_RADIO_IRQ_STRESS )
+    {
+        PORTING_TEST_MSG_NOK( " Timeout, %u/%u radio irq received \n", irq_stress_count,
+                              NB_LOOP_TEST_RADIO_IRQ_STRESS );
+        return false;
+    }
+    if( irq_stress_spurious != 0 )
+    {
+        PORTING_TEST_MSG_NOK( " %u radio irq without rx timeout \n", irq_stress_spurious );
+        return false;
+    }
+
+    PORTING_TEST_MSG_OK( );
+    return true;
+}
+
+/**
+ * @brief Test radio irq raised while the irq line is still high
+ *
+ * @remark
+ * Test processing:
+ * - Reset and init radio
+ * - Configure radio irq
+ * - Configure radio in reception mode with a short timeout, keep its irq pending
+ * - Start a CAD, its irq is raised while the irq line is still high
+ * - Clear the rx timeout irq only, the line stays high for the CAD done irq
+ * - Check that the CAD done irq is received, no edge comes with it
+ *
+ * Ported functions:
+ * smtc_modem_hal_irq_config_radio_irq
+ * lora_transceiver_board_enable_interrupt
+ *
+ * @return bool True if test is successful
+ */
+static bool porting_test_radio_irq_overlap( void )
+{
+    SMTC_HAL_TRACE_MSG( "---------------------------------------- porting_test_radio_irq_overlap : " );
+
+    ral_lora_cad_params_t cad_params = { .cad_symb_nb          = RAL_LORA_CAD_01_SYMB,
+                                         .cad_det_peak_in_symb = 22,
+                                         .cad_det_min_in_symb  = 10,
+                                         .cad_exit_mode        = RAL_LORA_CAD_ONLY,
+                                         .cad_timeout_in_ms    = 0 };
+    uint32_t              time;
+
+    if( reset_init_radio( ) == false )
+    {
+        PORTING_TEST_MSG_NOK( " Could not reset radio \n" );
+        return false;
+    }
+
+    smtc_modem_hal_irq_config_radio_irq( radio_irq_overlap_callback, NULL );
+    smtc_modem_hal_start_radio_tcxo( );
+    smtc_modem_hal_set_ant_switch( false );
+    if( ralf_setup_lora( &modem_radio, &rx_lora_param ) != RAL_STATUS_OK )
+    {
+        PORTING_TEST_MSG_NOK( " ralf_setup_lora() function failed \n" );
+        return false;
+    }
+
+    if( ral_set_dio_irq_params( &( modem_radio.ral ), RAL_IRQ_RX_TIMEOUT | RAL_IRQ_CAD_DONE ) != RAL_STATUS_OK )
+    {
+        PORTING_TEST_MSG_NOK( " ral_set_dio_irq_params() function failed \n" );
+        return false;
+    }
+
+    if( ral_set_lora_cad_params( &( modem_radio.ral ), &cad_params ) != RAL_STATUS_OK )
+    {
+        PORTING_TEST_MSG_NOK( " ral_set_lora_cad_params() function failed \n" );
+        return false;
+    }
+
+    for( uint16_t i = 0; i < NB_LOOP_TEST_RADIO_IRQ_OVERLAP; i++ )
+    {
+        irq_overlap_status = 0;
+        if( ral_set_rx( &( modem_radio.ral ), RX_TIMEOUT_RADIO_IRQ_STRESS_IN_MS ) != RAL_STATUS_OK )
+        {
+            PORTING_TEST_MSG_NOK( " ral_set_rx() function failed \n" );
+            return false;
+        }
+
+        time = smtc_modem_hal_get_time_in_ms( );
+        while( ( ( irq_overlap_status & RAL_IRQ_RX_TIMEOUT ) == 0 ) &&
+               ( ( smtc_modem_hal_get_time_in_ms( ) - time ) < ( RX_TIMEOUT_RADIO_IRQ_STRESS_IN_MS + 20 ) ) )
+        {
+            k_msleep( 1 );
+        }
+        if( ( irq_overlap_status & RAL_IRQ_RX_TIMEOUT ) == 0 )
+        {
+            PORTING_TEST_MSG_NOK( " Timeout, rx timeout irq not received (loop %u) \n", i );
+            return false;
+        }
+
+        // The rx timeout irq is still pending, the CAD done irq does not raise the line again
+        if( ral_set_lora_cad( &( modem_radio.ral ) ) != RAL_STATUS_OK )
+        {
+            PORTING_TEST_MSG_NOK( " ral_set_lora_cad() function failed \n" );
+            return false;
+        }
+        k_msleep( CAD_DURATION_RADIO_IRQ_OVERLAP_IN_MS );
+
+        // Delayed clear of the first irq only, the line stays high
+        if( ral_clear_irq_status( &( modem_radio.ral ), RAL_IRQ_RX_TIMEOUT ) != RAL_STATUS_OK )
+        {
+            PORTING_TEST_MSG_NOK( " ral_clear_irq_status() function failed \n" );
+            return false;
+        }
+
+        time = smtc_modem_hal_get_time_in_ms( );
+        while( ( ( irq_overlap_status & RAL_IRQ_CAD_DONE ) == 0 ) &&
+               ( ( smtc_modem_hal_get_time_in_ms( ) - time ) < 100 ) )
+        {
+            k_msleep( 1 );
+        }
+        if( ( irq_overlap_status & RAL_IRQ_CAD_DONE ) == 0 )
+        {
+            PORTING_TEST_MSG_NOK( " CAD done irq raised while the irq line was high is lost (loop %u) \n", i );
+            return false;
+        }
+
+        if( ral_clear_irq_status( &( modem_radio.ral ), RAL_IRQ_ALL ) != RAL_STATUS_OK )
+        {
+            PORTING_TEST_MSG_NOK( " ral_clear_irq_status() function failed \n" );
+            return false;
+        }
+    }
+
+    smtc_modem_hal_stop_radio_tcxo( );
+    PORTING_TEST_MSG_OK( );
+    return true;
+}
+
 /**
  * @brief Test get time in s
  *
@@ -1606,6 +1825,59 @@ static void radio_irq_callback_get_time_in_s( void* obj )
     smtc_modem_hal_stop_radio_tcxo( );
 }
 
+/**
+ * @brief Radio irq callback of the stress test, restarting the reception right away
+ */
+static void radio_irq_stress_callback( void* obj )
+{
+    UNUSED( obj );
+    ral_irq_t radio_irq = 0;
+
+    if( ral_get_irq_status( &( modem_radio.ral ), &radio_irq ) != RAL_STATUS_OK )
+    {
+        PORTING_TEST_MSG_NOK( " ral_get_irq_status() function failed \n" );
+    }
+
+    if( ( radio_irq & RAL_IRQ_RX_TIMEOUT ) == RAL_IRQ_RX_TIMEOUT )
+    {
+        irq_stress_count++;
+    }
+    else
+    {
+        // Duplicated irq, the status was already cleared
+        irq_stress_spurious++;
+    }
+
+    if( ral_clear_irq_status( &( modem_radio.ral ), RAL_IRQ_ALL ) != RAL_STATUS_OK )
+    {
+        PORTING_TEST_MSG_NOK( " ral_clear_irq_status() function failed \n" );
+    }
+
+    if( irq_stress_count < NB_LOOP_TEST_RADIO_IRQ_STRESS )
+    {
+        ral_set_rx( &( modem_radio.ral ), RX_TIMEOUT_RADIO_IRQ_STRESS_IN_MS );
+    }
+    else
+    {
+        smtc_modem_hal_stop_radio_tcxo( );
+    }
+}
+
+/**
+ * @brief Radio irq callback of the overlap test, the irq status is only cleared by the test
+ */
+static void radio_irq_overlap_callback( void* obj )
+{
+    UNUSED( obj );
+    ral_irq_t radio_irq = 0;
+
+    if( ral_get_irq_status( &( modem_radio.ral ), &radio_irq ) != RAL_STATUS_OK )
+    {
+        PORTING_TEST_MSG_NOK( " ral_get_irq_status() function failed \n" );
+    }
+    irq_overlap_status |= radio_irq;
+}
+
 /**
  * @brief Timer irq callback
  */
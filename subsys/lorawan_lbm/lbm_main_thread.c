@@ -4,12 +4,16 @@
  * SPDX-License-Identifier: Apache-2.0
  */
 
+#include <string.h>
 #include <zephyr/kernel.h>
 #include <zephyr/logging/log.h>
+#include <zephyr/lorawan_lbm/lbm_main_thread.h>
 
 #include <smtc_modem_hal_init.h>
 #include <smtc_modem_utilities.h>
 #include <smtc_modem_api.h>
+#include <lora_lbm_tracing.h>
+#include <lora_lbm_transceiver.h>
 
 LOG_MODULE_DECLARE(smtc_modem, CONFIG_LORA_BASICS_MODEM_LOG_LEVEL);
 
@@ -18,6 +22,66 @@ static const struct device *transceiver = DEVICE_DT_GET(DT_CHOSEN(zephyr_lora_tr
 static struct k_thread lbm_main_thread_data;
 static K_THREAD_STACK_DEFINE(lbm_main_thread_stack, CONFIG_LORA_BASICS_MODEM_MAIN_THREAD_STACK_SIZE);
 
+struct lbm_main_thread_call {
+	void (*fn)(void *arg);
+	void *arg;
+	struct k_sem *done; /* NULL when the caller does not wait */
+};
+
+K_MSGQ_DEFINE(lbm_main_thread_calls, sizeof(struct lbm_main_thread_call),
+	      CONFIG_LORA_BASICS_MODEM_MAIN_THREAD_CALL_QUEUE_SIZE, 4);
+
+static struct lora_basics_modem_thread_stats thread_stats;
+static struct k_spinlock thread_stats_lock;
+
+static void lbm_main_thread_run_calls(void)
+{
+	struct lbm_main_thread_call call;
+
+	while (k_msgq_get(&lbm_main_thread_calls, &call, K_NO_WAIT) == 0) {
+		call.fn(call.arg);
+		if (call.done) {
+			k_sem_give(call.done);
+		}
+	}
+}
+
+static void lbm_main_thread_account_run(uint32_t engine_us)
+{
+	k_spinlock_key_t key = k_spin_lock(&thread_stats_lock);
+
+	thread_stats.engine_runs++;
+	thread_stats.engine_time_us += engine_us;
+	thread_stats.engine_time_max_us = MAX(thread_stats.engine_time_max_us, engine_us);
+
+	k_spin_unlock(&thread_stats_lock, key);
+}
+
+static void lbm_main_thread_account_sleep(uint32_t requested_ms, uint32_t slept_ms, uint32_t reasons)
+{
+	k_spinlock_key_t key = k_spin_lock(&thread_stats_lock);
+
+	thread_stats.sleep_requested_ms += requested_ms;
+	thread_stats.sleep_ms += slept_ms;
+	if (reasons == 0) {
+		thread_stats.wake_timeout++;
+	}
+	if (reasons & SMTC_MODEM_HAL_WAKE_RADIO_IRQ) {
+		thread_stats.wake_radio_irq++;
+	}
+	if (reasons & SMTC_MODEM_HAL_WAKE_TIMER) {
+		thread_stats.wake_timer++;
+	}
+	if (reasons & SMTC_MODEM_HAL_WAKE_LBM) {
+		thread_stats.wake_lbm++;
+	}
+	if (reasons & SMTC_MODEM_HAL_WAKE_USER) {
+		thread_stats.wake_user++;
+	}
+
+	k_spin_unlock(&thread_stats_lock, key);
+}
+
 static void lora_basics_modem_main_thread(void *p1, void *p2, void *p3)
 {
 	uint32_t sleep_time_ms = 0;
@@ -26,14 +90,25 @@ static void lora_basics_modem_main_thread(void *p1, void *p2, void *p3)
 	ARG_UNUSED(p3);
 
 	smtc_modem_hal_register_callbacks(hal_cb);
-	smtc_modem_set_radio_context(transceiver);
+	smtc_modem_set_radio_context(lora_transceiver_get_ral_context(transceiver));
 	smtc_modem_hal_init(transceiver);
 	smtc_modem_init(event_callback);
 
 	LOG_INF("Starting loop...");
 
 	while (true) {
+		lbm_main_thread_run_calls();
+
+		/* Run time of the engine, the run following an uplink request prepares the TX */
+		uint32_t engine_start = k_cycle_get_32();
+
+		LORA_LBM_TRACE_BEGIN(engine, 0);
 		sleep_time_ms = smtc_modem_run_engine();
+		LORA_LBM_TRACE_END(engine, sleep_time_ms);
+
+		uint32_t engine_us = k_cyc_to_us_floor32(k_cycle_get_32() - engine_start);
+
+		lbm_main_thread_account_run(engine_us);
 
 		if (smtc_modem_is_irq_flag_pending()) {
 			continue;
@@ -42,8 +117,13 @@ static void lora_basics_modem_main_thread(void *p1, void *p2, void *p3)
 #if CONFIG_LORA_BASICS_MODEM_MAIN_THREAD_MAX_SLEEP_MS
 		sleep_time_ms = MIN(sleep_time_ms, CONFIG_LORA_BASICS_MODEM_MAIN_THREAD_MAX_SLEEP_MS);
 #endif
-		LOG_INF("Sleeping for %dms", sleep_time_ms);
-		smtc_modem_hal_interruptible_msleep(K_MSEC(sleep_time_ms));
+		LOG_INF("Engine ran for %uus, sleeping for %dms", engine_us, sleep_time_ms);
+		LORA_LBM_TRACE_BEGIN(sleep, sleep_time_ms);
+		int64_t sleep_start = k_uptime_get();
+		uint32_t reasons = smtc_modem_hal_wait_for_wake_up(K_MSEC(sleep_time_ms));
+
+		lbm_main_thread_account_sleep(sleep_time_ms, k_uptime_get() - sleep_start, reasons);
+		LORA_LBM_TRACE_END(sleep, reasons);
 	}
 }
 
@@ -55,3 +135,50 @@ void lora_basics_modem_start_work_thread(void (*event_callback)(void), struct sm
 		lora_basics_modem_main_thread, event_callback, hal_cb, NULL,
 		CONFIG_LORA_BASICS_MODEM_MAIN_THREAD_PRIORITY, 0, K_NO_WAIT);
 }
+
+int lora_basics_modem_run_in_thread(void (*fn)(void *arg), void *arg, bool wait)
+{
+	struct k_sem done;
+	struct lbm_main_thread_call call = {
+		.fn = fn,
+		.arg = arg,
+		.done = wait ? &done : NULL,
+	};
+
+	/* In an ISR, k_current_get() is the interrupted thread, possibly mid-engine */
+	if (!k_is_in_isr() && k_current_get() == &lbm_main_thread_data) {
+		fn(arg);
+		return 0;
+	}
+
+	if (wait) {
+		k_sem_init(&done, 0, 1);
+	}
+	if (k_msgq_put(&lbm_main_thread_calls, &call, K_NO_WAIT) != 0) {
+		return -ENOMSG;
+	}
+	smtc_modem_hal_wake_up();
+	if (wait) {
+		/* The call is run at the latest after the ongoing engine run */
+		k_sem_take(&done, K_FOREVER);
+	}
+	return 0;
+}
+
+void lora_basics_modem_get_thread_stats(struct lora_basics_modem_thread_stats *stats)
+{
+	k_spinlock_key_t key = k_spin_lock(&thread_stats_lock);
+
+	*stats = thread_stats;
+
+	k_spin_unlock(&thread_stats_lock, key);
+}
+
+void lora_basics_modem_reset_thread_stats(void)
+{
+	k_spinlock_key_t key = k_spin_lock(&thread_stats_lock);
+
+	memset(&thread_stats, 0, sizeof(thread_stats));
+
+	k_spin_unlock(&thread_stats_lock, key);
+}
@@ -0,0 +1,611 @@
+/*
+ * Copyright (c) 2024 Semtech Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <zephyr/kernel.h>
+#include <zephyr/shell/shell.h>
+#include <zephyr/sys/byteorder.h>
+#include <zephyr/sys/util.h>
+#include <zephyr/lorawan_lbm/lbm_main_thread.h>
+
+#include <smtc_modem_api.h>
+#include <smtc_modem_hal.h>
+#include <smtc_modem_hal_init.h>
+#include <modem_core.h>
+#include <radio_planner.h>
+
+#if defined(CONFIG_SEMTECH_LR11XX)
+#include <lr11xx_system.h>
+#elif defined(CONFIG_SEMTECH_SX126X)
+#include <sx126x.h>
+#endif
+
+/*
+ * The LBM API is not thread-safe: the commands calling it run in the LBM main thread, and
+ * copy the results back to the shell thread, which prints them. The shell thread holds the
+ * shell output lock while a command runs, so the LBM main thread must not print.
+ */
+
+#define LBM_SHELL_STACK_ID 0
+
+/* Bytes of the modem context written by each store of the benchmark */
+#define LBM_SHELL_BENCH_CTX_SIZE 32
+
+static const struct device *transceiver = DEVICE_DT_GET(DT_CHOSEN(zephyr_lora_transceiver));
+
+/* Arguments and results of a call run in the LBM main thread */
+struct lbm_shell_call {
+	bool set;
+	uint32_t value;
+	int32_t result;
+	smtc_modem_return_code_t rc;
+};
+
+/* Timings of a benchmark */
+struct lbm_shell_bench {
+	uint32_t count;
+	uint32_t errors;
+	int32_t min_us;
+	int32_t max_us;
+	int64_t total_us;
+};
+
+static void lbm_shell_bench_init(struct lbm_shell_bench *bench)
+{
+	memset(bench, 0, sizeof(*bench));
+	bench->min_us = INT32_MAX;
+	bench->max_us = INT32_MIN;
+}
+
+static void lbm_shell_bench_add(struct lbm_shell_bench *bench, int32_t us)
+{
+	bench->count++;
+	bench->total_us += us;
+	bench->min_us = MIN(bench->min_us, us);
+	bench->max_us = MAX(bench->max_us, us);
+}
+
+static void lbm_shell_bench_print(const struct shell *sh, const char *name,
+				  const struct lbm_shell_bench *bench)
+{
+	if (bench->count == 0) {
+		shell_error(sh, "%s: no sample, %u errors", name, bench->errors);
+		return;
+	}
+	shell_print(sh, "%s: %u samples, min %d us, avg %d us, max %d us, %u errors", name,
+		    bench->count, bench->min_us, (int32_t)(bench->total_us / bench->count),
+		    bench->max_us, bench->errors);
+}
+
+static int lbm_shell_parse(const struct shell *sh, const char *arg, uint32_t min, uint32_t max,
+			   uint32_t *value)
+{
+	char *end;
+	unsigned long parsed = strtoul(arg, &end, 0);
+
+	if ((*end != '\0') || (parsed < min) || (parsed > max)) {
+		shell_error(sh, "Invalid value %s, expected %u to %u", arg, min, max);
+		return -EINVAL;
+	}
+	*value = parsed;
+	return 0;
+}
+
+static int lbm_shell_parse_state(const struct shell *sh, const char *arg, uint32_t *value)
+{
+	if (strcmp(arg, "on") == 0) {
+		*value = 1;
+	} else if (strcmp(arg, "off") == 0) {
+		*value = 0;
+	} else {
+		shell_error(sh, "Invalid state %s, expected on or off", arg);
+		return -EINVAL;
+	}
+	return 0;
+}
+
+static int lbm_shell_check_rc(const struct shell *sh, smtc_modem_return_code_t rc)
+{
+	if (rc != SMTC_MODEM_RC_OK) {
+		shell_error(sh, "Modem returned %d", rc);
+		return -EIO;
+	}
+	return 0;
+}
+
+static int lbm_shell_run(const struct shell *sh, void (*fn)(void *arg), void *arg)
+{
+	int ret = lora_basics_modem_run_in_thread(fn, arg, true);
+
+	if (ret != 0) {
+		shell_error(sh, "Modem thread busy (%d)", ret);
+	}
+	return ret;
+}
+
+/* ------------ Uplinks ------------ */
+
+static struct {
+	uint8_t port;
+	uint8_t size;
+	atomic_t remaining; /* Uplinks left to request, negative for no limit */
+	uint32_t requested;
+	atomic_t rejected;  /* Also counted by the timer, when the modem thread is busy */
+	smtc_modem_return_code_t last_rc;
+} uplink;
+
+static uint8_t uplink_payload[SMTC_MODEM_MAX_LORAWAN_PAYLOAD_LENGTH];
+
+static void lbm_shell_uplink_send(void *arg)
+{
+	ARG_UNUSED(arg);
+
+	/* Number the uplinks to spot the lost ones on the network server */
+	sys_put_be32(uplink.requested + atomic_get(&uplink.rejected), uplink_payload);
+	uplink.last_rc = smtc_modem_request_uplink(LBM_SHELL_STACK_ID, uplink.port, false,
+						   uplink_payload, uplink.size);
+	if (uplink.last_rc == SMTC_MODEM_RC_OK) {
+		uplink.requested++;
+	} else {
+		atomic_inc(&uplink.rejected);
+	}
+}
+
+static void lbm_shell_uplink_expiry(struct k_timer *timer)
+{
+	if (atomic_get(&uplink.remaining) == 0) {
+		k_timer_stop(timer);
+		return;
+	}
+	if (atomic_get(&uplink.remaining) > 0) {
+		atomic_dec(&uplink.remaining);
+	}
+	if (lora_basics_modem_run_in_thread(lbm_shell_uplink_send, NULL, false) != 0) {
+		atomic_inc(&uplink.rejected);
+	}
+}
+
+static K_TIMER_DEFINE(lbm_shell_uplink_timer, lbm_shell_uplink_expiry, NULL);
+
+static int cmd_lbm_uplink(const struct shell *sh, size_t argc, char **argv)
+{
+	uint32_t port, size, period_s = 0, count;
+
+	if (argc == 1) {
+		shell_print(sh, "Requested %u, rejected %ld, last return code %d, %ld left",
+			    uplink.requested, (long)atomic_get(&uplink.rejected), uplink.last_rc,
+			    (long)atomic_get(&uplink.remaining));
+		return 0;
+	}
+	if (strcmp(argv[1], "stop") == 0) {
+		k_timer_stop(&lbm_shell_uplink_timer);
+		atomic_set(&uplink.remaining, 0);
+		return 0;
+	}
+	if (argc < 3) {
+		shell_error(sh, "Missing payload size");
+		return -EINVAL;
+	}
+	if (lbm_shell_parse(sh, argv[1], 1, 223, &port) ||
+	    lbm_shell_parse(sh, argv[2], 4, SMTC_MODEM_MAX_LORAWAN_PAYLOAD_LENGTH, &size) ||
+	    ((argc > 3) && lbm_shell_parse(sh, argv[3], 1, UINT16_MAX, &period_s))) {
+		return -EINVAL;
+	}
+	/* Without count, periodic uplinks go on until stopped */
+	count = (period_s == 0) ? 1 : 0;
+	if ((argc > 4) && lbm_shell_parse(sh, argv[4], 1, INT32_MAX, &count)) {
+		return -EINVAL;
+	}
+
+	k_timer_stop(&lbm_shell_uplink_timer);
+	uplink.port = port;
+	uplink.size = size;
+	uplink.requested = 0;
+	atomic_set(&uplink.rejected, 0);
+	atomic_set(&uplink.remaining, (count == 0) ? -1 : (atomic_val_t)count);
+	k_timer_start(&lbm_shell_uplink_timer, K_NO_WAIT,
+		      (period_s == 0) ? K_NO_WAIT : K_SECONDS(period_s));
+	return 0;
+}
+
+/* ------------ Engine ------------ */
+
+static int cmd_lbm_engine(const struct shell *sh, size_t argc, char **argv)
+{
+	struct lora_basics_modem_thread_stats stats;
+
+	if (argc > 1) {
+		if (strcmp(argv[1], "reset") != 0) {
+			shell_error(sh, "Unknown argument %s", argv[1]);
+			return -EINVAL;
+		}
+		lora_basics_modem_reset_thread_stats();
+		return 0;
+	}
+
+	lora_basics_modem_get_thread_stats(&stats);
+	shell_print(sh, "Engine runs       %u", stats.engine_runs);
+	shell_print(sh, "Engine time       %llu us (avg %llu us, max %u us)",
+		    (unsigned long long)stats.engine_time_us,
+		    (unsigned long long)(stats.engine_runs ? stats.engine_time_us / stats.engine_runs : 0),
+		    stats.engine_time_max_us);
+	shell_print(sh, "Sleep             %llu ms of %llu ms requested",
+		    (unsigned long long)stats.sleep_ms, (unsigned long long)stats.sleep_requested_ms);
+	shell_print(sh, "Wake-ups          timeout %u, radio irq %u, timer %u, stack %u, user %u",
+		    stats.wake_timeout, stats.wake_radio_irq, stats.wake_timer, stats.wake_lbm,
+		    stats.wake_user);
+	return 0;
+}
+
+#ifdef CONFIG_LORA_BASICS_MODEM_TIMER_LATENCY
+
+/* ------------ Timer latency ------------ */
+
+static int cmd_lbm_timer(const struct shell *sh, size_t argc, char **argv)
+{
+	struct smtc_modem_hal_timer_latency latency;
+
+	if (argc > 1) {
+		if (strcmp(argv[1], "reset") != 0) {
+			shell_error(sh, "Unknown argument %s", argv[1]);
+			return -EINVAL;
+		}
+		smtc_modem_hal_reset_timer_latency();
+		return 0;
+	}
+
+	smtc_modem_hal_get_timer_latency(&latency);
+	shell_print(sh, "Callbacks         %u", latency.count);
+	shell_print(sh, "Latency           avg %llu us, max %u us",
+		    (unsigned long long)(latency.count ? latency.total_us / latency.count : 0),
+		    latency.max_us);
+	for (int i = 0; i < SMTC_MODEM_HAL_TIMER_LATENCY_BINS; i++) {
+		if (latency.bins[i] == 0) {
+			continue;
+		}
+		if (i == SMTC_MODEM_HAL_TIMER_LATENCY_BINS - 1) {
+			shell_print(sh, "  >= %6u us    %u", (uint32_t)BIT(i), latency.bins[i]);
+		} else {
+			shell_print(sh, "  <  %6u us    %u", (uint32_t)BIT(i + 1), latency.bins[i]);
+		}
+	}
+	return 0;
+}
+
+#endif /* CONFIG_LORA_BASICS_MODEM_TIMER_LATENCY */
+
+/* ------------ Radio planner ------------ */
+
+static rp_task_t rp_tasks[RP_NB_HOOKS];
+
+static void lbm_shell_rp_copy(void *arg)
+{
+	ARG_UNUSED(arg);
+
+	memcpy(rp_tasks, modem_get_rp()->tasks, sizeof(rp_tasks));
+}
+
+static int cmd_lbm_rp(const struct shell *sh, size_t argc, char **argv)
+{
+	uint32_t now = smtc_modem_hal_get_time_in_ms();
+
+	int ret = lbm_shell_run(sh, lbm_shell_rp_copy, NULL);
+	if (ret != 0) {
+		return ret;
+	}
+
+	/* Raw rp_task_types_t and rp_task_states_t values */
+	shell_print(sh, "Time %u ms", now);
+	shell_print(sh, "Hook Type State Start (ms) Duration (ms)");
+	for (int i = 0; i < RP_NB_HOOKS; i++) {
+		shell_print(sh, "%4d %4d %5d %10u %13u", i, rp_tasks[i].type, rp_tasks[i].state,
+			    rp_tasks[i].start_time_ms, rp_tasks[i].duration_time_ms);
+	}
+	return 0;
+}
+
+/* ------------ Settings ------------ */
+
+static void lbm_shell_adr(void *arg)
+{
+	struct lbm_shell_call *call = arg;
+
+	call->rc = smtc_modem_adr_set_profile(LBM_SHELL_STACK_ID, call->value, NULL);
+}
+
+static int cmd_lbm_adr(const struct shell *sh, size_t argc, char **argv)
+{
+	static const char *const profiles[] = {
+		[SMTC_MODEM_ADR_PROFILE_NETWORK_CONTROLLED] = "network",
+		[SMTC_MODEM_ADR_PROFILE_MOBILE_LONG_RANGE] = "long_range",
+		[SMTC_MODEM_ADR_PROFILE_MOBILE_LOW_POWER] = "low_power",
+	};
+	struct lbm_shell_call call = { 0 };
+
+	for (call.value = 0; call.value < ARRAY_SIZE(profiles); call.value++) {
+		if (strcmp(argv[1], profiles[call.value]) == 0) {
+			break;
+		}
+	}
+	if (call.value == ARRAY_SIZE(profiles)) {
+		shell_error(sh, "Unknown profile %s, expected network, long_range or low_power",
+			    argv[1]);
+		return -EINVAL;
+	}
+
+	int ret = lbm_shell_run(sh, lbm_shell_adr, &call);
+	if (ret != 0) {
+		return ret;
+	}
+	return lbm_shell_check_rc(sh, call.rc);
+}
+
+static void lbm_shell_nb_trans(void *arg)
+{
+	struct lbm_shell_call *call = arg;
+	uint8_t nb_trans = call->value;
+
+	if (call->set) {
+		call->rc = smtc_modem_set_nb_trans(LBM_SHELL_STACK_ID, nb_trans);
+	} else {
+		call->rc = smtc_modem_get_nb_trans(LBM_SHELL_STACK_ID, &nb_trans);
+		call->result = nb_trans;
+	}
+}
+
+static int cmd_lbm_nb_trans(const struct shell *sh, size_t argc, char **argv)
+{
+	struct lbm_shell_call call = { .set = (argc > 1) };
+
+	if (call.set && lbm_shell_parse(sh, argv[1], 1, 15, &call.value)) {
+		return -EINVAL;
+	}
+
+	int ret = lbm_shell_run(sh, lbm_shell_nb_trans, &call);
+	if (ret != 0) {
+		return ret;
+	}
+	if (!call.set && (call.rc == SMTC_MODEM_RC_OK)) {
+		shell_print(sh, "NbTrans %d", call.result);
+	}
+	return lbm_shell_check_rc(sh, call.rc);
+}
+
+#ifdef CONFIG_LORA_BASICS_MODEM_CSMA
+
+static void lbm_shell_csma(void *arg)
+{
+	struct lbm_shell_call *call = arg;
+	bool enabled = call->value;
+
+	if (call->set) {
+		call->rc = smtc_modem_csma_set_state(LBM_SHELL_STACK_ID, enabled);
+	} else {
+		call->rc = smtc_modem_csma_get_state(LBM_SHELL_STACK_ID, &enabled);
+		call->result = enabled;
+	}
+}
+
+static int cmd_lbm_csma(const struct shell *sh, size_t argc, char **argv)
+{
+	struct lbm_shell_call call = { .set = (argc > 1) };
+
+	if (call.set && lbm_shell_parse_state(sh, argv[1], &call.value)) {
+		return -EINVAL;
+	}
+
+	int ret = lbm_shell_run(sh, lbm_shell_csma, &call);
+	if (ret != 0) {
+		return ret;
+	}
+	if (!call.set && (call.rc == SMTC_MODEM_RC_OK)) {
+		shell_print(sh, "CSMA %s", call.result ? "on" : "off");
+	}
+	return lbm_shell_check_rc(sh, call.rc);
+}
+
+#endif /* CONFIG_LORA_BASICS_MODEM_CSMA */
+
+static void lbm_shell_duty_cycle(void *arg)
+{
+	struct lbm_shell_call *call = arg;
+
+	if (call->set) {
+		call->rc = smtc_modem_debug_set_duty_cycle_state(call->value);
+	} else {
+		call->rc = smtc_modem_get_duty_cycle_status(LBM_SHELL_STACK_ID, &call->result);
+	}
+}
+
+static int cmd_lbm_duty_cycle(const struct shell *sh, size_t argc, char **argv)
+{
+	struct lbm_shell_call call = { .set = (argc > 1) };
+
+	if (call.set && lbm_shell_parse_state(sh, argv[1], &call.value)) {
+		return -EINVAL;
+	}
+
+	int ret = lbm_shell_run(sh, lbm_shell_duty_cycle, &call);
+	if (ret != 0) {
+		return ret;
+	}
+	if (!call.set && (call.rc == SMTC_MODEM_RC_OK)) {
+		/* Positive: time left to transmit, negative: time to wait for the next uplink */
+		shell_print(sh, "Duty cycle status %d ms", call.result);
+	}
+	return lbm_shell_check_rc(sh, call.rc);
+}
+
+/* ------------ Benchmarks ------------ */
+
+static struct lbm_shell_bench bench;
+
+static void lbm_shell_bench_spi(void *arg)
+{
+	uint32_t count = *(uint32_t *)arg;
+
+	for (uint32_t i = 0; i < count; i++) {
+		uint32_t start = k_cycle_get_32();
+		bool ok;
+
+		/* Shortest command with a response */
+#if defined(CONFIG_SEMTECH_LR11XX)
+		lr11xx_system_version_t version;
+
+		ok = (lr11xx_system_get_version(transceiver, &version) == LR11XX_STATUS_OK);
+#elif defined(CONFIG_SEMTECH_SX126X)
+		sx126x_chip_status_t status;
+
+		ok = (sx126x_get_status(transceiver, &status) == SX126X_STATUS_OK);
+#else
+		ok = false;
+#endif
+		if (ok) {
+			lbm_shell_bench_add(&bench, k_cyc_to_us_floor32(k_cycle_get_32() - start));
+		} else {
+			bench.errors++;
+		}
+	}
+}
+
+static int cmd_lbm_bench_spi(const struct shell *sh, size_t argc, char **argv)
+{
+	uint32_t count = 100;
+
+	if ((argc > 1) && lbm_shell_parse(sh, argv[1], 1, 10000, &count)) {
+		return -EINVAL;
+	}
+
+	lbm_shell_bench_init(&bench);
+	int ret = lbm_shell_run(sh, lbm_shell_bench_spi, &count);
+	if (ret != 0) {
+		return ret;
+	}
+	lbm_shell_bench_print(sh, "SPI round trip", &bench);
+	return 0;
+}
+
+static void lbm_shell_bench_ctx(void *arg)
+{
+	uint32_t count = *(uint32_t *)arg;
+	uint8_t context[2][LBM_SHELL_BENCH_CTX_SIZE];
+
+	/*
+	 * Unchanged contexts are not written again: alternate the current content with a
+	 * modified copy, then leave the current content in place.
+	 */
+	smtc_modem_hal_context_restore(CONTEXT_MODEM, 0, context[0], sizeof(context[0]));
+	memcpy(context[1], context[0], sizeof(context[1]));
+	context[1][0] ^= 0xFF;
+	for (uint32_t i = 0; i < count; i++) {
+		uint32_t start = k_cycle_get_32();
+
+		smtc_modem_hal_context_store(CONTEXT_MODEM, 0, context[(i + 1) % 2],
+					     sizeof(context[0]));
+		lbm_shell_bench_add(&bench, k_cyc_to_us_floor32(k_cycle_get_32() - start));
+	}
+	if ((count % 2) != 0) {
+		smtc_modem_hal_context_store(CONTEXT_MODEM, 0, context[0], sizeof(context[0]));
+	}
+}
+
+static int cmd_lbm_bench_ctx(const struct shell *sh, size_t argc, char **argv)
+{
+	uint32_t count = 10;
+
+	/* Each store erases the context page */
+	if ((argc > 1) && lbm_shell_parse(sh, argv[1], 1, 100, &count)) {
+		return -EINVAL;
+	}
+
+	lbm_shell_bench_init(&bench);
+	int ret = lbm_shell_run(sh, lbm_shell_bench_ctx, &count);
+	if (ret != 0) {
+		return ret;
+	}
+	lbm_shell_bench_print(sh, "Context store", &bench);
+	return 0;
+}
+
+static struct {
+	uint32_t start;
+	uint32_t period_us;
+	uint32_t expiries;
+	uint32_t count;
+} bench_timer;
+
+static K_SEM_DEFINE(lbm_shell_bench_timer_done, 0, 1);
+
+static void lbm_shell_bench_timer_expiry(struct k_timer *timer)
+{
+	int32_t elapsed_us = k_cyc_to_us_floor32(k_cycle_get_32() - bench_timer.start);
+
+	bench_timer.expiries++;
+	/* Drift from the ideal expiry time, the modem timers run from the same ISR */
+	lbm_shell_bench_add(&bench, elapsed_us - (int32_t)(bench_timer.expiries * bench_timer.period_us));
+	if (bench_timer.expiries == bench_timer.count) {
+		k_timer_stop(timer);
+		k_sem_give(&lbm_shell_bench_timer_done);
+	}
+}
+
+static K_TIMER_DEFINE(lbm_shell_bench_timer, lbm_shell_bench_timer_expiry, NULL);
+
+static int cmd_lbm_bench_timer(const struct shell *sh, size_t argc, char **argv)
+{
+	uint32_t period_ms = 100, count = 10;
+
+	if (((argc > 1) && lbm_shell_parse(sh, argv[1], 1, 10000, &period_ms)) ||
+	    ((argc > 2) && lbm_shell_parse(sh, argv[2], 1, 1000, &count))) {
+		return -EINVAL;
+	}
+
+	lbm_shell_bench_init(&bench);
+	bench_timer.period_us = period_ms * USEC_PER_MSEC;
+	bench_timer.expiries = 0;
+	bench_timer.count = count;
+	k_sem_reset(&lbm_shell_bench_timer_done);
+	bench_timer.start = k_cycle_get_32();
+	k_timer_start(&lbm_shell_bench_timer, K_MSEC(period_ms), K_MSEC(period_ms));
+
+	if (k_sem_take(&lbm_shell_bench_timer_done, K_MSEC(2 * period_ms * count)) != 0) {
+		k_timer_stop(&lbm_shell_bench_timer);
+		shell_error(sh, "Timer expired %u times out of %u", bench_timer.expiries, count);
+	}
+	lbm_shell_bench_print(sh, "Timer drift", &bench);
+	return 0;
+}
+
+SHELL_STATIC_SUBCMD_SET_CREATE(sub_lbm_bench,
+	SHELL_CMD_ARG(spi, NULL, "SPI round trip with the transceiver [count]",
+		      cmd_lbm_bench_spi, 1, 1),
+	SHELL_CMD_ARG(ctx, NULL, "Modem context store [count]", cmd_lbm_bench_ctx, 1, 1),
+	SHELL_CMD_ARG(timer, NULL, "Timer accuracy [period_ms] [count]", cmd_lbm_bench_timer, 1, 2),
+	SHELL_SUBCMD_SET_END
+);
+
+SHELL_SUBCMD_ADD((lbm), uplink, NULL,
+		 "Request uplinks <port> <size> [period_s] [count], \"lbm uplink stop\" stops them",
+		 cmd_lbm_uplink, 1, 4);
+SHELL_SUBCMD_ADD((lbm), engine, NULL, "Engine run and sleep statistics, \"lbm engine reset\" clears them",
+		 cmd_lbm_engine, 1, 1);
+#ifdef CONFIG_LORA_BASICS_MODEM_TIMER_LATENCY
+SHELL_SUBCMD_ADD((lbm), timer, NULL,
+		 "Timer callback latency histogram, \"lbm timer reset\" clears it",
+		 cmd_lbm_timer, 1, 1);
+#endif /* CONFIG_LORA_BASICS_MODEM_TIMER_LATENCY */
+SHELL_SUBCMD_ADD((lbm), rp, NULL, "Radio planner tasks", cmd_lbm_rp, 1, 0);
+SHELL_SUBCMD_ADD((lbm), adr, NULL, "Set the ADR profile <network|long_range|low_power>",
+		 cmd_lbm_adr, 2, 0);
+SHELL_SUBCMD_ADD((lbm), nbtrans, NULL, "Get or set the number of transmissions [1-15]",
+		 cmd_lbm_nb_trans, 1, 1);
+#ifdef CONFIG_LORA_BASICS_MODEM_CSMA
+SHELL_SUBCMD_ADD((lbm), csma, NULL, "Get or set the CSMA state [on|off]", cmd_lbm_csma, 1, 1);
+#endif /* CONFIG_LORA_BASICS_MODEM_CSMA */
+SHELL_SUBCMD_ADD((lbm), dutycycle, NULL, "Get the duty cycle status or set its state [on|off]",
+		 cmd_lbm_duty_cycle, 1, 1);
+SHELL_SUBCMD_ADD((lbm), bench, &sub_lbm_bench, "Benchmarks", NULL, 0, 0);